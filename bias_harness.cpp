@@ -0,0 +1,94 @@
+/**
+ * @file bias_harness.cpp
+ * Measures how far each layout sampler deviates from the uniform distribution over valid layouts.
+ * Usage: bias_harness [layouts] [threads] [vessel codes...]
+ * Vessel codes are the short names printed by Vessel::formatVessel(), eg. CA SM FR.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "layoutstats.h"
+
+#define BIAS_DEFAULT_LAYOUTS 1000000
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ Convert a short vessel code to its type.
+ @return
+    True if the code names a vessel type.
+*/
+static bool parseVessel(const std::string& code, Cylink::Vessel::VType& vtype)
+{
+    for(int type = 0; type < LS_VESSEL_TYPES; type++)
+    {
+        vtype = static_cast<Cylink::Vessel::VType>(type);
+        if(Cylink::Vessel::formatVessel(vtype, false) == code)
+            return true;
+    }
+    return false;
+}
+
+int main(int argc, char* argv[])
+{
+    long long layouts = (argc > 1) ? std::atoll(argv[1]) : BIAS_DEFAULT_LAYOUTS;
+    int threads = (argc > 2) ? std::atoi(argv[2]) : static_cast<int>(std::thread::hardware_concurrency());
+    if(layouts <= 0)
+        layouts = BIAS_DEFAULT_LAYOUTS;
+    if(threads <= 0)
+        threads = 1;
+
+    std::vector<Cylink::Vessel::VType> fleet;
+    for(int arg = 3; arg < argc; arg++)
+    {
+        Cylink::Vessel::VType vtype;
+        if(!parseVessel(argv[arg], vtype))
+        {
+            std::cerr<<"Unknown vessel code "<<argv[arg]<<"\n";
+            return 1;
+        }
+        fleet.push_back(vtype);
+    }
+    if(fleet.empty())
+        fleet = {Cylink::Vessel::VType::CARRIER, Cylink::Vessel::VType::SUBMARINE, Cylink::Vessel::VType::FRIGATE};
+
+    /* Exact distribution */
+    Cylink::OccupancyCounts expected(GB_BOARD_SIZE, GB_BOARD_SIZE);
+    auto start = Clock::now();
+    bool complete = Cylink::exactOccupancy(fleet, threads, expected);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    if(!complete)
+    {
+        std::cerr<<"Fleet has too many layouts to enumerate exactly\n";
+        return 1;
+    }
+    std::cout<<"Exact: "<<expected.layouts<<" labelled layouts enumerated in "<<elapsed.count()<<"s\n";
+
+    const std::pair<Cylink::LayoutSampler, const char*> samplers[] = {
+        {Cylink::LayoutSampler::SAMPLER_ADDVESSEL, "GameBoard::addVessel"},
+        {Cylink::LayoutSampler::SAMPLER_SEQUENTIAL, "PlacementGenerator sequential"},
+        {Cylink::LayoutSampler::SAMPLER_EXACT, "PlacementGenerator exact"},
+        {Cylink::LayoutSampler::SAMPLER_UNIFORM, "PlacementGenerator uniform"}
+    };
+
+    for(auto& sampler : samplers)
+    {
+        /* The addVessel based sampler is far slower, so it gets a smaller sample */
+        long long count = (sampler.first == Cylink::LayoutSampler::SAMPLER_ADDVESSEL) ? layouts / 10 : layouts;
+        Cylink::OccupancyCounts observed(GB_BOARD_SIZE, GB_BOARD_SIZE);
+
+        start = Clock::now();
+        if(!Cylink::sampleOccupancy(fleet, sampler.first, count, threads, 1, observed))
+        {
+            std::cerr<<sampler.second<<": fleet does not fit\n";
+            return 1;
+        }
+        elapsed = Clock::now() - start;
+
+        std::cout<<sampler.second<<": "<<observed.layouts<<" layouts, "
+            <<static_cast<long long>(observed.layouts / elapsed.count())<<" layouts/second\n";
+        std::cout<<Cylink::compareOccupancy(observed, expected);
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <algorithm>
+
+#include "bitboard.h"
+#include "error.h"
+
+#define BB_ARG_ERROR ErrorCode::ERR_INVALID_ARG
+#define BB_WORD_BITS 64
+
+namespace Cylink
+{
+    /**
+     Create an empty bit grid of the given dimensions with every bit cleared.
+     Negative dimensions will result in an exception.
+     @param rows
+        The number of rows (x coordinates) in the grid.
+     @param cols
+        The number of columns (y coordinates) in the grid.
+    */
+    BitBoard::BitBoard(int rows, int cols)
+        : rows_(rows), cols_(cols), wordsPerRow_(0), words_()
+    {
+        if(rows_ < 0 || cols_ < 0)
+        {
+            Error argError("BitBoard dimensions may not be negative.", BB_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+
+        wordsPerRow_ = (cols_ + BB_WORD_BITS - 1) / BB_WORD_BITS;
+        words_.assign(static_cast<size_t>(rows_) * wordsPerRow_, 0);
+    }
+
+    /**
+     Report coordinates outside the grid, kept out of line so set() stays small.
+    */
+    void BitBoard::outOfRange()
+    {
+        Error argError("BitBoard coordinates are outside the grid.", BB_ARG_ERROR, __FILE__, __LINE__);
+        throw argError;
+    }
+
+    /**
+     Clear every bit in the grid.
+    */
+    void BitBoard::clear()
+    {
+        std::fill(words_.begin(), words_.end(), 0);
+    }
+
+    /**
+     Set every bit within the rectangle [topX, lowX) x [topY, lowY).
+     The rectangle uses the same exclusive lower corner as GameBoard::VBorder and is not validated.
+    */
+    void BitBoard::setRect(int topX, int topY, int lowX, int lowY)
+    {
+        for(int x = topX; x < lowX; x++)
+        {
+            for(int y = topY; y < lowY; y++)
+            {
+                set(x, y);
+            }
+        }
+    }
+
+    /**
+     Clear every bit within the rectangle [topX, lowX) x [topY, lowY).
+     The rectangle is not validated.
+    */
+    void BitBoard::resetRect(int topX, int topY, int lowX, int lowY)
+    {
+        for(int x = topX; x < lowX; x++)
+        {
+            for(int y = topY; y < lowY; y++)
+            {
+                reset(x, y);
+            }
+        }
+    }
+
+    /**
+     Determine whether any bit is set within the rectangle [topX, lowX) x [topY, lowY).
+     @return
+        True if at least one bit in the rectangle is set.
+    */
+    bool BitBoard::anyInRect(int topX, int topY, int lowX, int lowY) const
+    {
+        for(int x = topX; x < lowX; x++)
+        {
+            for(int y = topY; y < lowY; y++)
+            {
+                if(test(x, y))
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     Count the number of set bits in the grid.
+     @return
+        The population count of the grid.
+    */
+    int BitBoard::count() const
+    {
+        int result = 0;
+        for(uint64_t word : words_)
+        {
+            result += __builtin_popcountll(word);
+        }
+        return result;
+    }
+
+    /**
+     @return
+        The number of rows in the grid.
+    */
+    int BitBoard::rows() const
+    {
+        return rows_;
+    }
+
+    /**
+     @return
+        The number of columns in the grid.
+    */
+    int BitBoard::cols() const
+    {
+        return cols_;
+    }
+
+    /**
+     @return
+        The number of 64-bit words used to store each row.
+    */
+    int BitBoard::wordsPerRow() const
+    {
+        return wordsPerRow_;
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     A compact two-dimensional grid of bits used for occupancy and shot masks.
+     Rows are indexed by x and columns by y to match the GameBoard coordinate system.
+     Every row is padded to a whole number of 64-bit words so row operations never straddle two rows.
+     Bits beyond the last column of a row are always zero.
+    */
+    class BitBoard
+    {
+    public:
+        BitBoard(int rows = 0, int cols = 0);
+
+        void set(int x, int y);
+        void reset(int x, int y);
+        bool test(int x, int y) const;
+        void clear();
+
+        void setRect(int topX, int topY, int lowX, int lowY);
+        void resetRect(int topX, int topY, int lowX, int lowY);
+        bool anyInRect(int topX, int topY, int lowX, int lowY) const;
+        int count() const;
+
+        int rows() const;
+        int cols() const;
+        int wordsPerRow() const;
+        const uint64_t* row(int x) const;
+        uint64_t* row(int x);
+
+    private:
+        [[noreturn]] static void outOfRange();
+
+    private:
+        int rows_;                      /**< Number of rows (x coordinates) */
+        int cols_;                      /**< Number of columns (y coordinates) */
+        int wordsPerRow_;               /**< 64-bit words used to store a single row */
+        std::vector<uint64_t> words_;   /**< Row major bit storage */
+    };
+
+    /**
+     Set the bit at the given coordinates. Coordinates outside the grid result in an exception, so the padding
+     past the last column stays clear.
+    */
+    inline void BitBoard::set(int x, int y)
+    {
+        if(static_cast<unsigned>(x) >= static_cast<unsigned>(rows_) || static_cast<unsigned>(y) >= static_cast<unsigned>(cols_))
+            outOfRange();
+        words_[x * wordsPerRow_ + (y >> 6)] |= (uint64_t(1) << (y & 63));
+    }
+
+    /**
+     Clear the bit at the given coordinates. Coordinates are not validated.
+    */
+    inline void BitBoard::reset(int x, int y)
+    {
+        words_[x * wordsPerRow_ + (y >> 6)] &= ~(uint64_t(1) << (y & 63));
+    }
+
+    /**
+     Test the bit at the given coordinates. Coordinates are not validated.
+    */
+    inline bool BitBoard::test(int x, int y) const
+    {
+        return (words_[x * wordsPerRow_ + (y >> 6)] >> (y & 63)) & 1;
+    }
+
+    /**
+     Obtain a pointer to the first word of row x.
+    */
+    inline const uint64_t* BitBoard::row(int x) const
+    {
+        return words_.data() + x * wordsPerRow_;
+    }
+
+    /**
+     Obtain a mutable pointer to the first word of row x. Callers must keep the bits past the last column clear.
+    */
+    inline uint64_t* BitBoard::row(int x)
+    {
+        return words_.data() + x * wordsPerRow_;
+    }
+}
+
+#endif
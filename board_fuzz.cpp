@@ -0,0 +1,264 @@
+/**
+ * @file board_fuzz.cpp
+ * Differential fuzz harness for the board engines. Decodes a byte string into placements, received and launched
+ * strikes, undo/redo round trips and clears, applies each one to the reference GameBoard and to TiledBoard in
+ * lockstep and aborts on the first result or board location that differs.
+ * Built with -DHIGHSEAS_LIBFUZZER=ON the file is a libFuzzer target, otherwise it runs random inputs on its own and
+ * reports the operation rate, or replays input files such as libFuzzer crash artifacts.
+ * Usage: board_fuzz [ops [seed]] | board_fuzz FILE...
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <system_error>
+#include <vector>
+#include "gameboard.h"
+#include "tiledboard.h"
+
+#define FUZZ_MAX_SIDE 20
+#define FUZZ_MARGIN 2
+#define FUZZ_OP_BYTES 4
+#define FUZZ_CASE_OPS 256
+#define FUZZ_DEFAULT_OPS 10000000
+
+using Clock = std::chrono::steady_clock;
+using Cylink::GameBoard;
+using Cylink::TiledBoard;
+using Cylink::Vessel;
+
+/**
+ @enum FuzzOp
+ The operations an input can drive, selected by the low four bits of an operation's first byte.
+*/
+enum FuzzOp
+{
+    FUZZ_EMPLACE = 0,       //0-3 place a vessel
+    FUZZ_RECEIVED = 4,      //4-9 receive a strike
+    FUZZ_LAUNCHED = 10,     //10-12 log a launched strike
+    FUZZ_UNDO = 13,         //13-14 undo and redo the last change on the reference board
+    FUZZ_CLEAR = 15         //15 clear both boards
+};
+
+/**
+ Report a difference between the boards and abort so libFuzzer keeps the input.
+*/
+[[noreturn]] static void mismatch(const char* what, long long op, int x, int y)
+{
+    std::fprintf(stderr, "board_fuzz: %s differs at operation %lld (%d, %d)\n", what, op, x, y);
+    std::abort();
+}
+
+/**
+ Check that one location reads the same on both boards.
+*/
+static void checkCell(const GameBoard& reference, const TiledBoard& tiled, int x, int y, long long op)
+{
+    const GameBoard::BoardData& expected = reference.cellAt(x, y);
+    GameBoard::BoardData actual = tiled.cellAt(x, y);
+    if(expected.vesselId != actual.vesselId)
+        mismatch("vessel id", op, x, y);
+    if(expected.received != actual.received)
+        mismatch("received strike", op, x, y);
+    if(expected.launched != actual.launched)
+        mismatch("launched strike", op, x, y);
+    if(expected.vesselId != GB_NO_VESSEL && expected.direction != actual.direction)
+        mismatch("vessel direction", op, x, y);
+}
+
+/**
+ Check every location, the vessel counts and the damage of every vessel.
+*/
+static void checkBoards(const GameBoard& reference, const TiledBoard& tiled, long long op)
+{
+    if(reference.vesselCount() != tiled.vesselCount())
+        mismatch("vessel count", op, -1, -1);
+    if(reference.activeVessels() != tiled.activeVessels())
+        mismatch("active vessel count", op, -1, -1);
+
+    for(int id = 0; id < reference.vesselCount(); id++)
+    {
+        Vessel expected(reference.getVessel(id));
+        Vessel actual(tiled.getVessel(id));
+        if(expected.getType() != actual.getType() || expected.getDamageLevel() != actual.getDamageLevel())
+            mismatch("vessel damage", op, id, -1);
+    }
+
+    for(int x = 0; x < reference.getLength(); x++)
+    {
+        for(int y = 0; y < reference.getWidth(); y++)
+            checkCell(reference, tiled, x, y, op);
+    }
+}
+
+/**
+ Map a byte to a coordinate in [-FUZZ_MARGIN, side + FUZZ_MARGIN) so strikes and placements also probe off the board.
+*/
+static inline int coordinate(uint8_t value, int side)
+{
+    return value % (side + 2 * FUZZ_MARGIN) - FUZZ_MARGIN;
+}
+
+/**
+ Run one input. The first two bytes give the board size, every following FUZZ_OP_BYTES bytes
+ (op, x, y, argument) are one operation.
+ @return
+    The number of operations run.
+*/
+static long long runInput(const uint8_t* data, size_t size)
+{
+    if(size < 2)
+        return 0;
+
+    const int length = 1 + data[0] % FUZZ_MAX_SIDE;
+    const int width = 1 + data[1] % FUZZ_MAX_SIDE;
+    GameBoard reference(length, width);
+    TiledBoard tiled(length, width);
+
+    long long op = 0;
+    for(size_t pos = 2; pos + FUZZ_OP_BYTES <= size; pos += FUZZ_OP_BYTES, op++)
+    {
+        const int code = data[pos] & 0x0F;
+        const int x = coordinate(data[pos + 1], length);
+        const int y = coordinate(data[pos + 2], width);
+        const uint8_t argument = data[pos + 3];
+        const bool onBoard = (0 <= x && x < length && 0 <= y && y < width);
+
+        if(code < FUZZ_RECEIVED)
+        {
+            Vessel::VType vtype = static_cast<Vessel::VType>(argument % 6);
+            GameBoard::VDirection vdir = (argument & 0x80) ? GameBoard::VDirection::VERTICAL : GameBoard::VDirection::HORIZONTAL;
+            GameBoard::VBorder expectedRect(x, y);
+            TiledBoard::VBorder actualRect(x, y);
+            std::error_code ec;
+            bool expected = reference.emplaceVessel(expectedRect, vtype, vdir, ec);
+            bool actual = tiled.emplaceVessel(actualRect, vtype, vdir);
+            if(expected != actual || (ec && onBoard))
+                mismatch("placement", op, x, y);
+            if(expected)
+            {
+                if(expectedRect.lowX != actualRect.lowX || expectedRect.lowY != actualRect.lowY)
+                    mismatch("vessel border", op, x, y);
+                for(int idx = expectedRect.topX; idx < expectedRect.lowX; idx++)
+                {
+                    for(int idy = expectedRect.topY; idy < expectedRect.lowY; idy++)
+                        checkCell(reference, tiled, idx, idy, op);
+                }
+            }
+        }
+        else if(code < FUZZ_LAUNCHED)
+        {
+            GameBoard::VBorder expectedRect(x, y);
+            TiledBoard::VBorder actualRect(x, y);
+            if(reference.logReceivedAttack(expectedRect) != tiled.logReceivedAttack(actualRect))
+                mismatch("received strike result", op, x, y);
+            if(onBoard)
+                checkCell(reference, tiled, x, y, op);
+            if(reference.activeVessels() != tiled.activeVessels())
+                mismatch("active vessel count", op, x, y);
+        }
+        else if(code < FUZZ_UNDO)
+        {
+            GameBoard::StrikeResult sresult = static_cast<GameBoard::StrikeResult>(argument % 5);
+            GameBoard::VBorder expectedRect(x, y);
+            TiledBoard::VBorder actualRect(x, y);
+            reference.logLaunchedAttack(expectedRect, sresult);
+            tiled.logLaunchedAttack(actualRect, sresult);
+            if(onBoard)
+                checkCell(reference, tiled, x, y, op);
+        }
+        else if(code < FUZZ_CLEAR)
+        {
+            /* A round trip through the event log must leave the reference board exactly as it was */
+            if(reference.undo() && !reference.redo())
+                mismatch("redo after undo", op, x, y);
+            if(reference.canRedo())
+                mismatch("redo tail", op, x, y);
+            checkBoards(reference, tiled, op);
+        }
+        else
+        {
+            reference.clear();
+            tiled.clear();
+        }
+    }
+
+    checkBoards(reference, tiled, op);
+    return op;
+}
+
+#ifdef HIGHSEAS_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    runInput(data, size);
+    return 0;
+}
+
+#else
+
+/**
+ Replay input files, eg. crash artifacts written by the libFuzzer build.
+*/
+static int replayFiles(int argc, char* argv[])
+{
+    for(int idx = 1; idx < argc; idx++)
+    {
+        std::ifstream file(argv[idx], std::ios::binary);
+        if(!file)
+        {
+            std::cerr<<"Unable to open "<<argv[idx]<<"\n";
+            return 1;
+        }
+        std::vector<uint8_t> input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        long long ops = runInput(input.data(), input.size());
+        std::cout<<argv[idx]<<": "<<ops<<" operations match\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    char* end = nullptr;
+    long long ops = FUZZ_DEFAULT_OPS;
+    if(argc > 1)
+    {
+        ops = std::strtoll(argv[1], &end, 10);
+        if(*end != '\0')
+            return replayFiles(argc, argv);
+    }
+    unsigned long long seed = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : std::random_device()();
+    if(ops <= 0)
+    {
+        std::cerr<<"Usage: board_fuzz [ops [seed]] | board_fuzz FILE...\n";
+        return 1;
+    }
+
+    std::mt19937_64 rng(seed);
+    std::vector<uint8_t> input(2 + FUZZ_CASE_OPS * FUZZ_OP_BYTES);
+    long long done = 0;
+    long long cases = 0;
+    auto start = Clock::now();
+    while(done < ops)
+    {
+        for(size_t idx = 0; idx < input.size(); idx += sizeof(uint64_t))
+        {
+            uint64_t bits = rng();
+            for(size_t byte = 0; byte < sizeof(uint64_t) && idx + byte < input.size(); byte++)
+                input[idx + byte] = static_cast<uint8_t>(bits >> (8 * byte));
+        }
+        done += runInput(input.data(), input.size());
+        cases++;
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    std::cout<<"seed "<<seed<<": "<<done<<" operations in "<<cases<<" inputs match, "
+        <<static_cast<long long>(done / elapsed.count())<<" operations/s\n";
+    return 0;
+}
+
+#endif
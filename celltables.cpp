@@ -0,0 +1,89 @@
+#include <mutex>
+
+#include "celltables.h"
+#include "error.h"
+
+#define CT_ARG_ERROR ErrorCode::ERR_INVALID_ARG
+
+namespace Cylink
+{
+    /* Tables live until the process exits, a run only ever sees a few board sizes */
+    static std::mutex tablesLock;
+    static std::vector<std::shared_ptr<const CellTables>> tables;
+
+    /**
+     Build the tables for a board of the given size.
+     Non-positive dimensions result in an exception.
+    */
+    CellTables::CellTables(int length, int width)
+        : lengthOfBoard_(length), widthOfBoard_(width), step_{-width, width, -1, 1}, neighbors_(), neighborCount_(),
+          reach_(), sides_(), sideCount_()
+    {
+        if(length <= 0 || width <= 0)
+        {
+            Error argError("Board dimensions must be positive.", CT_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        size_t cells = static_cast<size_t>(length) * width;
+        neighbors_.assign(cells * CT_DIRECTIONS, -1);
+        neighborCount_.assign(cells, 0);
+        reach_.assign(cells * CT_DIRECTIONS, 0);
+        sides_.assign(cells * CT_DIRECTIONS * 2, -1);
+        sideCount_.assign(cells * CT_DIRECTIONS, 0);
+
+        for(int x = 0; x < length; x++)
+        {
+            for(int y = 0; y < width; y++)
+            {
+                int cell = x * width + y;
+                int* reach = reach_.data() + cell * CT_DIRECTIONS;
+                reach[CT_UP] = x;
+                reach[CT_DOWN] = length - 1 - x;
+                reach[CT_LEFT] = y;
+                reach[CT_RIGHT] = width - 1 - y;
+                for(int dir = 0; dir < CT_DIRECTIONS; dir++)
+                {
+                    if(reach[dir] > 0)
+                        neighbors_[cell * CT_DIRECTIONS + neighborCount_[cell]++] = cell + step_[dir];
+                }
+                /* Across a vertical direction lie the left and right neighbors, across a horizontal one those above and below */
+                for(int dir = 0; dir < CT_DIRECTIONS; dir++)
+                {
+                    int first = (dir < CT_LEFT) ? CT_LEFT : CT_UP;
+                    int slot = cell * CT_DIRECTIONS + dir;
+                    for(int side = first; side <= first + 1; side++)
+                    {
+                        if(reach[side] > 0)
+                            sides_[slot * 2 + sideCount_[slot]++] = cell + step_[side];
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     Get the shared tables for a board size, building them on first use. Safe to call from any thread.
+     Non-positive dimensions result in an exception.
+    */
+    std::shared_ptr<const CellTables> CellTables::forBoard(int length, int width)
+    {
+        std::lock_guard<std::mutex> guard(tablesLock);
+        for(auto& table : tables)
+        {
+            if(table->lengthOfBoard_ == length && table->widthOfBoard_ == width)
+                return table;
+        }
+        tables.push_back(std::make_shared<const CellTables>(length, width));
+        return tables.back();
+    }
+
+    int CellTables::getLength() const
+    {
+        return lengthOfBoard_;
+    }
+
+    int CellTables::getWidth() const
+    {
+        return widthOfBoard_;
+    }
+}
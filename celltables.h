@@ -0,0 +1,86 @@
+#ifndef CELLTABLES_H
+#define CELLTABLES_H
+
+#include <memory>
+#include <vector>
+
+#define CT_DIRECTIONS 4
+#define CT_UP 0
+#define CT_DOWN 1
+#define CT_LEFT 2
+#define CT_RIGHT 3
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     Geometry of a board size, precomputed so targeting can step between cells by table lookups instead of
+     bounds checks. Cells are board indices x * width + y. Directions are CT_UP (x - 1), CT_DOWN (x + 1),
+     CT_LEFT (y - 1) and CT_RIGHT (y + 1); the opposite of direction d is d ^ 1.
+     For every cell the tables hold its on-board neighbors in direction order, how far a ray runs in each
+     direction before leaving the board, and the cells beside it across each direction, where the second
+     row of a 2-wide vessel lying along that direction would be.
+     Tables are immutable, so forBoard() builds them once per board size and every game shares them.
+    */
+    class CellTables
+    {
+    public:
+        CellTables(int length, int width);
+
+        static std::shared_ptr<const CellTables> forBoard(int length, int width);
+
+        int getLength() const;
+        int getWidth() const;
+        const int* neighbors(int cell) const;
+        int neighborCount(int cell) const;
+        int step(int dir) const;
+        int reach(int cell, int dir) const;
+        const int* sides(int cell, int dir) const;
+        int sideCount(int cell, int dir) const;
+
+    private:
+        int lengthOfBoard_;
+        int widthOfBoard_;
+        int step_[CT_DIRECTIONS];       /**< Index offset of one step in each direction */
+        std::vector<int> neighbors_;    /**< On-board neighbors of cell c start at neighbors_[c * CT_DIRECTIONS] */
+        std::vector<int> neighborCount_;
+        std::vector<int> reach_;        /**< Steps from cell c to the edge in direction d at c * CT_DIRECTIONS + d */
+        std::vector<int> sides_;        /**< Cells beside c across direction d start at sides_[(c * CT_DIRECTIONS + d) * 2] */
+        std::vector<int> sideCount_;
+    };
+
+    inline const int* CellTables::neighbors(int cell) const
+    {
+        return neighbors_.data() + cell * CT_DIRECTIONS;
+    }
+
+    inline int CellTables::neighborCount(int cell) const
+    {
+        return neighborCount_[cell];
+    }
+
+    inline int CellTables::step(int dir) const
+    {
+        return step_[dir];
+    }
+
+    inline int CellTables::reach(int cell, int dir) const
+    {
+        return reach_[cell * CT_DIRECTIONS + dir];
+    }
+
+    inline const int* CellTables::sides(int cell, int dir) const
+    {
+        return sides_.data() + (cell * CT_DIRECTIONS + dir) * 2;
+    }
+
+    inline int CellTables::sideCount(int cell, int dir) const
+    {
+        return sideCount_[cell * CT_DIRECTIONS + dir];
+    }
+}
+
+#endif
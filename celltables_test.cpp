@@ -0,0 +1,67 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include "celltables.h"
+#include "error.h"
+
+TEST_CASE ("Testing CellTables", "[CellTables]")
+{
+    SECTION("Tables match the board's geometry")
+    {
+        std::cout<<"Testing cell tables"<<std::endl;
+        static const int offsets[CT_DIRECTIONS][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+        int length = 4, width = 7;
+        Cylink::CellTables tables(length, width);
+        for(int x = 0; x < length; x++)
+        {
+            for(int y = 0; y < width; y++)
+            {
+                int cell = x * width + y;
+                std::vector<int> expected;
+                for(int dir = 0; dir < CT_DIRECTIONS; dir++)
+                {
+                    /* Walk the ray cell by cell to count its length */
+                    int steps = 0;
+                    int nx = x + offsets[dir][0], ny = y + offsets[dir][1];
+                    for(; nx >= 0 && nx < length && ny >= 0 && ny < width; steps++)
+                    {
+                        if(steps == 0)
+                            expected.push_back(nx * width + ny);
+                        nx += offsets[dir][0];
+                        ny += offsets[dir][1];
+                    }
+                    CHECK(tables.reach(cell, dir) == steps);
+                    CHECK(tables.step(dir) == offsets[dir][0] * width + offsets[dir][1]);
+
+                    /* The sides across a direction are the neighbors in the two perpendicular directions */
+                    std::vector<int> sides(tables.sides(cell, dir), tables.sides(cell, dir) + tables.sideCount(cell, dir));
+                    for(int side : sides)
+                    {
+                        int sx = side / width, sy = side % width;
+                        CHECK(std::abs(sx - x) + std::abs(sy - y) == 1);
+                        CHECK(((sx != x) == (offsets[dir][0] == 0)));
+                    }
+                    CHECK(sides.size() == static_cast<size_t>((offsets[dir][0] == 0) ? (x > 0) + (x < length - 1)
+                        : (y > 0) + (y < width - 1)));
+                }
+                std::vector<int> neighbors(tables.neighbors(cell), tables.neighbors(cell) + tables.neighborCount(cell));
+                CHECK(neighbors == expected);
+            }
+        }
+        CHECK(tables.neighborCount(0) == 2);
+        CHECK(tables.neighborCount(width + 1) == 4);
+        CHECK_THROWS_AS(Cylink::CellTables(0, 5), Cylink::Error);
+    }
+
+    SECTION("Tables are shared per board size")
+    {
+        std::cout<<"Testing shared cell tables"<<std::endl;
+        std::shared_ptr<const Cylink::CellTables> first = Cylink::CellTables::forBoard(10, 10);
+        CHECK(Cylink::CellTables::forBoard(10, 10) == first);
+        std::shared_ptr<const Cylink::CellTables> other = Cylink::CellTables::forBoard(10, 12);
+        CHECK(other != first);
+        CHECK(other->getWidth() == 12);
+        CHECK_THROWS_AS(Cylink::CellTables::forBoard(-1, 10), Cylink::Error);
+    }
+}
@@ -1,150 +1,154 @@
+#include <cstring>
+
 #include "error.h"
 
 using namespace std;
 using namespace Cylink;
 
-/* Definte the ErrorData structure */
-struct Error::ErrorData
+/* Code strings, filters and descriptions indexed by ErrorCode */
+static const char* const errCodes[] = {"", "CY0000", "CY0001"};
+static const char* const errFilters[] = {"", "INVALID_ARG", "IO_ERROR"};
+static const char* const errMessages[] = {"No error", "Invalid argument", "Input/output error"};
+static const size_t errCodeCount = sizeof(errCodes) / sizeof(errCodes[0]);
+
+/**
+ * Map an ErrorCode to its table index, unknown values map to ERR_NONE.
+ */
+static size_t errIndex(int code)
+{
+    return (code >= 0 && static_cast<size_t>(code) < errCodeCount) ? static_cast<size_t>(code) : 0;
+}
+
+namespace
 {
-    string errCode;     /**< A code used to identify the specific error */
-    string errFilter;   /**< Identifyer for the general processing area raising the error */
-    string errFile;     /**< The source file where error was generated. Use __FILE__ */
-    size_t errLine;     /**< The error line in the file. Use __LINE__ */
-};
+    /**
+     * @class ErrorCategory
+     * The std::error_category for ErrorCode values.
+     */
+    class ErrorCategory : public error_category
+    {
+        public:
+            const char* name() const noexcept override
+            {
+                return "highseas";
+            }
+
+            string message(int code) const override
+            {
+                return errMessages[errIndex(code)];
+            }
+    };
+}
 
 /**
- * Constructor creates and initializes an Error object.
+ * @return The category of std::error_code values holding an ErrorCode.
+ */
+const error_category& Cylink::errorCategory() noexcept
+{
+    static const ErrorCategory category;
+    return category;
+}
+
+/**
+ * Wrap an ErrorCode in a std::error_code. Lets an ErrorCode be assigned to a std::error_code directly.
  * @param code Is the error code.
- * @param filter Is a user supplied identifier for product module.
+ * @return The error code in the highseas category.
+ */
+error_code Cylink::make_error_code(ErrorCode code) noexcept
+{
+    return error_code(static_cast<int>(code), errorCategory());
+}
+
+/**
+ * Constructor creates and initializes an Error object.
  * @param msg The error message.
- * @param file Is the soure file where error was raised eg __FILE__.
+ * @param code Is the error code.
+ * @param file Is the soure file where error was raised eg __FILE__. The pointer is kept, not the text.
  * @param line Is the line in the source file eg __LINE__.
  */
-Error::Error(const string& msg, const string& code, const string& filter, const string& file, size_t line)
-:logic_error(msg)
+Error::Error(const char* msg, ErrorCode code, const char* file, size_t line) noexcept
+:code_(code), file_(file != nullptr ? file : ""), line_(line)
 {
-    pData = new ErrorData;
-    if(pData != nullptr)
-    {
-        pData->errLine = line;
-        pData->errCode = code;
-        pData->errFilter = filter;
-        pData->errFile = file;
-    }
+    setMessage(msg, msg != nullptr ? strlen(msg) : 0);
 }
 
 /**
- * Copy constructor creates a new Error object based on the argument.
- * @param err Is the Error object used to initialize the newly created object.
+ * Constructor for messages built at run time. The text is copied so the string may go away.
  */
-Error::Error(const Error& err)
-:logic_error(err.what())
+Error::Error(const string& msg, ErrorCode code, const char* file, size_t line) noexcept
+:code_(code), file_(file != nullptr ? file : ""), line_(line)
 {
-    pData = new ErrorData;
-    if(pData != nullptr)
-    {
-        pData->errLine = err.pData->errLine;
-        pData->errCode = err.pData->errCode;
-        pData->errFilter = err.pData->errFilter;
-        pData->errFile = err.pData->errFile;
-    }
+    setMessage(msg.data(), msg.size());
 }
 
 /**
- * Move constructor creates a new object that takes ownership of the internel resources of it's
- * argument. The parameter passed is left in the state of having been newly constructed.
- * @param err Is the rvalue reference providing resources for the current object.
+ * Copy the message into the fixed buffer, truncating it if it doesn't fit.
  */
-Error::Error(Error&& err)
-:logic_error(err.what())
+void Error::setMessage(const char* msg, size_t length) noexcept
 {
-    pData = err.pData;
-    err.pData = NULL;
+    if(length >= ERR_MESSAGE_SIZE)
+        length = ERR_MESSAGE_SIZE - 1;
+    if(length > 0)
+        memcpy(message_, msg, length);
+    message_[length] = '\0';
 }
 
 /**
- * Release all allocated resources.
+ * @return The error message.
  */
-Error::~Error()
+const char* Error::what() const noexcept
 {
-    delete pData;
-    pData = NULL;
+    return message_;
 }
 
 /**
- * Assignment operator copies the values in argument object to current object 
- * making the two equivalent.
- * @param err Is object that is assigned to current object.
- * @return A reference to the current object.
+ * @return The error code.
  */
-Error& Error::operator = (const Error& err)
+ErrorCode Error::code() const noexcept
 {
-    if(this != &err)
-    {
-        if(pData == nullptr)
-            pData = new ErrorData;
-        
-        if(pData != nullptr && err.pData != nullptr)
-        {
-            pData->errLine = err.pData->errLine;
-            pData->errCode = err.pData->errCode;
-            pData->errFilter = err.pData->errFilter;
-            pData->errFile = err.pData->errFile;
-        }
-    }
-    return *this;
+    return code_;
 }
 
 /**
- * Move assignment steals the internal data members from the object that's assigned to it.
- * @param err Is object that is assigned to current object.
- * @return A reference to the current object.
+ * @return The error code as a std::error_code, as reported by functions that don't throw.
  */
-Error& Error::operator = (Error&& err)
+error_code Error::errorCode() const noexcept
 {
-    if(this != &err)
-    {
-        if(pData != nullptr)
-            delete pData;
-        pData = err.pData;
-        err.pData = nullptr;
-    }
-    return *this;
+    return make_error_code(code_);
 }
 
 /**
- * Constant function to obtain the error code.
- * @return The error code
+ * Constant function to obtain the error code string.
+ * @return The error code eg CY0000
  */
-string Error::getErrorCode() const
+const char* Error::getErrorCode() const noexcept
 {
-    return (pData != nullptr) ? pData->errCode : "";    
+    return errCodes[errIndex(static_cast<int>(code_))];
 }
 
 /**
  * Constant function to obtain the module.
- * @return The module generating the error.
+ * @return The general processing area of the error eg INVALID_ARG.
  */
-string Error::getErrorFilter() const
+const char* Error::getErrorFilter() const noexcept
 {
-    return (pData != nullptr) ? pData->errFilter : "";
+    return errFilters[errIndex(static_cast<int>(code_))];
 }
 
 /**
  * Constant function to return the source.
  * @return The file originating the error.
  */
-string Error::getSourceFile() const
+const char* Error::getSourceFile() const noexcept
 {
-    return (pData != nullptr) ? pData->errFile : "";
+    return file_;
 }
 
 /**
  * Constant function to return the error line.
  * @return The line number
  */
-size_t Error::getSourceLine() const
+size_t Error::getSourceLine() const noexcept
 {
-    return (pData != nullptr) ? pData->errLine : 0;
+    return line_;
 }
-
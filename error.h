@@ -5,8 +5,12 @@
 #ifndef ERROR_H
 #define ERROR_H
 
-#include <iostream>
-#include <stdexcept>
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <system_error>
+
+#define ERR_MESSAGE_SIZE 160
 
 /**
  * @namespace Cylink
@@ -15,35 +19,58 @@
 namespace Cylink
 {
     /**
-     * @class Error
-     * Class defines a throwable object that stores error information
-     */
-    class Error : public std::logic_error 
+     @enum ErrorCode
+     The errors raised by the project. Each code has a fixed code string and filter, see Error::getErrorCode()
+     and Error::getErrorFilter(). ERR_NONE is zero so a default std::error_code means success.
+    */
+    enum class ErrorCode
+    {
+        ERR_NONE,
+        ERR_INVALID_ARG,        //CY0000 INVALID_ARG
+        ERR_IO                  //CY0001 IO_ERROR
+    };
+
+    const std::error_category& errorCategory() noexcept;
+    std::error_code make_error_code(ErrorCode code) noexcept;
+
+    /**
+     @class Error
+     Class defines a throwable object that stores error information.
+     Constructing, copying and throwing an Error never allocates: the code indexes static string tables, the source
+     file is kept as the __FILE__ pointer and the message is copied into a fixed buffer, truncated to
+     ERR_MESSAGE_SIZE - 1 characters.
+     Code that must not throw reports the same codes through std::error_code, see errorCategory().
+    */
+    class Error : public std::exception
     {
-        private:
-            /**
-             * @struct ErrorData
-             * Structure of internal Error members.
-             */
-            struct ErrorData;
-            
         public:
-            Error(const std::string& msg, const std::string& code, const std::string& filter, 
-                const std::string& file="", size_t line = 0);
-            Error(const Error& err);
-            Error(Error&& err);
-            ~Error();
-
-            Error& operator = (const Error& err);
-            Error& operator = (Error&& err);
-
-            std::string getErrorCode() const;
-            std::string getErrorFilter() const;
-            std::string getSourceFile() const;
-            size_t getSourceLine() const;
-            
+            Error(const char* msg, ErrorCode code, const char* file = "", size_t line = 0) noexcept;
+            Error(const std::string& msg, ErrorCode code, const char* file = "", size_t line = 0) noexcept;
+
+            const char* what() const noexcept override;
+            ErrorCode code() const noexcept;
+            std::error_code errorCode() const noexcept;
+            const char* getErrorCode() const noexcept;
+            const char* getErrorFilter() const noexcept;
+            const char* getSourceFile() const noexcept;
+            size_t getSourceLine() const noexcept;
+
+        private:
+            void setMessage(const char* msg, size_t length) noexcept;
+
         private:
-            ErrorData* pData; /**< Oblique pointer to ErrorData */
+            ErrorCode code_;
+            const char* file_;                  /**< The source file where error was generated. Use __FILE__ */
+            size_t line_;                       /**< The error line in the file. Use __LINE__ */
+            char message_[ERR_MESSAGE_SIZE];
+    };
+}
+
+namespace std
+{
+    template<>
+    struct is_error_code_enum<Cylink::ErrorCode> : true_type
+    {
     };
 }
 
@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include "error.h"
+#include "gameboard.h"
+
+TEST_CASE ("Testing Error", "[Error]")
+{
+    SECTION("Codes map to their code strings and filters")
+    {
+        std::cout<<"Testing error codes"<<std::endl;
+        Cylink::Error argError("Bad argument.", Cylink::ErrorCode::ERR_INVALID_ARG, __FILE__, __LINE__);
+        CHECK(std::string(argError.what()) == "Bad argument.");
+        CHECK(std::string(argError.getErrorCode()) == "CY0000");
+        CHECK(std::string(argError.getErrorFilter()) == "INVALID_ARG");
+        CHECK(std::string(argError.getSourceFile()) == __FILE__);
+        CHECK(argError.getSourceLine() > 0);
+
+        Cylink::Error ioError(std::string("Unable to write ") + "output", Cylink::ErrorCode::ERR_IO);
+        CHECK(std::string(ioError.what()) == "Unable to write output");
+        CHECK(std::string(ioError.getErrorCode()) == "CY0001");
+        CHECK(std::string(ioError.getErrorFilter()) == "IO_ERROR");
+        CHECK(std::string(ioError.getSourceFile()).empty());
+    }
+
+    SECTION("Errors are plain values")
+    {
+        std::cout<<"Testing error copies"<<std::endl;
+        CHECK(std::is_base_of<std::exception, Cylink::Error>::value);
+        CHECK(std::is_nothrow_copy_constructible<Cylink::Error>::value);
+
+        std::string longMessage(2 * ERR_MESSAGE_SIZE, 'x');
+        Cylink::Error original(longMessage, Cylink::ErrorCode::ERR_INVALID_ARG);
+        CHECK(std::strlen(original.what()) == ERR_MESSAGE_SIZE - 1);
+
+        Cylink::Error copy = original;
+        CHECK(std::string(copy.what()) == original.what());
+        CHECK(copy.what() != original.what());
+        CHECK(copy.code() == Cylink::ErrorCode::ERR_INVALID_ARG);
+    }
+
+    SECTION("Codes convert to std::error_code")
+    {
+        std::cout<<"Testing error_code channel"<<std::endl;
+        std::error_code ec = Cylink::ErrorCode::ERR_IO;
+        CHECK(ec);
+        CHECK(ec.category() == Cylink::errorCategory());
+        CHECK(ec == Cylink::ErrorCode::ERR_IO);
+        CHECK(std::string(ec.category().name()) == "highseas");
+        CHECK_FALSE(std::error_code(Cylink::ErrorCode::ERR_NONE));
+
+        Cylink::Error ioError("Failed.", Cylink::ErrorCode::ERR_IO);
+        CHECK(ioError.errorCode() == ec);
+    }
+
+    SECTION("Placement reports invalid coordinates without throwing")
+    {
+        std::cout<<"Testing non-throwing placement"<<std::endl;
+        Cylink::GameBoard board(10, 10);
+        std::error_code ec;
+
+        Cylink::GameBoard::VBorder outside(10, 0);
+        CHECK_FALSE(board.emplaceVessel(outside, Cylink::Vessel::VType::CRUISER, Cylink::GameBoard::VDirection::HORIZONTAL, ec));
+        CHECK(ec == Cylink::ErrorCode::ERR_INVALID_ARG);
+
+        Cylink::GameBoard::VBorder inside(0, 0);
+        CHECK(board.emplaceVessel(inside, Cylink::Vessel::VType::CRUISER, Cylink::GameBoard::VDirection::HORIZONTAL, ec));
+        CHECK_FALSE(ec);
+
+        Cylink::GameBoard::VBorder overlap(0, 0);
+        CHECK_FALSE(board.emplaceVessel(overlap, Cylink::Vessel::VType::CRUISER, Cylink::GameBoard::VDirection::HORIZONTAL, ec));
+        CHECK_FALSE(ec);
+
+        Cylink::GameBoard::VBorder thrown(-1, 0);
+        CHECK_THROWS_AS(board.emplaceVessel(thrown, Cylink::Vessel::VType::CRUISER, Cylink::GameBoard::VDirection::HORIZONTAL), Cylink::Error);
+    }
+}
@@ -0,0 +1,150 @@
+/**
+ * @file game_client.cpp
+ * Local stand-in for a remote AI. Plays games against a battleship --serve server over many connections at once
+ * from a single thread: every round sends one request on each connection, then reads every response, so the
+ * server always sees that many games in flight. Reports wins and round trip latency by message type.
+ * Usage: game_client ADDRESS [games] [connections] [strategy]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "error.h"
+#include "gameserver.h"
+
+#define CLIENT_DEFAULT_GAMES 1000
+#define CLIENT_DEFAULT_CONNECTIONS 100
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ @struct Lane
+ One connection and the game it is playing.
+*/
+struct Lane
+{
+    std::unique_ptr<Cylink::GameClient> client;
+    std::unique_ptr<Cylink::GameBoard> board;       /**< Records the client's shots for the strategy */
+    std::unique_ptr<Cylink::Strategy> strategy;
+    bool playing = false;
+    bool pending = false;                           /**< A request is waiting for its response */
+    Cylink::Request request;
+    Clock::time_point sent;
+};
+
+int main(int argc, char* argv[])
+{
+    if(argc < 2 || argc > 5)
+    {
+        std::cerr<<"Usage: game_client ADDRESS [games] [connections] [strategy]\n";
+        return 1;
+    }
+    std::string address = argv[1];
+    long long games = (argc > 2) ? std::atoll(argv[2]) : CLIENT_DEFAULT_GAMES;
+    int connections = (argc > 3) ? std::atoi(argv[3]) : CLIENT_DEFAULT_CONNECTIONS;
+    std::string strategy = (argc > 4) ? argv[4] : "random";
+    if(games <= 0 || connections <= 0)
+    {
+        std::cerr<<"Usage: game_client ADDRESS [games] [connections] [strategy]\n";
+        return 1;
+    }
+
+    std::mt19937_64 engine(std::random_device{}());
+    Cylink::LatencyTable latencies;
+    long long started = 0, won = 0, lost = 0, requests = 0;
+
+    try
+    {
+        std::vector<Lane> lanes(connections);
+        for(Lane& lane : lanes)
+            lane.client = std::make_unique<Cylink::GameClient>(address);
+
+        auto start = Clock::now();
+        bool active = true;
+        while(active)
+        {
+            active = false;
+            for(Lane& lane : lanes)
+            {
+                lane.request = Cylink::Request();
+                if(lane.playing)
+                {
+                    int xCord, yCord;
+                    std::tie(xCord, yCord) = lane.strategy->suggestFirePosition(*lane.board);
+                    lane.request.type = Cylink::MessageType::MSG_FIRE;
+                    lane.request.x = static_cast<uint16_t>(xCord);
+                    lane.request.y = static_cast<uint16_t>(yCord);
+                }
+                else if(started < games)
+                {
+                    lane.request.type = Cylink::MessageType::MSG_NEW_GAME;
+                    lane.request.arg = PROTO_AUTO_PLACE;
+                    started++;
+                }
+                else
+                {
+                    continue;
+                }
+                lane.sent = Clock::now();
+                lane.client->submit(lane.request);
+                lane.pending = true;
+                active = true;
+            }
+
+            for(Lane& lane : lanes)
+            {
+                if(!lane.pending)
+                    continue;
+                Cylink::Response response = lane.client->receive();
+                std::chrono::nanoseconds latency = Clock::now() - lane.sent;
+                latencies[static_cast<size_t>(lane.request.type)].add(latency.count());
+                lane.pending = false;
+                requests++;
+
+                if(response.status == Cylink::ReplyStatus::STATUS_REJECTED)
+                {
+                    std::cerr<<"Server rejected a "<<Cylink::Protocol::messageName(lane.request.type)<<" request\n";
+                    return 1;
+                }
+                if(lane.request.type == Cylink::MessageType::MSG_NEW_GAME)
+                {
+                    if(!lane.board)
+                    {
+                        lane.board = std::make_unique<Cylink::GameBoard>(response.x, response.y);
+                        lane.strategy = Cylink::Strategy::create(strategy, response.x, response.y);
+                    }
+                    lane.board->clear();
+                    lane.strategy->reset(engine());
+                    lane.playing = true;
+                    continue;
+                }
+
+                Cylink::GameBoard::StrikeResult result = static_cast<Cylink::GameBoard::StrikeResult>(response.result);
+                Cylink::GameBoard::VBorder vrect(lane.request.x, lane.request.y);
+                lane.board->logLaunchedAttack(vrect, result);
+                lane.strategy->recordResult(lane.request.x, lane.request.y, result);
+                if(response.status == Cylink::ReplyStatus::STATUS_WON)
+                    won++;
+                if(response.status == Cylink::ReplyStatus::STATUS_LOST)
+                    lost++;
+                if(response.status != Cylink::ReplyStatus::STATUS_OK)
+                    lane.playing = false;
+            }
+        }
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        std::cout<<won + lost<<" games over "<<connections<<" connections in "<<elapsed.count()<<"s, won "<<won
+            <<", lost "<<lost<<", "<<static_cast<long long>(requests / elapsed.count())<<" requests/second\n";
+        Cylink::Protocol::writeLatencies(std::cout, latencies);
+    }
+    catch(const Cylink::Error& err)
+    {
+        std::cerr<<err.what()<<"\n";
+        return 1;
+    }
+    return 0;
+}
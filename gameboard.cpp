@@ -1,37 +1,65 @@
+#include <algorithm>
 #include <tuple>
-#include <cstdlib>
+#include <climits>
+#include <ctime>
+#include <functional>
+#include <thread>
 
 #include "gameboard.h"
 #include "error.h"
-#include "utils.h"
+#include "instrument.h"
+#include "random.h"
+#include "renderer.h"
 
-#define BOARD_SQUARE 5
-#define GB_ARG_FILTER "INVALID_ARG"
-#define GB_ARG_ERROR "CY0000"
+#define GB_ARG_ERROR ErrorCode::ERR_INVALID_ARG
 
 #define GB_INVALID_POSITION -1
 
 namespace Cylink
 {
+    /**
+     Seed a thread's random stream from the clock and the thread, so threads started together differ.
+    */
+    static uint64_t clockSeed()
+    {
+        return streamSeed(static_cast<uint64_t>(time(NULL)), std::hash<std::thread::id>()(std::this_thread::get_id()), 0);
+    }
+
+    /**
+     @return
+        The calling thread's random stream for randomNumber(). Threads don't share state, so drawing needs no lock
+        and a stream seeded with seedRandom() repeats its numbers whatever other threads do.
+    */
+    static Xoshiro256& threadStream()
+    {
+        thread_local Xoshiro256 stream(clockSeed());
+        return stream;
+    }
+
     /**
      Create a game board with the given dimensions. The board doesn't have to be symetric.
-     Negative of zero argument values for length or width will result in an exception.
+     Negative of zero argument values for length or width will result in an exception, as will a board with more
+     than INT_MAX locations since board indices are int. Use TiledBoard for larger boards.
      @param length
         The length of the board. Defaults to GB_BOARD_SIZE if unspecified. Value must be greater than zero.
      @param width
         The width of the board. Defaults to GB_BOARD_SIZE if unspecified. Value must be greater than zero.
     */
     GameBoard::GameBoard(int length, int width)
-        : lengthOfBoard_(length), widthOfBoard_(width), board_(), vessels_()
+        : board_(), history_(), historyCursor_(0), lengthOfBoard_(length), widthOfBoard_(width), activeVessels_(0), vessels_()
     {
         if(lengthOfBoard_ <= 0 || widthOfBoard_ <= 0)
         {
-            Error argError("Board length and height must be greater than zero.", GB_ARG_ERROR, GB_ARG_FILTER, __FILE__, __LINE__);
+            Error argError("Board length and height must be greater than zero.", GB_ARG_ERROR, __FILE__, __LINE__);
             throw argError;
         }
-
-        /* Seed the random number generator */
-        randomNumber(0, 1, true);
+        if(static_cast<long long>(lengthOfBoard_) * widthOfBoard_ > INT_MAX)
+        {
+            Error argError("Board is too large.", GB_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        board_.resize(static_cast<size_t>(lengthOfBoard_) * widthOfBoard_);
+        history_.reserve(GB_HISTORY_RESERVE);
     }
 
     /**
@@ -40,10 +68,9 @@ namespace Cylink
         An existing GameBoard object used to copy initialize the new object.
     */
     GameBoard::GameBoard(const GameBoard& other)
-        : lengthOfBoard_(other.lengthOfBoard_), widthOfBoard_(other.widthOfBoard_), board_(other.board_), vessels_(other.vessels_)
+        : board_(other.board_), history_(other.history_), historyCursor_(other.historyCursor_), lengthOfBoard_(other.lengthOfBoard_),
+          widthOfBoard_(other.widthOfBoard_), activeVessels_(other.activeVessels_), vessels_(other.vessels_)
     {
-        /* Seed the random number generator */
-        randomNumber(0, 1, true);
     }
 
     /**
@@ -67,12 +94,29 @@ namespace Cylink
             /* Copy the contents between vectors below */
             board_ = other.board_;
             vessels_ = other.vessels_;
+            activeVessels_ = other.activeVessels_;
+            history_ = other.history_;
+            historyCursor_ = other.historyCursor_;
         }
         return *this;
     }
 
+    /**
+     Remove all vessels, strike records and the event log so the board can be reused for a new game.
+     The board keeps its dimensions and allocated storage.
+    */
+    void GameBoard::clear()
+    {
+        std::fill(board_.begin(), board_.end(), BoardData());
+        vessels_.clear();
+        activeVessels_ = 0;
+        history_.clear();
+        historyCursor_ = 0;
+    }
+
     /**
      Place a vessel on the gameboard at a random location with a random orientation.
+     Every open position and orientation the vessel fits in is equally likely.
      The function should generally succeed unless there is no place on the gameboard to fit a vessel
      of the given size.
      @param vtype
@@ -82,31 +126,12 @@ namespace Cylink
     */
     bool GameBoard::addVessel(Vessel::VType vtype)
     {
+        HS_TIME(ADD_VESSEL);
         bool result = false;
-        int boardPos = GB_INVALID_POSITION;
-        VDirection vdir;
+        VDirection vdir = VDirection::HORIZONTAL;
 
         /* Attempt to find an open position for the given vessel type. */
-        if (randomNumber(0, 1, false) == 1)
-        {
-            vdir = VDirection::VERTICAL;
-            boardPos = findOpenPosition(vtype, vdir);
-            if (boardPos == GB_INVALID_POSITION)
-            {
-                vdir = VDirection::HORIZONTAL;
-                boardPos = findOpenPosition(vtype, vdir);
-            }
-        }
-        else
-        {
-            vdir = VDirection::HORIZONTAL;
-            boardPos = findOpenPosition(vtype, vdir);
-            if (boardPos == GB_INVALID_POSITION)
-            {
-                vdir = VDirection::VERTICAL;
-                boardPos = findOpenPosition(vtype, vdir);
-            }
-        }
+        int boardPos = findOpenPosition(vtype, vdir);
 
         /* Place vessel on board if a good position is found. */
         if (boardPos != GB_INVALID_POSITION)
@@ -123,6 +148,7 @@ namespace Cylink
      Put a vessel on the game board if it's determined to meet the required criteria.
      Vessels may not overlap on the same game board, though another player may have a vessel in the same position on their board.
      The vessels must fit at the specified location on the game board given it's start position, orientation and size.
+     A successful placement is recorded in the event log, a rejected one is not.
      @param vrect
         The enclosing border rectangle for the specified vessel type.
         Caller must provide values for border members (topX, topY)
@@ -143,27 +169,133 @@ namespace Cylink
         //A valid border implies a valid map was returned so...
         if(isValidBorder(vrect) == true && isAreaOccupied(vmap) == GB_INVALID_POSITION)
         {
-            //Add vessel to warship list
-            vessels_.push_back(Vessel(vtype));
-            int vesselId = vessels_.size()-1;
+            placeVessel(vrect, vtype, vdir);
+
+            BoardEvent event = {};
+            event.type = EventType::EVENT_PLACE;
+            event.vrect = vrect;
+            event.vtype = vtype;
+            event.vdir = vdir;
+            recordEvent(event);
 
-            //Update board with vessel position
-            int mSize = vmap.size();
-            for(int idx=0; idx<mSize; idx++)
-            {
-                board_[vmap[idx]].vesselId = vesselId;
-            }
             //set the result
             result = true;
         }
         return result;
     }
 
+    /**
+     Put a vessel on the game board without throwing. Invalid (topX, topY) coordinates set ec to
+     ErrorCode::ERR_INVALID_ARG and return false instead of raising an Error, so callers probing many
+     positions, such as the fuzz harness, don't pay for an exception per rejected position.
+     @param ec
+        Cleared on success or when the vessel doesn't fit, set when the top coordinates are off the board.
+     @return
+        True if the vessel was placed.
+    */
+    bool GameBoard::emplaceVessel(VBorder& vrect, Vessel::VType vtype, VDirection vdir, std::error_code& ec)
+    {
+        if(!isValidTopXY(vrect))
+        {
+            ec = ErrorCode::ERR_INVALID_ARG;
+            return false;
+        }
+        ec.clear();
+        return emplaceVessel(vrect, vtype, vdir);
+    }
+
+    /**
+     Add a vessel to the warship list and mark its footprint on the board. The border must be valid and unoccupied.
+    */
+    void GameBoard::placeVessel(const VBorder& vrect, Vessel::VType vtype, VDirection vdir)
+    {
+        vessels_.push_back(Vessel(vtype));
+        int vesselId = vessels_.size()-1;
+        activeVessels_++;
+
+        for(int idx = vrect.topX; idx < vrect.lowX; idx++)
+        {
+            BoardData* row = &board_[static_cast<size_t>(idx) * widthOfBoard_];
+            for(int idy = vrect.topY; idy < vrect.lowY; idy++)
+            {
+                row[idy].vesselId = vesselId;
+                row[idy].direction = vdir;
+            }
+        }
+    }
+
+    /**
+     @return
+        The length of the board, ie. the number of valid x coordinates.
+    */
+    int GameBoard::getLength() const
+    {
+        return lengthOfBoard_;
+    }
+
+    /**
+     @return
+        The width of the board, ie. the number of valid y coordinates.
+    */
+    int GameBoard::getWidth() const
+    {
+        return widthOfBoard_;
+    }
+
+    /**
+     Obtain the data stored at a board location.
+     Passing invalid coordinates will result in an exception.
+     @param x
+        The x coordinate of the location.
+     @param y
+        The y coordinate of the location.
+     @return
+        A reference to the location's BoardData.
+    */
+    const GameBoard::BoardData& GameBoard::cellAt(int x, int y) const
+    {
+        VBorder vrect(x, y);
+        return board_[coordinateIndex(vrect)];
+    }
+
+    /**
+     @return
+        The number of vessels placed on the board. Valid vessel ids are [0, vesselCount()).
+    */
+    int GameBoard::vesselCount() const
+    {
+        return vessels_.size();
+    }
+
+    /**
+     @return
+        The number of vessels on the board that have not been destroyed. Zero means the game is lost.
+    */
+    int GameBoard::activeVessels() const
+    {
+        return activeVessels_;
+    }
+
+    /**
+     Obtain a vessel on the board by its id, as stored in BoardData::vesselId.
+     Passing an invalid id will result in an exception.
+    */
+    const Vessel& GameBoard::getVessel(int vesselId) const
+    {
+        if(vesselId < 0 || vesselId >= static_cast<int>(vessels_.size()))
+        {
+            Error argError("Invalid vessel id supplied.", GB_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        return vessels_[vesselId];
+    }
+
     /**
      Records an attack on a specified location on the gameboard and returns the result of that attack.
      This record saves information about an oppoenents attack. To save information about an attack launched against an opponent
      call the @logLaunchedAttack() function.
      The result of the attack is one the StrikeResult enumeration.
+     Every attack on a valid location is recorded in the event log, even one that changes nothing.
      @param vrect
         Pass the coordinates to be attacked as the (topX, topY) coordinates of the vrect.
      @return 
@@ -171,14 +303,85 @@ namespace Cylink
     */
     GameBoard::StrikeResult GameBoard::logReceivedAttack(VBorder& vrect)
     {
+        HS_TIME(RECEIVED_ATTACK);
         StrikeResult result = StrikeResult::STRIKE_INVALID;
 
         //Return if the location specified is invalid
         if (!isValidTopXY(vrect))
             return result;
 
-        //Determine whether the location has been hit before or not
-        int index = coordinateIndex(vrect, true);
+        return receiveStrike(coordinateIndex(vrect, true));
+    }
+
+    /**
+     Receive a number of shots at once, eg. for the salvo rule where a player fires one shot per vessel afloat.
+     The shots are applied in row order, x then y, with exactly the results and event log entries that calling
+     logReceivedAttack() for each of them in that order would give. The mask is walked a word at a time, so only
+     the shots themselves are visited and no coordinates need validating.
+     A mask that doesn't match the board's dimensions, or has bits past the last column, results in an exception.
+     @param shots
+        The locations attacked.
+     @param result
+        Receives every shot's result and the vessels destroyed. Its previous contents are discarded, its
+        storage is reused.
+    */
+    void GameBoard::logReceivedSalvo(const BitBoard& shots, SalvoResult& result)
+    {
+        NullBoardObserver observer;
+        logReceivedSalvo(shots, result, observer);
+    }
+
+    /**
+     Receive a number of shots at once, see logReceivedSalvo(const BitBoard&, SalvoResult&).
+     @return
+        Every shot's result and the vessels destroyed.
+    */
+    GameBoard::SalvoResult GameBoard::logReceivedSalvo(const BitBoard& shots)
+    {
+        SalvoResult result;
+        result.shots.reserve(shots.count());
+        logReceivedSalvo(shots, result);
+        return result;
+    }
+
+    /**
+     Throw if a salvo's mask doesn't match the board's dimensions or has bits set past the last column.
+    */
+    void GameBoard::checkSalvo(const BitBoard& shots) const
+    {
+        if(shots.rows() != lengthOfBoard_ || shots.cols() != widthOfBoard_)
+        {
+            Error argError("The salvo does not match the board.", GB_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        /* Bits in a row's padding, set through the mutable row(), would index past the row */
+        int tail = widthOfBoard_ % 64;
+        if(tail == 0)
+            return;
+        uint64_t padding = ~uint64_t(0) << tail;
+        for(int x = 0; x < lengthOfBoard_; x++)
+        {
+            if(shots.row(x)[shots.wordsPerRow() - 1] & padding)
+            {
+                Error argError("The salvo has shots off the board.", GB_ARG_ERROR, __FILE__, __LINE__);
+                throw argError;
+            }
+        }
+    }
+
+    /**
+     Apply a received strike at a valid board index and record it in the event log.
+     @return
+        A StrikeResult indicating the results of the attack.
+    */
+    GameBoard::StrikeResult GameBoard::receiveStrike(int index)
+    {
+        StrikeResult result = StrikeResult::STRIKE_INVALID;
+        BoardEvent event = {};
+        event.type = EventType::EVENT_RECEIVED;
+        event.index = index;
+        event.before = board_[index].received;
+
         switch (board_[index].received)
         {
         case StrikeType::STYPE_NONE:
@@ -206,17 +409,36 @@ namespace Cylink
         //If this was a hit, determine whether vessel is destroyed.
         if (result == StrikeResult::STRIKE_HIT)
         {
-            if (vessels_[board_[index].vesselId].takeHit(1) == 0)
+            event.damaged = true;
+            if (receiveHit(index))
                 result = StrikeResult::STRIKE_DESTROYED;
         }
 
+        event.after = board_[index].received;
+        recordEvent(event);
         return result;
     }
 
+    /**
+     Apply one hit to the vessel at a board index.
+     @return
+        True if the hit destroyed the vessel.
+    */
+    bool GameBoard::receiveHit(int index)
+    {
+        if (vessels_[board_[index].vesselId].takeHit(1) == 0)
+        {
+            activeVessels_--;
+            return true;
+        }
+        return false;
+    }
+
     /**
      Records an attack launched against an opponent at a specified location.
      This record saves information about where the opponent has been attacked. 
      To save information about an attack launched by the opponent, call the @logReceivedAttack() function.
+     Attacks on valid locations are recorded in the event log.
      @param vrect
         Pass the coordinates to be attacked as the (topX, topY) coordinates of the vrect.
     */
@@ -228,6 +450,11 @@ namespace Cylink
 
         //Determine whether the location has been hit before or not
         int index = coordinateIndex(vrect, true);
+        BoardEvent event = {};
+        event.type = EventType::EVENT_LAUNCHED;
+        event.index = index;
+        event.before = board_[index].launched;
+
         switch(sresult)
         {
         case StrikeResult::STRIKE_INVALID:
@@ -240,75 +467,179 @@ namespace Cylink
             board_[index].launched = StrikeType::STYPE_HIT;
             break;
         }
+
+        event.after = board_[index].launched;
+        recordEvent(event);
+    }
+
+    /**
+     Take back the most recent placement or strike still applied, restoring the board locations, vessel damage
+     and active vessel count exactly. Undo never allocates.
+     @return
+        True if an event was undone, false if the event log has nothing left to undo.
+    */
+    bool GameBoard::undo()
+    {
+        if(historyCursor_ == 0)
+            return false;
+
+        const BoardEvent& event = history_[--historyCursor_];
+        switch(event.type)
+        {
+        case EventType::EVENT_PLACE:
+            //Events are undone last first so the vessel is the last one placed and has taken no hits
+            for(int idx = event.vrect.topX; idx < event.vrect.lowX; idx++)
+            {
+                BoardData* row = &board_[static_cast<size_t>(idx) * widthOfBoard_];
+                for(int idy = event.vrect.topY; idy < event.vrect.lowY; idy++)
+                {
+                    row[idy].vesselId = GB_NO_VESSEL;
+                    row[idy].direction = VDirection::HORIZONTAL;
+                }
+            }
+            vessels_.pop_back();
+            activeVessels_--;
+            break;
+
+        case EventType::EVENT_RECEIVED:
+            board_[event.index].received = event.before;
+            if(event.damaged)
+            {
+                Vessel& vessel = vessels_[board_[event.index].vesselId];
+                if(vessel.getDamageLevel() == 0)
+                    activeVessels_++;
+                vessel.repairHit(1);
+            }
+            break;
+
+        case EventType::EVENT_LAUNCHED:
+            board_[event.index].launched = event.before;
+            break;
+        }
+        return true;
+    }
+
+    /**
+     Apply the most recently undone event again. Any new placement or strike discards the events that could be redone.
+     Redo doesn't allocate unless it places a vessel beyond the capacity of the vessel list.
+     @return
+        True if an event was redone, false if there is nothing to redo.
+    */
+    bool GameBoard::redo()
+    {
+        if(static_cast<size_t>(historyCursor_) == history_.size())
+            return false;
+
+        const BoardEvent& event = history_[historyCursor_++];
+        switch(event.type)
+        {
+        case EventType::EVENT_PLACE:
+            placeVessel(event.vrect, event.vtype, event.vdir);
+            break;
+
+        case EventType::EVENT_RECEIVED:
+            board_[event.index].received = event.after;
+            if(event.damaged)
+                receiveHit(event.index);
+            break;
+
+        case EventType::EVENT_LAUNCHED:
+            board_[event.index].launched = event.after;
+            break;
+        }
+        return true;
+    }
+
+    /**
+     @return
+        True if there is an applied event that undo() can take back.
+    */
+    bool GameBoard::canUndo() const
+    {
+        return historyCursor_ > 0;
+    }
+
+    /**
+     @return
+        True if there is an undone event that redo() can apply.
+    */
+    bool GameBoard::canRedo() const
+    {
+        return static_cast<size_t>(historyCursor_) < history_.size();
+    }
+
+    /**
+     Reserve room for the given number of events so recording them doesn't allocate.
+     The constructor reserves GB_HISTORY_RESERVE events.
+    */
+    void GameBoard::reserveHistory(int events)
+    {
+        if(events > 0)
+            history_.reserve(events);
+    }
+
+    /**
+     Append an event to the log, discarding any events that were undone and could have been redone.
+    */
+    void GameBoard::recordEvent(const BoardEvent& event)
+    {
+        history_.resize(historyCursor_);
+        history_.push_back(event);
+        historyCursor_++;
     }
 
     /**
      Find a random position on the board where the specified vessel can be placed.
+     Every open (position, direction) pair is equally likely, so positions following long occupied runs are no
+     more likely than any other. A first pass counts the open pairs and a second walks to the one picked,
+     probing each footprint in place, so the search doesn't allocate.
      @param vtype
         Is the type of vessel to be placed on the board.
      @param vdir
-        Is the orientation of the vessel when placed on board.
+        Receives the orientation of the vessel at the position found.
      @return
         An integer corresponding to the identified open position or GB_INVALID_POSITION if nothing is found.
     */
-    int GameBoard::findOpenPosition(Vessel::VType vtype, VDirection vdir)
+    int GameBoard::findOpenPosition(Vessel::VType vtype, VDirection& vdir)
     {
-        bool stopFlag = false;
-        int result = GB_INVALID_POSITION;
+        HS_TIME(FIND_OPEN_POSITION);
+        const VDirection directions[] = {VDirection::HORIZONTAL, VDirection::VERTICAL};
 
-        /* Get a random starting position for the vessel. */
-        VBorder vrect;
-        vrect.topX = randomNumber(0, lengthOfBoard_, false);
-        vrect.topY = randomNumber(0, widthOfBoard_, false);
-
-        size_t searchPos = coordinateIndex(vrect, true);
-        size_t savePos = searchPos;
-
-        while(!stopFlag)
+        int boardSize = board_.size();
+        int pick = -1;
+        for(int pass = 0; pass < 2; pass++)
         {
-            /* 
-            Verify search position doesn't exceed  bounds.
-            This is always false on first pass.
-            */
-            if (searchPos >= board_.size())
-                searchPos = 0;
-
-            /* scan for open position if search position is occupied already */
-            while(board_[searchPos].vesselId >= 0)
+            int open = 0;
+            for(int searchPos = 0; searchPos < boardSize; searchPos++)
             {
-                searchPos++;
-                /* 
-                Ensure we don't loop beyond starting point.
-                searchPos may have been set to start at 0 above.
-                */
-                if(searchPos == savePos)
-                {
-                    stopFlag = true;
-                    break;
-                }
-            }
+                /* skip positions that are occupied already */
+                if(board_[searchPos].vesselId >= 0)
+                    continue;
 
-            /* Process only stopFlag is not true */
-            if (!stopFlag)
-            {
-                /* 
-                At this stage we're at an open position.
-                Determine whether vessel can fit here.
-                Start by obtaining vessel boarder and map based 
-                */
-                std::tie(vrect.topX, vrect.topY) = coordinates(searchPos);
-                std::vector<int> vmap = getPositionMap(vrect, vtype, vdir);
-
-                /* Determine if the vessel area is valid */
-                if(isValidBorder(vrect) == true && isAreaOccupied(vmap) == GB_INVALID_POSITION)
+                for(int dirIdx = 0; dirIdx < 2; dirIdx++)
                 {
-                    result = searchPos;
-                    stopFlag = true;
+                    VBorder vrect;
+                    std::tie(vrect.topX, vrect.topY) = coordinates(searchPos);
+                    border(vrect, vtype, directions[dirIdx]);
+                    if(!isValidBorder(vrect) || !isAreaFree(vrect))
+                    {
+                        if(pass == 0)
+                            HS_COUNT(OPEN_POSITION_REJECT);
+                        continue;
+                    }
+                    if(open++ == pick)
+                    {
+                        vdir = directions[dirIdx];
+                        return searchPos;
+                    }
                 }
-                searchPos++;
             }
-        }        
-        return result;
+
+            if(open == 0)
+                return GB_INVALID_POSITION;
+            pick = randomNumber(0, open - 1, false);
+        }
+        return GB_INVALID_POSITION;
     }
 
     /**
@@ -318,7 +649,7 @@ namespace Cylink
      The function will adjust the vrect parameter with the full boarder for the specified vessel.
      Note that depending on the type of vessel specified in vtype and the (topX, topY) coordinates provided the 
      vessels footprint may exceed the boundary of the board. It's therefore recommended that the user validate the 
-     vrect provided. If the vrect is valid, then the return vector contains valid gameboard positions.
+     vrect provided. If the vrect is valid, then the return vector contains valid gameboard positions, otherwise it is empty.
      @param vrect
         The enclosing rectangular border of the vessel defined by the cordinates for the top left corner and lower right corner.
      @param vtype
@@ -333,14 +664,18 @@ namespace Cylink
         /* Validate the starting coordinates */
         if(!isValidTopXY(vrect))
         {
-            Error argError("Invalid border top arguments supplied.", GB_ARG_ERROR, GB_ARG_FILTER, __FILE__, __LINE__);
+            Error argError("Invalid border top arguments supplied.", GB_ARG_ERROR, __FILE__, __LINE__);
             throw argError;
         }
 
         //obtain the vessels border
         border(vrect, vtype, vdir);
 
+        //a footprint that overhangs the board has no valid positions
         std::vector<int> result;
+        if(!isValidBorder(vrect))
+            return result;
+
         for(int idx = vrect.topX; idx < vrect.lowX; idx++)
         {
             for(int idy = vrect.topY; idy < vrect.lowY; idy++)
@@ -377,9 +712,31 @@ namespace Cylink
         return result;
     }
 
+    /**
+     Determine whether no vessel occupies any cell of a border that lies on the board, without building its position map.
+     @param vrect
+        A valid border, see isValidBorder().
+     @return
+        True if every cell within the border is open.
+    */
+    bool GameBoard::isAreaFree(const VBorder& vrect) const
+    {
+        for(int idx = vrect.topX; idx < vrect.lowX; idx++)
+        {
+            const BoardData* row = board_.data() + static_cast<size_t>(idx) * widthOfBoard_;
+            for(int idy = vrect.topY; idy < vrect.lowY; idy++)
+            {
+                if(row[idy].vesselId >= 0)
+                    return false;
+            }
+        }
+        return true;
+    }
+
     /**
      Determine if the border argument supplied fits within the confines of the game board.
      All coordinate values must be set for the vrect parameter before calling this function.
+     The lower corner of a border is exclusive (see border()) so it may lie one past the last row or column.
      @param vrect
         The enclosing rectangular border of the vessel defined by the cordinates for the top left corner and lower right corner.
      @return
@@ -388,7 +745,8 @@ namespace Cylink
     */
     bool GameBoard::isValidBorder(VBorder& vrect) const
     {
-        return (isValidTopXY(vrect) && isValidLowXY(vrect));
+        return (isValidTopXY(vrect) && vrect.topX < vrect.lowX && vrect.lowX <= lengthOfBoard_ 
+            && vrect.topY < vrect.lowY && vrect.lowY <= widthOfBoard_);
     }
 
     /**
@@ -447,17 +805,17 @@ namespace Cylink
 
         if((topFlag && !isValidTopXY(vrect)) || (!topFlag && !isValidLowXY(vrect)))
         {
-            Error argError("Invalid coordinates supplied.", GB_ARG_ERROR, GB_ARG_FILTER, __FILE__, __LINE__);
+            Error argError("Invalid coordinates supplied.", GB_ARG_ERROR, __FILE__, __LINE__);
             throw argError;
         }
 
         if(topFlag == true)
         {
-            result = (vrect.topX * lengthOfBoard_) + vrect.topY;
+            result = (vrect.topX * widthOfBoard_) + vrect.topY;
         }
         else
         {
-            result = (vrect.lowX * lengthOfBoard_) + vrect.lowY;
+            result = (vrect.lowX * widthOfBoard_) + vrect.lowY;
         }
 
         return result;
@@ -474,45 +832,56 @@ namespace Cylink
     {
         if (index < 0)
         {
-            Error argError("Invalid board index.", GB_ARG_ERROR, GB_ARG_FILTER, __FILE__, __LINE__);
+            Error argError("Invalid board index.", GB_ARG_ERROR, __FILE__, __LINE__);
             throw argError;
         }
 
-        int row = index / lengthOfBoard_;
-        int col = index % lengthOfBoard_;
+        int row = index / widthOfBoard_;
+        int col = index % widthOfBoard_;
 
         return std::make_pair(row, col);
     }
 
     /**
-     Generate random numbers within the specified range. The number generated is the range [start, end]    
+     Generate random numbers within the specified range. The number generated is the range [start, end]
+     Numbers are drawn from the calling thread's random stream, every number in the range equally likely.
+     Each thread's stream starts from the clock, or from the seed given to seedRandom().
      If invalid values are passed for the start and end arguments, the function will throw a Cylink::Error.
-     The random number generator should be seeded on first call by setting the third parameter to true.
      @param start
         The first number within the possible values specifying the range.
         This may be zero or a positive number.
      @param end
         The last possible number to generate within the range.
-        This may not be less than or equal to the value of @param start
+        This may not be less than the value of @param start
      @param seedFlag
-        A flag to indicate whether or not the random number generator should be seeded.
-        A value of true will cause the seeding of the generator before a random number is generated.
+        A flag to indicate whether or not the thread's stream should be reseeded from the clock first.
      @return
         A pseudo random number within the specified range.
     */
     int GameBoard::randomNumber(int start, int end, bool seedFlag)
     {
-        if(start < 0 || end < 0 || start >= end)
+        if(start < 0 || end < 0 || start > end)
         {
-            Error argError("Invalid number range supplied.", GB_ARG_ERROR, GB_ARG_FILTER, __FILE__, __LINE__);
+            Error argError("Invalid number range supplied.", GB_ARG_ERROR, __FILE__, __LINE__);
             throw argError;
         }
 
+        Xoshiro256& stream = threadStream();
         if(seedFlag == true)
         {
-            srand(static_cast<unsigned int>(time(NULL)));
+            stream.seed(clockSeed());
         }
-        return start + (rand() % end);
+        return start + static_cast<int>(stream.below(static_cast<uint64_t>(end) - start + 1));
+    }
+
+    /**
+     Seed the calling thread's random stream, so the layouts addVessel() picks on this thread repeat for the same seed.
+     @param seed
+        The seed, eg. derived for the thread's work with streamSeed().
+    */
+    void GameBoard::seedRandom(uint64_t seed)
+    {
+        threadStream().seed(seed);
     }
 
     /**
@@ -551,7 +920,8 @@ namespace Cylink
     }
 
     /**
-     Print the game board grid to the specified output stream
+     Print the game board grid to the specified output stream.
+     Each location shows the two letter code of the vessel in it or '.' for open water. See BoardRenderer.
      @param os
         A standard output stream to print the game board to.
      @param vs
@@ -561,26 +931,8 @@ namespace Cylink
     */
     std::ostream& operator<<(std::ostream& os, const GameBoard& gb)
     {
-        /* print colum*/
-        os<<"\n"<<std::setw(BOARD_SQUARE)<<" ";
-        for(int x=0; x<gb.lengthOfBoard_; x++)
-        {
-            os<<std::setw(BOARD_SQUARE)<<StringUtils::centered(std::to_string(x+1));
-        }
-        os<<"\n";
-
-        for(int x=0; x<gb.lengthOfBoard_; x++)
-        {
-            os<<std::setw(BOARD_SQUARE)<<StringUtils::centered(std::to_string(x+1));
-            for(int y=0; y<gb.widthOfBoard_; y++)
-            {
-                GameBoard::VBorder vrect(x, y);
-                int coordinateIndex = gb.coordinateIndex(vrect);
-                int vesselId = gb.board_[coordinateIndex].vesselId;
-                Vessel vs = gb.vessels_[vesselId];
-                os<<std::setw(BOARD_SQUARE)<<StringUtils::centered(Vessel::formatVessel(vs.getType(), false));
-            }
-        }
+        std::vector<char> buffer(BoardRenderer::bufferSize(gb.lengthOfBoard_, gb.widthOfBoard_));
+        os.write(buffer.data(), BoardRenderer::render(gb, buffer.data(), buffer.size()));
         return os;
     }
 }
\ No newline at end of file
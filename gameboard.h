@@ -1,12 +1,20 @@
 #ifndef GAMEBOARD_H
 #define GAMEBOARD_H
 
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <new>
+#include <system_error>
 #include <vector>
+#include "bitboard.h"
+#include "instrument.h"
 #include "vessel.h"
 
 #define GB_BOARD_SIZE 10
 #define GB_NO_VESSEL -1
+#define GB_HISTORY_RESERVE 512
+#define GB_CACHE_LINE 64
 
 /**
  * @namespace Cylink
@@ -14,10 +22,48 @@
  */
 namespace Cylink
 {
+    /**
+     Allocator giving each buffer whole cache lines of its own: buffers start on a line and are padded to the
+     end of their last line, so no other allocation shares a line with them.
+    */
+    template<typename T>
+    struct CacheLineAllocator
+    {
+        using value_type = T;
+
+        CacheLineAllocator() = default;
+        template<typename U>
+        CacheLineAllocator(const CacheLineAllocator<U>&) {}
+
+        T* allocate(size_t count)
+        {
+            return static_cast<T*>(::operator new(paddedSize(count), std::align_val_t(GB_CACHE_LINE)));
+        }
+
+        void deallocate(T* buffer, size_t count)
+        {
+            ::operator delete(buffer, paddedSize(count), std::align_val_t(GB_CACHE_LINE));
+        }
+
+        static size_t paddedSize(size_t count)
+        {
+            return (count * sizeof(T) + GB_CACHE_LINE - 1) / GB_CACHE_LINE * GB_CACHE_LINE;
+        }
+
+        template<typename U>
+        bool operator ==(const CacheLineAllocator<U>&) const { return true; }
+        template<typename U>
+        bool operator !=(const CacheLineAllocator<U>&) const { return false; }
+    };
+
     /**
      Notes:
      Build a dynamic GameBoard of specified size.
      Once a ship is hit, hitting the same spot does not count
+     Placements and strikes are kept in an event log so they can be taken back with undo() and replayed with redo().
+     A board starts on a cache line of its own, with the state every strike touches on that line, including the count
+     of vessels afloat, and the fleet on the next. The cells, the fleet and the event log are allocated on whole cache
+     lines too, so the boards of games played on different threads never share a line however they were allocated.
     */
     class GameBoard
     {
@@ -93,24 +139,105 @@ namespace Cylink
             }
         };
         
+        /**
+         @struct SalvoShot
+         One shot of a salvo and its result.
+        */
+        struct SalvoShot
+        {
+            int x;
+            int y;
+            StrikeResult result;
+        };
+
+        /**
+         @struct SalvoResult
+         The outcome of a salvo, see logReceivedSalvo().
+        */
+        struct SalvoResult
+        {
+            std::vector<SalvoShot> shots;   /**< Every shot in the order it was applied */
+            std::vector<int> destroyed;     /**< Ids of the vessels the salvo destroyed, in the order they sank */
+        };
+
     public:
         GameBoard(int length = GB_BOARD_SIZE, int width = GB_BOARD_SIZE);
         GameBoard(const GameBoard& other);
         ~GameBoard();
         GameBoard& operator =(const GameBoard& other);
 
+        void clear();
         bool emplaceVessel(VBorder& vrect, Vessel::VType vtype, VDirection vdir);
+        bool emplaceVessel(VBorder& vrect, Vessel::VType vtype, VDirection vdir, std::error_code& ec);
+        template<typename Observer>
+        bool emplaceVessel(VBorder& vrect, Vessel::VType vtype, VDirection vdir, Observer& observer);
         bool addVessel(Vessel::VType vtype);
         void logLaunchedAttack(VBorder& vrect, StrikeResult sresult);
+        template<typename Observer>
+        void logLaunchedAttack(VBorder& vrect, StrikeResult sresult, Observer& observer);
         StrikeResult logReceivedAttack(VBorder& vrect);
+        template<typename Observer>
+        StrikeResult logReceivedAttack(VBorder& vrect, Observer& observer);
+        void logReceivedSalvo(const BitBoard& shots, SalvoResult& result);
+        template<typename Observer>
+        void logReceivedSalvo(const BitBoard& shots, SalvoResult& result, Observer& observer);
+        SalvoResult logReceivedSalvo(const BitBoard& shots);
+
+        bool undo();
+        bool redo();
+        bool canUndo() const;
+        bool canRedo() const;
+        void reserveHistory(int events);
+
+        int getLength() const;
+        int getWidth() const;
+        const BoardData& cellAt(int x, int y) const;
+        int vesselCount() const;
+        int activeVessels() const;
+        const Vessel& getVessel(int vesselId) const;
 
         static int randomNumber(int start, int end, bool seedFlag = false);
+        static void seedRandom(uint64_t seed);
         friend std::ostream& operator<<(std::ostream& os, const GameBoard& gb);
         
     private:
-        int findOpenPosition(Vessel::VType vtype, VDirection vdir);    
+        /**
+         @enum EventType
+         The board changes recorded in the event log.
+        */
+        enum class EventType
+        {
+            EVENT_PLACE,
+            EVENT_RECEIVED,
+            EVENT_LAUNCHED
+        };
+
+        /**
+         @struct BoardEvent
+         One entry of the event log, holding enough to apply the change again or take it back.
+        */
+        struct BoardEvent
+        {
+            EventType type;
+            int index;                  /**< Board index of a strike */
+            StrikeType before;          /**< Strike state of the location before a strike */
+            StrikeType after;           /**< Strike state of the location after a strike */
+            bool damaged;               /**< A received strike took a hit off a vessel */
+            VBorder vrect;              /**< Footprint of a placed vessel */
+            Vessel::VType vtype;
+            VDirection vdir;
+        };
+
+        void placeVessel(const VBorder& vrect, Vessel::VType vtype, VDirection vdir);
+        StrikeResult receiveStrike(int index);
+        void checkSalvo(const BitBoard& shots) const;
+        bool receiveHit(int index);
+        void recordEvent(const BoardEvent& event);
+
+        int findOpenPosition(Vessel::VType vtype, VDirection& vdir);    
         std::vector<int> getPositionMap(VBorder& vrect, Vessel::VType vtype, VDirection vdir) const; 
         int isAreaOccupied(std::vector<int>& vmap) const;
+        bool isAreaFree(const VBorder& vrect) const;
         bool isValidBorder(VBorder& vrect) const;
         bool isValidTopXY(VBorder& vrect) const;
         bool isValidLowXY(VBorder& vrect) const;
@@ -121,11 +248,120 @@ namespace Cylink
         static void border(VBorder& vrect, Vessel::VType vtype, VDirection vdir);
 
     private:
+        /* The first cache line holds what every strike touches */
+        std::vector<BoardData, CacheLineAllocator<BoardData>> board_;   /**< Gameboard as a one-dimensional vector */
+        std::vector<BoardEvent, CacheLineAllocator<BoardEvent>> history_;   /**< Event log, events past historyCursor_ can be redone */
+        int historyCursor_;             /**< Number of events currently applied */
         int lengthOfBoard_;
         int widthOfBoard_;
-        std::vector<BoardData> board_;  /**< Gameboard as a one-dimensional vector */
-        std::vector<Vessel> vessels_;   /**< The various vessels on the GameBoard */
+        int activeVessels_;             /**< Vessels on the GameBoard that have not been destroyed, read after every strike */
+        /* The second holds the fleet, only touched when a strike hits */
+        alignas(GB_CACHE_LINE) std::vector<Vessel, CacheLineAllocator<Vessel>> vessels_;   /**< The various vessels on the GameBoard */
     };
+
+    /**
+     Board observer whose hooks do nothing. The observer overloads of GameBoard's mutators are templates, so
+     hooks are resolved at compile time and an empty hook compiles away. An observer derives from this and
+     declares only the hooks it cares about, hiding the empty ones.
+    */
+    struct NullBoardObserver
+    {
+        /** A vessel was placed with the given footprint and id. */
+        void onPlaced(const GameBoard::VBorder& vrect, Vessel::VType vtype, GameBoard::VDirection vdir, int vesselId) {}
+        /** An attack was received at (x, y). */
+        void onReceived(int xCord, int yCord, GameBoard::StrikeResult result) {}
+        /** An attack was launched at (x, y). */
+        void onLaunched(int xCord, int yCord, GameBoard::StrikeResult result) {}
+        /** The attack received at (x, y) destroyed the vessel. */
+        void onDestroyed(int xCord, int yCord, const Vessel& vessel) {}
+    };
+
+    /**
+     Place a vessel as emplaceVessel() does and tell an observer about it with onPlaced().
+     @param observer
+        The observer told about the placement if it succeeded.
+    */
+    template<typename Observer>
+    bool GameBoard::emplaceVessel(VBorder& vrect, Vessel::VType vtype, VDirection vdir, Observer& observer)
+    {
+        if (!emplaceVessel(vrect, vtype, vdir))
+            return false;
+        observer.onPlaced(vrect, vtype, vdir, vesselCount() - 1);
+        return true;
+    }
+
+    /**
+     Log a launched attack and pass it on to an observer, eg. a ProbabilityMap. The observer needs an
+     onLaunched(int x, int y, StrikeResult) member and is only told about attacks on valid locations.
+     @param observer
+        The observer told about the attack after it was logged.
+    */
+    template<typename Observer>
+    void GameBoard::logLaunchedAttack(VBorder& vrect, StrikeResult sresult, Observer& observer)
+    {
+        logLaunchedAttack(vrect, sresult);
+        if (isValidTopXY(vrect))
+            observer.onLaunched(vrect.topX, vrect.topY, sresult);
+    }
+
+    /**
+     Log a received attack and tell an observer about it with onReceived(), followed by onDestroyed() if the
+     attack sank a vessel. Attacks on invalid locations aren't observed.
+     @param observer
+        The observer told about the attack after it was logged.
+     @return
+        A StrikeResult indicating the results of the attack.
+    */
+    template<typename Observer>
+    GameBoard::StrikeResult GameBoard::logReceivedAttack(VBorder& vrect, Observer& observer)
+    {
+        StrikeResult result = logReceivedAttack(vrect);
+        if (result == StrikeResult::STRIKE_INVALID)
+            return result;
+        observer.onReceived(vrect.topX, vrect.topY, result);
+        if (result == StrikeResult::STRIKE_DESTROYED)
+            observer.onDestroyed(vrect.topX, vrect.topY, vessels_[board_[coordinateIndex(vrect, true)].vesselId]);
+        return result;
+    }
+
+    /**
+     Receive a salvo as logReceivedSalvo(const BitBoard&, SalvoResult&) does and tell an observer about every shot
+     with onReceived(), followed by onDestroyed() if the shot sank a vessel. The hooks fire as each shot is applied,
+     in the same order as calling logReceivedAttack() with the observer for each shot would fire them.
+     A mask that doesn't match the board's dimensions, or has bits past the last column, results in an exception.
+     @param observer
+        The observer told about each shot after it was logged.
+    */
+    template<typename Observer>
+    void GameBoard::logReceivedSalvo(const BitBoard& shots, SalvoResult& result, Observer& observer)
+    {
+        checkSalvo(shots);
+        result.shots.clear();
+        result.destroyed.clear();
+
+        int words = shots.wordsPerRow();
+        for(int x = 0; x < lengthOfBoard_; x++)
+        {
+            const uint64_t* row = shots.row(x);
+            for(int idx = 0; idx < words; idx++)
+            {
+                for(uint64_t word = row[idx]; word != 0; word &= word - 1)
+                {
+                    HS_TIME(RECEIVED_ATTACK);
+                    int y = idx * 64 + __builtin_ctzll(word);
+                    int index = x * widthOfBoard_ + y;
+                    StrikeResult strike = receiveStrike(index);
+                    result.shots.push_back({x, y, strike});
+                    observer.onReceived(x, y, strike);
+                    if(strike == StrikeResult::STRIKE_DESTROYED)
+                    {
+                        result.destroyed.push_back(board_[index].vesselId);
+                        observer.onDestroyed(x, y, vessels_[board_[index].vesselId]);
+                    }
+                }
+            }
+        }
+    }
 }
 
 #endif
\ No newline at end of file
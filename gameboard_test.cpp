@@ -0,0 +1,257 @@
+#include <catch2/catch_test_macros.hpp>
+#include "error.h"
+#include "bitboard.h"
+#include "gameboard.h"
+
+/**
+ Compare every location, vessel and the active vessel count of two boards.
+*/
+static bool sameBoard(const Cylink::GameBoard& first, const Cylink::GameBoard& second)
+{
+    if(first.vesselCount() != second.vesselCount() || first.activeVessels() != second.activeVessels())
+        return false;
+    for(int id = 0; id < first.vesselCount(); id++)
+    {
+        Cylink::Vessel one = first.getVessel(id), two = second.getVessel(id);
+        if(one.getType() != two.getType() || one.getDamageLevel() != two.getDamageLevel())
+            return false;
+    }
+    for(int x = 0; x < first.getLength(); x++)
+    {
+        for(int y = 0; y < first.getWidth(); y++)
+        {
+            const Cylink::GameBoard::BoardData& one = first.cellAt(x, y);
+            const Cylink::GameBoard::BoardData& two = second.cellAt(x, y);
+            if(one.vesselId != two.vesselId || one.received != two.received || one.launched != two.launched
+                || one.direction != two.direction)
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ Observer recording the hooks it was called with. Launches aren't recorded, so that hook stays the empty one.
+*/
+struct RecordingObserver : public Cylink::NullBoardObserver
+{
+    std::vector<int> placed;
+    std::vector<Cylink::GameBoard::StrikeResult> received;
+    std::vector<std::pair<int, int>> cells;
+    std::vector<Cylink::Vessel::VType> destroyed;
+    std::vector<std::pair<int, int>> sunkAt;
+
+    void onPlaced(const Cylink::GameBoard::VBorder& vrect, Cylink::Vessel::VType vtype, Cylink::GameBoard::VDirection vdir, int vesselId)
+    {
+        placed.push_back(vesselId);
+    }
+    void onReceived(int xCord, int yCord, Cylink::GameBoard::StrikeResult result)
+    {
+        received.push_back(result);
+        cells.emplace_back(xCord, yCord);
+    }
+    void onDestroyed(int xCord, int yCord, const Cylink::Vessel& vessel)
+    {
+        destroyed.push_back(vessel.getType());
+        sunkAt.emplace_back(xCord, yCord);
+    }
+};
+
+TEST_CASE ("Testing GameBoard", "[GameBoard]")
+{
+    Cylink::GameBoard board(10, 10);
+    Cylink::GameBoard::VBorder carrier(0, 0), submarine(4, 4);
+    REQUIRE(board.emplaceVessel(carrier, Cylink::Vessel::VType::CARRIER, Cylink::GameBoard::VDirection::HORIZONTAL));
+    REQUIRE(board.emplaceVessel(submarine, Cylink::Vessel::VType::SUBMARINE, Cylink::GameBoard::VDirection::VERTICAL));
+
+    SECTION("Undo restores strikes and vessel damage exactly")
+    {
+        std::cout<<"Testing undo and redo of strikes"<<std::endl;
+        const Cylink::GameBoard placed(board);
+
+        /* Sink the submarine, then take it all back */
+        std::vector<Cylink::GameBoard> states;
+        Cylink::GameBoard::StrikeResult last = Cylink::GameBoard::StrikeResult::STRIKE_INVALID;
+        for(int x = submarine.topX; x < submarine.lowX; x++)
+        {
+            for(int y = submarine.topY; y < submarine.lowY; y++)
+            {
+                Cylink::GameBoard::VBorder shot(x, y);
+                last = board.logReceivedAttack(shot);
+                board.logLaunchedAttack(shot, last);
+                states.push_back(board);
+            }
+        }
+        Cylink::GameBoard::VBorder repeat(submarine.topX, submarine.topY);
+        CHECK(board.logReceivedAttack(repeat) == Cylink::GameBoard::StrikeResult::STRIKE_PREVIOUS);
+        CHECK(last == Cylink::GameBoard::StrikeResult::STRIKE_DESTROYED);
+        CHECK(board.activeVessels() == 1);
+
+        CHECK(board.undo());
+        CHECK(sameBoard(board, states.back()));
+        for(size_t idx = states.size() - 1; idx > 0; idx--)
+        {
+            CHECK(board.undo());
+            CHECK(board.undo());
+            CHECK(sameBoard(board, states[idx - 1]));
+        }
+        CHECK(board.undo());
+        CHECK(board.undo());
+        CHECK(sameBoard(board, placed));
+
+        /* Redo replays the same strikes, including the sinking */
+        while(board.canRedo())
+            board.redo();
+        CHECK(board.activeVessels() == 1);
+        CHECK(Cylink::Vessel(board.getVessel(1)).getDamageLevel() == 0);
+    }
+
+    SECTION("Placements undo and new events discard the redo tail")
+    {
+        std::cout<<"Testing undo of placements"<<std::endl;
+        CHECK(board.undo());
+        CHECK(board.vesselCount() == 1);
+        CHECK(board.cellAt(submarine.topX, submarine.topY).vesselId == GB_NO_VESSEL);
+        CHECK(board.canRedo());
+
+        Cylink::GameBoard::VBorder miss(9, 9);
+        CHECK(board.logReceivedAttack(miss) == Cylink::GameBoard::StrikeResult::STRIKE_MISS);
+        CHECK_FALSE(board.canRedo());
+        CHECK_FALSE(board.redo());
+
+        CHECK(board.undo());
+        CHECK(board.undo());
+        CHECK_FALSE(board.undo());
+        CHECK(board.vesselCount() == 0);
+        CHECK(board.activeVessels() == 0);
+    }
+
+    SECTION("Depth first search explores in place")
+    {
+        std::cout<<"Testing repeated try and retract"<<std::endl;
+        const Cylink::GameBoard placed(board);
+        for(int depth = 0; depth < 3; depth++)
+        {
+            for(int move = 0; move < 100; move++)
+            {
+                Cylink::GameBoard::VBorder target(move / 10, move % 10);
+                board.logReceivedAttack(target);
+            }
+            CHECK(board.activeVessels() == 0);
+            for(int move = 0; move < 100; move++)
+                board.undo();
+            CHECK(sameBoard(board, placed));
+        }
+        CHECK_THROWS_AS(board.getVessel(2), Cylink::Error);
+    }
+
+    SECTION("Observers are told about placements, strikes and sinkings")
+    {
+        std::cout<<"Testing board observers"<<std::endl;
+        RecordingObserver observer;
+        Cylink::GameBoard::VBorder cruiser(9, 0), overlap(0, 0);
+        CHECK(board.emplaceVessel(cruiser, Cylink::Vessel::VType::CRUISER, Cylink::GameBoard::VDirection::HORIZONTAL, observer));
+        CHECK_FALSE(board.emplaceVessel(overlap, Cylink::Vessel::VType::CRUISER, Cylink::GameBoard::VDirection::HORIZONTAL, observer));
+        REQUIRE(observer.placed == std::vector<int>{2});
+
+        Cylink::GameBoard::VBorder first(9, 0), second(9, 1), miss(9, 5), outside(10, 0);
+        CHECK(board.logReceivedAttack(first, observer) == Cylink::GameBoard::StrikeResult::STRIKE_HIT);
+        CHECK(board.logReceivedAttack(miss, observer) == Cylink::GameBoard::StrikeResult::STRIKE_MISS);
+        CHECK(board.logReceivedAttack(outside, observer) == Cylink::GameBoard::StrikeResult::STRIKE_INVALID);
+        CHECK(board.logReceivedAttack(second, observer) == Cylink::GameBoard::StrikeResult::STRIKE_DESTROYED);
+        CHECK(observer.received.size() == 3);
+        REQUIRE(observer.destroyed.size() == 1);
+        CHECK(observer.destroyed[0] == Cylink::Vessel::VType::CRUISER);
+
+        /* The null observer accepts every hook */
+        Cylink::NullBoardObserver none;
+        board.logLaunchedAttack(miss, Cylink::GameBoard::StrikeResult::STRIKE_MISS, observer);
+        board.logLaunchedAttack(miss, Cylink::GameBoard::StrikeResult::STRIKE_MISS, none);
+        CHECK(board.logReceivedAttack(first, none) == Cylink::GameBoard::StrikeResult::STRIKE_PREVIOUS);
+    }
+
+    SECTION("A salvo matches the same shots received one at a time")
+    {
+        std::cout<<"Testing salvos"<<std::endl;
+        Cylink::GameBoard sequential(board);
+        Cylink::BitBoard shots(10, 10);
+        for(int x = 0; x < 10; x++)
+        {
+            for(int y = 0; y < 10; y++)
+            {
+                if((x + y) % 3 == 0 || (y == submarine.topY && x >= submarine.topX && x < submarine.lowX))
+                    shots.set(x, y);
+            }
+        }
+
+        /* The second salvo repeats the first, so every shot is a miss or a previous hit */
+        RecordingObserver salvoObserver, sequentialObserver;
+        for(int round = 0; round < 2; round++)
+        {
+            Cylink::GameBoard::SalvoResult salvo;
+            board.logReceivedSalvo(shots, salvo, salvoObserver);
+            REQUIRE(salvo.shots.size() == static_cast<size_t>(shots.count()));
+            std::vector<int> destroyed;
+            for(auto& shot : salvo.shots)
+            {
+                Cylink::GameBoard::VBorder single(shot.x, shot.y);
+                CHECK(sequential.logReceivedAttack(single, sequentialObserver) == shot.result);
+                if(shot.result == Cylink::GameBoard::StrikeResult::STRIKE_DESTROYED)
+                    destroyed.push_back(sequential.cellAt(shot.x, shot.y).vesselId);
+            }
+            CHECK(salvo.destroyed == destroyed);
+            CHECK(salvo.destroyed.size() == (round == 0 ? 1u : 0u));
+            CHECK(sameBoard(board, sequential));
+        }
+        CHECK(board.activeVessels() == 1);
+
+        /* The salvo fires the same hooks, in the same order, as the shots one at a time */
+        CHECK(salvoObserver.received == sequentialObserver.received);
+        CHECK(salvoObserver.cells == sequentialObserver.cells);
+        CHECK(salvoObserver.destroyed == sequentialObserver.destroyed);
+        CHECK(salvoObserver.sunkAt == sequentialObserver.sunkAt);
+        CHECK(salvoObserver.received.size() == static_cast<size_t>(2 * shots.count()));
+        CHECK(salvoObserver.destroyed == std::vector<Cylink::Vessel::VType>{Cylink::Vessel::VType::SUBMARINE});
+
+        /* Every shot is its own event, so undo walks both salvos back shot by shot */
+        for(int idx = 0; idx < 2 * shots.count(); idx++)
+        {
+            CHECK(board.undo());
+            CHECK(sequential.undo());
+        }
+        CHECK(sameBoard(board, sequential));
+        CHECK(board.activeVessels() == 2);
+
+        /* Shots past the first word of a row */
+        Cylink::GameBoard wide(3, 70);
+        Cylink::GameBoard::VBorder cruiser(1, 65);
+        REQUIRE(wide.emplaceVessel(cruiser, Cylink::Vessel::VType::CRUISER, Cylink::GameBoard::VDirection::HORIZONTAL));
+        Cylink::BitBoard broadside(3, 70);
+        broadside.set(1, 3);
+        broadside.set(1, 65);
+        broadside.set(1, 66);
+        Cylink::GameBoard::SalvoResult result;
+        wide.logReceivedSalvo(broadside, result);
+        REQUIRE(result.shots.size() == 3);
+        CHECK(result.shots[0].result == Cylink::GameBoard::StrikeResult::STRIKE_MISS);
+        CHECK(result.shots[1].result == Cylink::GameBoard::StrikeResult::STRIKE_HIT);
+        CHECK(result.shots[2].y == 66);
+        CHECK(result.shots[2].result == Cylink::GameBoard::StrikeResult::STRIKE_DESTROYED);
+        CHECK(result.destroyed == std::vector<int>{0});
+
+        Cylink::BitBoard mismatched(10, 9);
+        CHECK_THROWS_AS(board.logReceivedSalvo(mismatched), Cylink::Error);
+        CHECK_THROWS_AS(board.logReceivedSalvo(mismatched, result, salvoObserver), Cylink::Error);
+
+        /* Bits past the last column are off the board, whether set directly or through a row */
+        Cylink::BitBoard stray(10, 10);
+        CHECK_THROWS_AS(stray.set(9, 20), Cylink::Error);
+        CHECK_THROWS_AS(stray.set(10, 0), Cylink::Error);
+        CHECK(stray.count() == 0);
+        stray.row(4)[0] |= uint64_t(1) << 12;
+        Cylink::GameBoard untouched(board);
+        CHECK_THROWS_AS(board.logReceivedSalvo(stray), Cylink::Error);
+        CHECK_THROWS_AS(board.logReceivedSalvo(stray, result, salvoObserver), Cylink::Error);
+        CHECK(sameBoard(board, untouched));
+    }
+}
@@ -0,0 +1,682 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "gameserver.h"
+#include "error.h"
+#include "random.h"
+#include "simulation.h"
+
+#define GS_ARG_ERROR ErrorCode::ERR_INVALID_ARG
+#define GS_IO_ERROR ErrorCode::ERR_IO
+
+#define GS_MAX_EVENTS 256
+#define GS_READ_BYTES 4096
+#define GS_MAX_COORDINATE 65535
+
+using Clock = std::chrono::steady_clock;
+
+namespace Cylink
+{
+    static char gsListenTag;    /**< epoll tag of the listening socket */
+    static char gsStopTag;      /**< epoll tag of the stop eventfd */
+
+    /**
+     @enum GamePhase
+     Where a connection's game stands.
+    */
+    enum class GamePhase
+    {
+        PHASE_IDLE,             //No game, waiting for MSG_NEW_GAME
+        PHASE_PLACING,          //The client is placing its fleet
+        PHASE_PLAYING           //Shots are being exchanged
+    };
+
+    /**
+     @struct Session
+     The two players of a connection's game. Sessions are pooled per worker and reused for later games.
+    */
+    struct Session
+    {
+        Player host;                            /**< The server's player */
+        Player remote;                          /**< The client's board, the client picks the shots */
+        GamePhase phase = GamePhase::PHASE_IDLE;
+        int unplaced[STAT_VESSEL_TYPES] = {};   /**< Vessels of each type the client still has to place */
+        int remaining = 0;
+
+        Session(int length, int width)
+            : host(length, width), remote(length, width)
+        {
+        }
+    };
+
+    /**
+     @struct Connection
+     A client connection and its buffers. Input holds at most one partial frame between reads.
+    */
+    struct Connection
+    {
+        int fd = -1;
+        size_t slot = 0;                        /**< Position in the worker's connection list */
+        uint8_t input[GS_READ_BYTES];
+        size_t inputLength = 0;
+        std::vector<uint8_t> output;
+        size_t outputSent = 0;
+        bool writing = false;                   /**< Waiting for EPOLLOUT, input is not read meanwhile */
+        std::unique_ptr<Session> session;
+    };
+
+    /**
+     One event loop thread. A worker owns the connections it accepts, their sessions and its latency histograms.
+    */
+    class GameServer::Worker
+    {
+    public:
+        Worker(const ServerConfig& config, int listenFd, int stopFd, uint64_t seed);
+        ~Worker();
+
+        void run();
+
+        std::atomic<long long> connections;
+        std::atomic<long long> games;
+        LatencyTable latencies;
+
+    private:
+        void accept();
+        void serve(Connection& conn, uint32_t events);
+        bool flush(Connection& conn);
+        void close(Connection& conn);
+        Response handle(Connection& conn, const Request& request);
+        Response newGame(Connection& conn, const Request& request);
+        Response place(Session& session, const Request& request);
+        Response fire(Session& session, const Request& request);
+        void layout(Player& player);
+
+    private:
+        const ServerConfig& config_;
+        int listenFd_;
+        int epollFd_;
+        std::vector<std::unique_ptr<Connection>> connections_;
+        std::vector<std::unique_ptr<Session>> sessions_;    /**< Free sessions */
+        PlacementGenerator generator_;
+        Xoshiro256 engine_;
+    };
+
+    /**
+     Create a worker with its own epoll instance watching the listening socket and the stop eventfd.
+     The listening socket is registered with EPOLLEXCLUSIVE so a new connection wakes one worker, not all.
+    */
+    GameServer::Worker::Worker(const ServerConfig& config, int listenFd, int stopFd, uint64_t seed)
+        : connections(0), games(0), latencies(), config_(config), listenFd_(listenFd), epollFd_(-1),
+          connections_(), sessions_(), generator_(config.fleet, config.length, config.width), engine_(seed)
+    {
+        epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        epoll_event listenEvent = {};
+        listenEvent.events = EPOLLIN | EPOLLEXCLUSIVE;
+        listenEvent.data.ptr = &gsListenTag;
+        epoll_event stopEvent = {};
+        stopEvent.events = EPOLLIN;
+        stopEvent.data.ptr = &gsStopTag;
+        if(epollFd_ < 0 || ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &listenEvent) != 0
+            || ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, stopFd, &stopEvent) != 0)
+        {
+            Error ioError(std::string("Unable to create event loop: ") + std::strerror(errno), GS_IO_ERROR, __FILE__, __LINE__);
+            if(epollFd_ >= 0)
+                ::close(epollFd_);
+            throw ioError;
+        }
+    }
+
+    GameServer::Worker::~Worker()
+    {
+        while(!connections_.empty())
+            close(*connections_.back());
+        ::close(epollFd_);
+    }
+
+    /**
+     The event loop. Closes every connection and returns once the stop eventfd becomes readable;
+     it is never read so every worker sees it.
+    */
+    void GameServer::Worker::run()
+    {
+        epoll_event events[GS_MAX_EVENTS];
+        for(;;)
+        {
+            int count = ::epoll_wait(epollFd_, events, GS_MAX_EVENTS, -1);
+            if(count < 0)
+            {
+                if(errno == EINTR)
+                    continue;
+                return;
+            }
+            for(int idx = 0; idx < count; idx++)
+            {
+                void* tag = events[idx].data.ptr;
+                if(tag == &gsStopTag)
+                {
+                    while(!connections_.empty())
+                        close(*connections_.back());
+                    return;
+                }
+                if(tag == &gsListenTag)
+                    accept();
+                else
+                    serve(*static_cast<Connection*>(tag), events[idx].events);
+            }
+        }
+    }
+
+    /**
+     Accept every pending connection. Another worker may have taken them already.
+    */
+    void GameServer::Worker::accept()
+    {
+        for(;;)
+        {
+            int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if(fd < 0)
+                return;
+
+            /* Fails harmlessly on Unix domain sockets */
+            int noDelay = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+            std::unique_ptr<Connection> conn = std::make_unique<Connection>();
+            conn->fd = fd;
+            conn->slot = connections_.size();
+            epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.ptr = conn.get();
+            if(::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) != 0)
+            {
+                ::close(fd);
+                continue;
+            }
+            connections_.push_back(std::move(conn));
+            connections.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     Read what a connection sent, answer every complete frame and write the responses.
+     A connection whose responses can't all be written stops being read until its output drains.
+    */
+    void GameServer::Worker::serve(Connection& conn, uint32_t events)
+    {
+        if(conn.writing)
+        {
+            if((events & (EPOLLERR | EPOLLHUP)) || !flush(conn))
+            {
+                close(conn);
+                return;
+            }
+            if(conn.writing)
+                return;
+            epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.ptr = &conn;
+            ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, conn.fd, &event);
+            return;
+        }
+
+        ssize_t bytes = ::recv(conn.fd, conn.input + conn.inputLength, GS_READ_BYTES - conn.inputLength, 0);
+        if(bytes <= 0)
+        {
+            if(bytes < 0 && (errno == EAGAIN || errno == EINTR))
+                return;
+            close(conn);
+            return;
+        }
+        conn.inputLength += bytes;
+
+        size_t pos = 0;
+        Clock::time_point start = Clock::now();
+        while(conn.inputLength - pos >= PROTO_FRAME_BYTES)
+        {
+            Request request = Protocol::decodeRequest(conn.input + pos);
+            Response response = handle(conn, request);
+            size_t used = conn.output.size();
+            conn.output.resize(used + PROTO_FRAME_BYTES);
+            Protocol::encode(response, conn.output.data() + used);
+            pos += PROTO_FRAME_BYTES;
+
+            Clock::time_point end = Clock::now();
+            latencies[static_cast<size_t>(request.type)].add(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            start = end;
+        }
+        conn.inputLength -= pos;
+        std::memmove(conn.input, conn.input + pos, conn.inputLength);
+
+        if(!flush(conn))
+        {
+            close(conn);
+            return;
+        }
+        if(conn.writing)
+        {
+            epoll_event event = {};
+            event.events = EPOLLOUT;
+            event.data.ptr = &conn;
+            ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, conn.fd, &event);
+        }
+    }
+
+    /**
+     Write as much pending output as the socket takes.
+     @return
+        False if the connection failed.
+    */
+    bool GameServer::Worker::flush(Connection& conn)
+    {
+        while(conn.outputSent < conn.output.size())
+        {
+            ssize_t bytes = ::send(conn.fd, conn.output.data() + conn.outputSent, conn.output.size() - conn.outputSent, MSG_NOSIGNAL);
+            if(bytes < 0)
+            {
+                if(errno == EINTR)
+                    continue;
+                if(errno != EAGAIN)
+                    return false;
+                conn.writing = true;
+                return true;
+            }
+            conn.outputSent += bytes;
+        }
+        conn.output.clear();
+        conn.outputSent = 0;
+        conn.writing = false;
+        return true;
+    }
+
+    /**
+     Close a connection and keep its session for another game.
+    */
+    void GameServer::Worker::close(Connection& conn)
+    {
+        ::close(conn.fd);
+        if(conn.session)
+            sessions_.push_back(std::move(conn.session));
+
+        size_t slot = conn.slot;
+        std::swap(connections_[slot], connections_.back());
+        connections_[slot]->slot = slot;
+        connections_.pop_back();
+    }
+
+    Response GameServer::Worker::handle(Connection& conn, const Request& request)
+    {
+        Response response;
+        response.type = request.type;
+        Session* session = conn.session.get();
+
+        switch(request.type)
+        {
+        case MessageType::MSG_NEW_GAME:
+            return newGame(conn, request);
+
+        case MessageType::MSG_PLACE:
+            if(session && session->phase == GamePhase::PHASE_PLACING)
+                return place(*session, request);
+            break;
+
+        case MessageType::MSG_FIRE:
+            if(session && session->phase == GamePhase::PHASE_PLAYING)
+                return fire(*session, request);
+            break;
+
+        case MessageType::MSG_RESIGN:
+            if(session && session->phase != GamePhase::PHASE_IDLE)
+            {
+                session->phase = GamePhase::PHASE_IDLE;
+                response.status = ReplyStatus::STATUS_LOST;
+                games.fetch_add(1, std::memory_order_relaxed);
+            }
+            break;
+
+        case MessageType::MSG_INVALID:
+            break;
+        }
+        return response;
+    }
+
+    /**
+     Place a fleet at random, retrying with a new seed when the generator runs out of attempts.
+    */
+    void GameServer::Worker::layout(Player& player)
+    {
+        LayoutStatus status;
+        do
+        {
+            generator_.reseed(engine_());
+            status = player.setupBoard(generator_);
+        } while(status == LayoutStatus::LAYOUT_RETRY);
+    }
+
+    /**
+     Start a game, abandoning any game in progress. The server's fleet is always placed at random,
+     the client's too if it asks for PROTO_AUTO_PLACE.
+    */
+    Response GameServer::Worker::newGame(Connection& conn, const Request& request)
+    {
+        if(!conn.session)
+        {
+            if(sessions_.empty())
+            {
+                conn.session = std::make_unique<Session>(config_.length, config_.width);
+                std::unique_ptr<Strategy> strategy = Strategy::create(config_.strategy, config_.length, config_.width);
+                strategy->setFleet(config_.fleet);
+                conn.session->host.setStrategy(std::move(strategy));
+            }
+            else
+            {
+                conn.session = std::move(sessions_.back());
+                sessions_.pop_back();
+            }
+        }
+
+        Session& session = *conn.session;
+        session.host.reset(engine_());
+        session.remote.reset(engine_());
+        layout(session.host);
+
+        std::fill(std::begin(session.unplaced), std::end(session.unplaced), 0);
+        session.remaining = 0;
+        if(request.arg & PROTO_AUTO_PLACE)
+        {
+            layout(session.remote);
+        }
+        else
+        {
+            for(Vessel::VType vtype : config_.fleet)
+                session.unplaced[static_cast<int>(vtype)]++;
+            session.remaining = config_.fleet.size();
+        }
+        session.phase = (session.remaining > 0) ? GamePhase::PHASE_PLACING : GamePhase::PHASE_PLAYING;
+
+        Response response;
+        response.type = MessageType::MSG_NEW_GAME;
+        response.status = ReplyStatus::STATUS_OK;
+        response.result = static_cast<uint8_t>(std::min<size_t>(config_.fleet.size(), UINT8_MAX));
+        response.x = config_.length;
+        response.y = config_.width;
+        return response;
+    }
+
+    /**
+     Place one of the client's vessels. Only vessels of the configured fleet that are still unplaced are accepted.
+    */
+    Response GameServer::Worker::place(Session& session, const Request& request)
+    {
+        Response response;
+        response.type = MessageType::MSG_PLACE;
+        int vtype = request.arg & ~PROTO_VERTICAL;
+        if(vtype >= STAT_VESSEL_TYPES || session.unplaced[vtype] == 0)
+            return response;
+
+        GameBoard::VDirection vdir = (request.arg & PROTO_VERTICAL) ? GameBoard::VDirection::VERTICAL : GameBoard::VDirection::HORIZONTAL;
+        GameBoard::VBorder vrect(request.x, request.y);
+        response.status = ReplyStatus::STATUS_OK;
+        if(session.remote.placeVessel(vrect, static_cast<Vessel::VType>(vtype), vdir))
+        {
+            response.result = 1;
+            session.unplaced[vtype]--;
+            if(--session.remaining == 0)
+                session.phase = GamePhase::PHASE_PLAYING;
+        }
+        return response;
+    }
+
+    /**
+     Apply the client's shot and, unless it won the game, answer with the server player's shot.
+    */
+    Response GameServer::Worker::fire(Session& session, const Request& request)
+    {
+        Response response;
+        response.type = MessageType::MSG_FIRE;
+        response.status = ReplyStatus::STATUS_OK;
+        response.result = static_cast<uint8_t>(session.remote.launchAttack(session.host, request.x, request.y));
+        if(!session.host.hasVessels())
+        {
+            response.status = ReplyStatus::STATUS_WON;
+            session.phase = GamePhase::PHASE_IDLE;
+            games.fetch_add(1, std::memory_order_relaxed);
+            return response;
+        }
+
+        int xCord, yCord;
+        std::tie(xCord, yCord) = session.host.suggestFirePosition();
+        response.reply = static_cast<uint8_t>(session.host.launchAttack(session.remote, xCord, yCord));
+        response.x = static_cast<uint16_t>(xCord);
+        response.y = static_cast<uint16_t>(yCord);
+        if(!session.remote.hasVessels())
+        {
+            response.status = ReplyStatus::STATUS_LOST;
+            session.phase = GamePhase::PHASE_IDLE;
+            games.fetch_add(1, std::memory_order_relaxed);
+        }
+        return response;
+    }
+
+    /**
+     Create a server. The configuration is checked here: an unknown strategy, a board that doesn't fit the
+     protocol's 16-bit coordinates or a fleet that doesn't fit the board will result in an exception.
+    */
+    GameServer::GameServer(const ServerConfig& config)
+        : config_(config), listenFd_(-1), stopFd_(-1), workers_(), threads_()
+    {
+        if(config_.threads <= 0)
+        {
+            Error argError("The server needs at least one thread.", GS_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        if(config_.length > GS_MAX_COORDINATE || config_.width > GS_MAX_COORDINATE)
+        {
+            Error argError("Board is too large for the protocol.", GS_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        if(config_.fleet.empty())
+            config_.fleet = defaultFleet();
+
+        Strategy::create(config_.strategy, config_.length, config_.width);
+        std::vector<VesselPlacement> layout;
+        PlacementGenerator generator(config_.fleet, config_.length, config_.width);
+        if(generator.generate(layout) == LayoutStatus::LAYOUT_FAILED)
+        {
+            Error argError("The fleet does not fit on the board.", GS_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+    }
+
+    GameServer::~GameServer()
+    {
+        stop();
+    }
+
+    /**
+     Listen on an address and start the worker threads. Returns once the server accepts connections.
+     @param address
+        unix:PATH or tcp:PORT, see Protocol::listen().
+    */
+    void GameServer::start(const std::string& address)
+    {
+        if(listenFd_ >= 0)
+        {
+            Error argError("The server is already running.", GS_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+
+        workers_.clear();
+        listenFd_ = Protocol::listen(address, config_.backlog);
+        stopFd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        try
+        {
+            if(stopFd_ < 0)
+            {
+                Error ioError(std::string("Unable to create eventfd: ") + std::strerror(errno), GS_IO_ERROR, __FILE__, __LINE__);
+                throw ioError;
+            }
+            for(int idx = 0; idx < config_.threads; idx++)
+                workers_.push_back(std::make_unique<Worker>(config_, listenFd_, stopFd_, config_.seed + idx));
+        }
+        catch(...)
+        {
+            workers_.clear();
+            stop();
+            throw;
+        }
+
+        for(auto& worker : workers_)
+            threads_.emplace_back(&Worker::run, worker.get());
+    }
+
+    /**
+     Stop the workers and close every connection. Statistics stay available until the server is started again.
+    */
+    void GameServer::stop()
+    {
+        if(stopFd_ >= 0)
+        {
+            uint64_t one = 1;
+            ssize_t written = ::write(stopFd_, &one, sizeof(one));
+            (void)written;
+        }
+        for(auto& thread : threads_)
+            thread.join();
+        threads_.clear();
+
+        if(stopFd_ >= 0)
+            ::close(stopFd_);
+        if(listenFd_ >= 0)
+            ::close(listenFd_);
+        stopFd_ = -1;
+        listenFd_ = -1;
+    }
+
+    /**
+     @return
+        The address the server listens on, with the port filled in if tcp:0 was given.
+    */
+    std::string GameServer::address() const
+    {
+        return listenFd_ >= 0 ? Protocol::localAddress(listenFd_) : std::string();
+    }
+
+    /**
+     @return
+        The number of connections accepted.
+    */
+    long long GameServer::connections() const
+    {
+        long long total = 0;
+        for(auto& worker : workers_)
+            total += worker->connections.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    /**
+     @return
+        The number of games won, lost or resigned.
+    */
+    long long GameServer::games() const
+    {
+        long long total = 0;
+        for(auto& worker : workers_)
+            total += worker->games.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    /**
+     The processing latency of requests by message type, from decoding a frame to encoding its response.
+     Only call once the server is stopped.
+    */
+    LatencyTable GameServer::latencies() const
+    {
+        LatencyTable result;
+        for(auto& worker : workers_)
+        {
+            for(size_t type = 0; type < result.size(); type++)
+                result[type].merge(worker->latencies[type]);
+        }
+        return result;
+    }
+
+    /**
+     Connect to a server.
+     @param address
+        unix:PATH or tcp:PORT
+    */
+    GameClient::GameClient(const std::string& address)
+        : fd_(Protocol::connect(address))
+    {
+    }
+
+    GameClient::~GameClient()
+    {
+        ::close(fd_);
+    }
+
+    /**
+     Send a request without waiting for its response.
+    */
+    void GameClient::submit(const Request& request)
+    {
+        uint8_t frame[PROTO_FRAME_BYTES];
+        Protocol::encode(request, frame);
+        size_t sent = 0;
+        while(sent < PROTO_FRAME_BYTES)
+        {
+            ssize_t bytes = ::send(fd_, frame + sent, PROTO_FRAME_BYTES - sent, MSG_NOSIGNAL);
+            if(bytes < 0)
+            {
+                if(errno == EINTR)
+                    continue;
+                Error ioError(std::string("Unable to send request: ") + std::strerror(errno), GS_IO_ERROR, __FILE__, __LINE__);
+                throw ioError;
+            }
+            sent += bytes;
+        }
+    }
+
+    /**
+     Wait for the response to the oldest request not answered yet.
+    */
+    Response GameClient::receive()
+    {
+        uint8_t frame[PROTO_FRAME_BYTES];
+        size_t received = 0;
+        while(received < PROTO_FRAME_BYTES)
+        {
+            ssize_t bytes = ::recv(fd_, frame + received, PROTO_FRAME_BYTES - received, 0);
+            if(bytes < 0 && errno == EINTR)
+                continue;
+            if(bytes <= 0)
+            {
+                Error ioError(bytes == 0 ? std::string("Connection closed by the server.")
+                    : std::string("Unable to receive response: ") + std::strerror(errno), GS_IO_ERROR, __FILE__, __LINE__);
+                throw ioError;
+            }
+            received += bytes;
+        }
+        return Protocol::decodeResponse(frame);
+    }
+
+    /**
+     Send a request and wait for its response.
+    */
+    Response GameClient::call(const Request& request)
+    {
+        submit(request);
+        return receive();
+    }
+}
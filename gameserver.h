@@ -0,0 +1,88 @@
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "player.h"
+#include "protocol.h"
+
+#define GS_BACKLOG 1024
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     @struct ServerConfig
+     Settings for a game server. Declaration shows default field values.
+    */
+    struct ServerConfig
+    {
+        int threads = 1;                    /**< Event loop threads, one per core */
+        uint64_t seed = 0;
+        int length = GB_BOARD_SIZE;
+        int width = GB_BOARD_SIZE;
+        std::vector<Vessel::VType> fleet;   /**< Fleet of both players, the standard fleet if empty */
+        std::string strategy = "random";    /**< Strategy of the server's player */
+        int backlog = GS_BACKLOG;
+    };
+
+    /**
+     Hosts games between remote clients and a server side Player over the frames described in protocol.h.
+     Every connection plays one game at a time. Each worker thread runs its own epoll loop over the connections
+     it accepted from the shared listening socket and never blocks or takes a lock, so a handful of threads
+     serve thousands of concurrent games. Per request processing latency is recorded by message type.
+    */
+    class GameServer
+    {
+    public:
+        GameServer(const ServerConfig& config);
+        GameServer(const GameServer& other) = delete;
+        GameServer& operator =(const GameServer& other) = delete;
+        ~GameServer();
+
+        void start(const std::string& address);
+        void stop();
+        std::string address() const;
+
+        long long connections() const;
+        long long games() const;
+        LatencyTable latencies() const;
+
+    private:
+        class Worker;
+
+    private:
+        ServerConfig config_;
+        int listenFd_;
+        int stopFd_;                                    /**< eventfd that wakes every worker to shut down */
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::vector<std::thread> threads_;
+    };
+
+    /**
+     A blocking client connection to a GameServer. Requests may be pipelined with submit() and receive(),
+     responses arrive in request order.
+    */
+    class GameClient
+    {
+    public:
+        GameClient(const std::string& address);
+        GameClient(const GameClient& other) = delete;
+        GameClient& operator =(const GameClient& other) = delete;
+        ~GameClient();
+
+        void submit(const Request& request);
+        Response receive();
+        Response call(const Request& request);
+
+    private:
+        int fd_;
+    };
+}
+
+#endif
@@ -0,0 +1,151 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include "error.h"
+#include "gameserver.h"
+#include "protocol.h"
+
+/**
+ Play a game with the server placing both fleets and the client scanning the board row by row.
+ @return
+    The final status, STATUS_WON or STATUS_LOST.
+*/
+static Cylink::ReplyStatus playGame(Cylink::GameClient& client)
+{
+    Cylink::Request request;
+    request.type = Cylink::MessageType::MSG_NEW_GAME;
+    request.arg = PROTO_AUTO_PLACE;
+    Cylink::Response response = client.call(request);
+    REQUIRE(response.status == Cylink::ReplyStatus::STATUS_OK);
+
+    const int length = response.x, width = response.y;
+    request.type = Cylink::MessageType::MSG_FIRE;
+    for(int shot = 0; shot < length * width; shot++)
+    {
+        request.x = shot / width;
+        request.y = shot % width;
+        response = client.call(request);
+        REQUIRE(response.type == Cylink::MessageType::MSG_FIRE);
+        if(response.status != Cylink::ReplyStatus::STATUS_OK)
+            return response.status;
+    }
+    return response.status;
+}
+
+TEST_CASE ("Testing GameServer", "[GameServer]")
+{
+    SECTION("Frames round trip")
+    {
+        std::cout<<"Testing protocol frames"<<std::endl;
+        uint8_t frame[PROTO_FRAME_BYTES];
+        Cylink::Request request;
+        request.type = Cylink::MessageType::MSG_PLACE;
+        request.arg = PROTO_VERTICAL | 3;
+        request.x = 513;
+        request.y = 65535;
+        Cylink::Protocol::encode(request, frame);
+        Cylink::Request decoded = Cylink::Protocol::decodeRequest(frame);
+        CHECK(decoded.type == request.type);
+        CHECK(decoded.arg == request.arg);
+        CHECK(decoded.x == request.x);
+        CHECK(decoded.y == request.y);
+
+        frame[0] = 200;
+        CHECK(Cylink::Protocol::decodeRequest(frame).type == Cylink::MessageType::MSG_INVALID);
+        CHECK_THROWS_AS(Cylink::Protocol::connect("udp:1"), Cylink::Error);
+    }
+
+    SECTION("Games over a Unix domain socket")
+    {
+        std::cout<<"Testing game server over a Unix domain socket"<<std::endl;
+        char dir[] = "/tmp/highseas_testXXXXXX";
+        REQUIRE(mkdtemp(dir) != nullptr);
+        std::string path = std::string(dir) + "/server.sock";
+
+        Cylink::ServerConfig config;
+        config.threads = 2;
+        config.strategy = "scan";
+        Cylink::GameServer server(config);
+        server.start("unix:" + path);
+        {
+            Cylink::GameClient client(server.address());
+
+            /* Shots before a game or before the fleet is placed are rejected */
+            Cylink::Request fire;
+            fire.type = Cylink::MessageType::MSG_FIRE;
+            CHECK(client.call(fire).status == Cylink::ReplyStatus::STATUS_REJECTED);
+
+            Cylink::Request request;
+            request.type = Cylink::MessageType::MSG_NEW_GAME;
+            Cylink::Response response = client.call(request);
+            CHECK(response.status == Cylink::ReplyStatus::STATUS_OK);
+            CHECK(response.x == GB_BOARD_SIZE);
+            CHECK(response.result == 11);
+            CHECK(client.call(fire).status == Cylink::ReplyStatus::STATUS_REJECTED);
+
+            /* A carrier fits once, a gunboat isn't in the standard fleet */
+            Cylink::Request place;
+            place.type = Cylink::MessageType::MSG_PLACE;
+            place.arg = static_cast<uint8_t>(Cylink::Vessel::VType::CARRIER);
+            CHECK(client.call(place).result == 1);
+            CHECK(client.call(place).status == Cylink::ReplyStatus::STATUS_REJECTED);
+            place.arg = static_cast<uint8_t>(Cylink::Vessel::VType::GUNBOAT);
+            CHECK(client.call(place).status == Cylink::ReplyStatus::STATUS_REJECTED);
+
+            /* Placing over the carrier fails without giving up the vessel */
+            place.arg = static_cast<uint8_t>(Cylink::Vessel::VType::CRUISER) | PROTO_VERTICAL;
+            response = client.call(place);
+            CHECK(response.status == Cylink::ReplyStatus::STATUS_OK);
+            CHECK(response.result == 0);
+
+            request.type = Cylink::MessageType::MSG_RESIGN;
+            CHECK(client.call(request).status == Cylink::ReplyStatus::STATUS_LOST);
+
+            /* Pipelined requests are answered in order */
+            Cylink::Request invalid;
+            client.submit(invalid);
+            client.submit(fire);
+            CHECK(client.receive().type == Cylink::MessageType::MSG_INVALID);
+            CHECK(client.receive().type == Cylink::MessageType::MSG_FIRE);
+
+            Cylink::ReplyStatus status = playGame(client);
+            CHECK((status == Cylink::ReplyStatus::STATUS_WON || status == Cylink::ReplyStatus::STATUS_LOST));
+        }
+        server.stop();
+
+        CHECK(server.connections() == 1);
+        CHECK(server.games() == 2);
+        Cylink::LatencyTable latencies = server.latencies();
+        CHECK(latencies[static_cast<size_t>(Cylink::MessageType::MSG_NEW_GAME)].count() == 2);
+        CHECK(latencies[static_cast<size_t>(Cylink::MessageType::MSG_PLACE)].count() == 4);
+        CHECK(latencies[static_cast<size_t>(Cylink::MessageType::MSG_FIRE)].count() > 2);
+        unlink(path.c_str());
+        rmdir(dir);
+    }
+
+    SECTION("Concurrent games over loopback TCP")
+    {
+        std::cout<<"Testing game server over TCP"<<std::endl;
+        Cylink::ServerConfig config;
+        Cylink::GameServer server(config);
+        server.start("tcp:0");
+        REQUIRE(server.address() != "tcp:0");
+
+        const int clients = 8;
+        {
+            std::vector<std::unique_ptr<Cylink::GameClient>> connections;
+            for(int idx = 0; idx < clients; idx++)
+                connections.push_back(std::make_unique<Cylink::GameClient>(server.address()));
+            for(auto& client : connections)
+                playGame(*client);
+        }
+        server.stop();
+        CHECK(server.connections() == clients);
+        CHECK(server.games() == clients);
+
+        Cylink::ServerConfig tooLarge;
+        tooLarge.length = 70000;
+        CHECK_THROWS_AS(Cylink::GameServer(tooLarge), Cylink::Error);
+    }
+}
@@ -0,0 +1,147 @@
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "instrument.h"
+
+namespace Cylink
+{
+    thread_local CounterBlock* Instrument::threadBlock_ = nullptr;
+
+    /* Blocks live until the process exits so counts from finished threads are kept */
+    static std::mutex registryLock;
+    static std::vector<std::unique_ptr<CounterBlock>> registry;
+
+    /**
+     Allocate and register a counter block for the calling thread.
+     This takes a lock but happens once per thread, outside the hot path.
+    */
+    CounterBlock& Instrument::registerThread()
+    {
+        std::lock_guard<std::mutex> guard(registryLock);
+        registry.emplace_back(new CounterBlock());
+        threadBlock_ = registry.back().get();
+        return *threadBlock_;
+    }
+
+    /**
+     Sum the counters of every registered thread.
+     Counters are read without synchronisation, so call this after the recording threads have been joined.
+     @return
+        The summed counters.
+    */
+    InstrumentReport Instrument::report()
+    {
+        InstrumentReport result;
+#ifdef HIGHSEAS_INSTRUMENT
+        result.enabled = true;
+#endif
+        std::lock_guard<std::mutex> guard(registryLock);
+        result.threads = registry.size();
+        for(auto& block : registry)
+        {
+            for(int idx = 0; idx < static_cast<int>(Counter::COUNTER_TOTAL); idx++)
+            {
+                result.totals.counts[idx] += block->counts[idx];
+                result.totals.cycles[idx] += block->cycles[idx];
+                result.totals.samples[idx] += block->samples[idx];
+            }
+        }
+        return result;
+    }
+
+    /**
+     Zero the counters of every registered thread. Call only while no thread is recording.
+    */
+    void Instrument::reset()
+    {
+        std::lock_guard<std::mutex> guard(registryLock);
+        for(auto& block : registry)
+        {
+            *block = CounterBlock();
+        }
+    }
+
+    /**
+     @return
+        The name used for the counter in reports.
+    */
+    const char* Instrument::name(Counter counter)
+    {
+        switch(counter)
+        {
+        case Counter::ADD_VESSEL:
+            return "add_vessel";
+        case Counter::FIND_OPEN_POSITION:
+            return "find_open_position";
+        case Counter::OPEN_POSITION_REJECT:
+            return "open_position_reject";
+        case Counter::LAYOUT_RESTART:
+            return "layout_restart";
+        case Counter::RECEIVED_ATTACK:
+            return "received_attack";
+        case Counter::SUGGEST_FIRE:
+            return "suggest_fire";
+        case Counter::GAME_OVER_CHECK:
+            return "game_over_check";
+        case Counter::COUNTER_TOTAL:
+            break;
+        }
+        return "";
+    }
+
+    /**
+     Scale the cycles of the sampled calls up to every call.
+     @return
+        The estimated total cycles spent in the counter's timed scope, or zero if it isn't timed.
+    */
+    double InstrumentReport::estimatedCycles(Counter counter) const
+    {
+        int idx = static_cast<int>(counter);
+        if(totals.samples[idx] == 0)
+            return 0.0;
+        return static_cast<double>(totals.cycles[idx]) * totals.counts[idx] / totals.samples[idx];
+    }
+
+    /**
+     Write the report as a single JSON object.
+    */
+    void InstrumentReport::writeJson(std::ostream& os) const
+    {
+        os<<"{\"enabled\":"<<(enabled ? "true" : "false")<<",\"threads\":"<<threads
+          <<",\"sample_shift\":"<<HS_SAMPLE_SHIFT<<",\"events\":{";
+        for(int idx = 0; idx < static_cast<int>(Counter::COUNTER_TOTAL); idx++)
+        {
+            Counter counter = static_cast<Counter>(idx);
+            double cycles = estimatedCycles(counter);
+            os<<(idx > 0 ? "," : "")<<"\""<<Instrument::name(counter)<<"\":{\"calls\":"<<totals.counts[idx]
+              <<",\"sampled\":"<<totals.samples[idx]<<",\"cycles\":"<<static_cast<uint64_t>(cycles)
+              <<",\"cycles_per_call\":"<<(totals.counts[idx] > 0 ? cycles / totals.counts[idx] : 0.0)<<"}";
+        }
+        os<<"}}\n";
+    }
+
+    /**
+     Write the report in the Prometheus text exposition format.
+    */
+    void InstrumentReport::writePrometheus(std::ostream& os) const
+    {
+        os<<"# HELP highseas_instrument_enabled Whether instrumentation was compiled in.\n"
+          <<"# TYPE highseas_instrument_enabled gauge\n"
+          <<"highseas_instrument_enabled "<<(enabled ? 1 : 0)<<"\n"
+          <<"# HELP highseas_calls_total Instrumented calls by event.\n"
+          <<"# TYPE highseas_calls_total counter\n";
+        for(int idx = 0; idx < static_cast<int>(Counter::COUNTER_TOTAL); idx++)
+        {
+            os<<"highseas_calls_total{event=\""<<Instrument::name(static_cast<Counter>(idx))<<"\"} "<<totals.counts[idx]<<"\n";
+        }
+        os<<"# HELP highseas_cycles_total Estimated cycles spent by event, scaled from sampled calls.\n"
+          <<"# TYPE highseas_cycles_total counter\n";
+        for(int idx = 0; idx < static_cast<int>(Counter::COUNTER_TOTAL); idx++)
+        {
+            Counter counter = static_cast<Counter>(idx);
+            if(totals.samples[idx] > 0)
+                os<<"highseas_cycles_total{event=\""<<Instrument::name(counter)<<"\"} "<<static_cast<uint64_t>(estimatedCycles(counter))<<"\n";
+        }
+    }
+}
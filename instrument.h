@@ -0,0 +1,154 @@
+/**
+ * @file instrument.h
+ * Low overhead per-thread counters and cycle timers for the simulation hot paths.
+ * Instrumentation is compiled in only when HIGHSEAS_INSTRUMENT is defined; otherwise the
+ * HS_COUNT and HS_TIME macros expand to nothing and the reports contain zeros.
+ */
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <cstdint>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+/* Time one call in 2^HS_SAMPLE_SHIFT. Every call is counted. */
+#ifndef HS_SAMPLE_SHIFT
+#define HS_SAMPLE_SHIFT 6
+#endif
+
+#ifdef HIGHSEAS_INSTRUMENT
+#define HS_CONCAT_(a, b) a##b
+#define HS_CONCAT(a, b) HS_CONCAT_(a, b)
+#define HS_COUNT(counter) (Cylink::Instrument::local().counts[static_cast<int>(Cylink::Counter::counter)]++)
+#define HS_TIME(counter) Cylink::ScopedTimer HS_CONCAT(hsTimer, __LINE__)(Cylink::Counter::counter)
+#else
+#define HS_COUNT(counter) ((void)0)
+#define HS_TIME(counter) ((void)0)
+#endif
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     @enum Counter
+     The instrumented events. Timed events also count their calls.
+    */
+    enum class Counter
+    {
+        ADD_VESSEL,             //GameBoard::addVessel() calls
+        FIND_OPEN_POSITION,     //GameBoard::findOpenPosition() calls
+        OPEN_POSITION_REJECT,   //Positions findOpenPosition() probed and rejected
+        LAYOUT_RESTART,         //PlacementGenerator attempts that hit a dead end or overlap
+        RECEIVED_ATTACK,        //GameBoard::logReceivedAttack() calls and salvo shots received
+        SUGGEST_FIRE,           //Player::suggestFirePosition() calls
+        GAME_OVER_CHECK,        //Checks for a defeated player after each shot
+        COUNTER_TOTAL
+    };
+
+    /**
+     @struct CounterBlock
+     The counters owned by a single thread. Only the owning thread writes to a block,
+     so no atomics are needed; blocks are aligned so two threads never share a cache line.
+    */
+    struct alignas(64) CounterBlock
+    {
+        uint64_t counts[static_cast<int>(Counter::COUNTER_TOTAL)] = {};
+        uint64_t cycles[static_cast<int>(Counter::COUNTER_TOTAL)] = {};    /**< Cycles of the sampled calls */
+        uint64_t samples[static_cast<int>(Counter::COUNTER_TOTAL)] = {};   /**< Number of sampled calls */
+    };
+
+    /**
+     @struct InstrumentReport
+     Counters summed across every thread that recorded any.
+    */
+    struct InstrumentReport
+    {
+        bool enabled = false;
+        int threads = 0;
+        CounterBlock totals;
+
+        double estimatedCycles(Counter counter) const;
+        void writeJson(std::ostream& os) const;
+        void writePrometheus(std::ostream& os) const;
+    };
+
+    /**
+     Access to the per-thread counter blocks.
+    */
+    class Instrument
+    {
+    public:
+        static CounterBlock& local();
+        static InstrumentReport report();
+        static void reset();
+        static const char* name(Counter counter);
+
+        /**
+         Read the processor's cycle counter, or a nanosecond clock where there is none.
+        */
+        static inline uint64_t cycles()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+        }
+
+    private:
+        static CounterBlock& registerThread();
+
+    private:
+        static thread_local CounterBlock* threadBlock_;    /**< The calling thread's block once registered */
+    };
+
+    /**
+     Obtain the calling thread's counter block, registering it on first use.
+    */
+    inline CounterBlock& Instrument::local()
+    {
+        CounterBlock* block = threadBlock_;
+        return (block != nullptr) ? *block : registerThread();
+    }
+
+    /**
+     Counts a call and, for one call in 2^HS_SAMPLE_SHIFT, measures the cycles spent in the enclosing scope.
+    */
+    class ScopedTimer
+    {
+    public:
+        inline ScopedTimer(Counter counter)
+            : block_(Instrument::local()), index_(static_cast<int>(counter)), start_(0)
+        {
+            if((block_.counts[index_]++ & ((uint64_t(1) << HS_SAMPLE_SHIFT) - 1)) == 0)
+                start_ = Instrument::cycles();
+        }
+
+        inline ~ScopedTimer()
+        {
+            if(start_ != 0)
+            {
+                block_.cycles[index_] += Instrument::cycles() - start_;
+                block_.samples[index_]++;
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator =(const ScopedTimer&) = delete;
+
+    private:
+        CounterBlock& block_;
+        int index_;
+        uint64_t start_;
+    };
+}
+
+#endif
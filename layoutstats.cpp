@@ -0,0 +1,459 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <thread>
+#include <tuple>
+
+#include "layoutstats.h"
+#include "error.h"
+
+#define LS_ARG_ERROR ErrorCode::ERR_INVALID_ARG
+#define LS_DIRECTIONS 2
+#define LS_SEED_STRIDE 0x9E3779B97F4A7C15ULL
+
+namespace Cylink
+{
+    /**
+     Determine the footprint of a vessel in a given direction, consistent with GameBoard::border().
+    */
+    static void footprint(Vessel::VType vtype, GameBoard::VDirection vdir, int& height, int& span)
+    {
+        int vesselLength, vesselWidth;
+        std::tie(vesselLength, vesselWidth) = Vessel::vesselDimensions(vtype);
+        height = (vdir == GameBoard::VDirection::HORIZONTAL) ? vesselWidth : vesselLength;
+        span = (vdir == GameBoard::VDirection::HORIZONTAL) ? vesselLength : vesselWidth;
+    }
+
+    /**
+     Determine whether a vessel looks the same in both directions, in which case only HORIZONTAL is counted.
+    */
+    static bool isSquare(Vessel::VType vtype)
+    {
+        std::pair<int, int> dims = Vessel::vesselDimensions(vtype);
+        return dims.first == dims.second;
+    }
+
+    /**
+     Approximate a chi-square statistic as a standard normal deviate using the Wilson-Hilferty transform.
+    */
+    static double wilsonHilferty(double chiSquare, int dof)
+    {
+        if(dof <= 0)
+            return 0.0;
+        double h = 2.0 / (9.0 * dof);
+        return (std::cbrt(chiSquare / dof) - (1.0 - h)) / std::sqrt(h);
+    }
+
+    /**
+     Create zeroed counts for a board of the given size.
+    */
+    OccupancyCounts::OccupancyCounts(int len, int wid)
+        : length(len), width(wid), layouts(0),
+          cells(static_cast<size_t>(len) * wid, 0),
+          anchors(static_cast<size_t>(LS_VESSEL_TYPES) * LS_DIRECTIONS * len * wid, 0)
+    {
+    }
+
+    /**
+     Count a single placed vessel. The caller is responsible for incrementing the layout count.
+     @param placement
+        The vessel's position. The border must have both corners set.
+     @param weight
+        The number of layouts the placement occurs in.
+    */
+    void OccupancyCounts::addPlacement(const VesselPlacement& placement, long long weight)
+    {
+        for(int x = placement.border.topX; x < placement.border.lowX; x++)
+        {
+            for(int y = placement.border.topY; y < placement.border.lowY; y++)
+            {
+                cells[x * width + y] += weight;
+            }
+        }
+        anchors[anchorIndex(placement.vtype, placement.direction, placement.border.topX, placement.border.topY)] += weight;
+    }
+
+    /**
+     Add the counts from another set of counts for the same board size.
+    */
+    void OccupancyCounts::merge(const OccupancyCounts& other)
+    {
+        if(other.length != length || other.width != width)
+        {
+            Error argError("Occupancy counts are for different board sizes.", LS_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+
+        layouts += other.layouts;
+        for(size_t idx = 0; idx < cells.size(); idx++)
+            cells[idx] += other.cells[idx];
+        for(size_t idx = 0; idx < anchors.size(); idx++)
+            anchors[idx] += other.anchors[idx];
+    }
+
+    /**
+     Obtain the index into anchors for a vessel type, direction and top left corner.
+    */
+    int OccupancyCounts::anchorIndex(Vessel::VType vtype, GameBoard::VDirection vdir, int x, int y) const
+    {
+        int dirIdx = (vdir == GameBoard::VDirection::VERTICAL && !isSquare(vtype)) ? 1 : 0;
+        return ((static_cast<int>(vtype) * LS_DIRECTIONS + dirIdx) * length + x) * width + y;
+    }
+
+    /**
+     Depth first enumeration of every valid layout of the fleet from the given slot onwards.
+     Each candidate position is credited with the number of complete layouts that extend it.
+     @return
+        The number of complete layouts below the current node.
+    */
+    static long long enumerateLayouts(const std::vector<Vessel::VType>& fleet, size_t slot, BitBoard& occupied,
+        OccupancyCounts& counts, long long& leaves, long long maxLayouts)
+    {
+        if(slot == fleet.size())
+        {
+            leaves++;
+            return 1;
+        }
+
+        long long total = 0;
+        Vessel::VType vtype = fleet[slot];
+        int dirCount = isSquare(vtype) ? 1 : LS_DIRECTIONS;
+        for(int dirIdx = 0; dirIdx < dirCount && leaves <= maxLayouts; dirIdx++)
+        {
+            VesselPlacement placement;
+            placement.vtype = vtype;
+            placement.direction = (dirIdx == 0) ? GameBoard::VDirection::HORIZONTAL : GameBoard::VDirection::VERTICAL;
+            int height, span;
+            footprint(vtype, placement.direction, height, span);
+
+            for(int x = 0; x + height <= counts.length; x++)
+            {
+                for(int y = 0; y + span <= counts.width; y++)
+                {
+                    if(occupied.anyInRect(x, y, x + height, y + span))
+                        continue;
+
+                    occupied.setRect(x, y, x + height, y + span);
+                    long long below = enumerateLayouts(fleet, slot + 1, occupied, counts, leaves, maxLayouts);
+                    occupied.resetRect(x, y, x + height, y + span);
+
+                    if(below > 0)
+                    {
+                        placement.border = GameBoard::VBorder(x, y, x + height, y + span);
+                        counts.addPlacement(placement, below);
+                        total += below;
+                    }
+                }
+            }
+        }
+        return total;
+    }
+
+    /**
+     Compute the exact occupancy counts over every valid layout of the fleet by exhaustive enumeration.
+     The enumeration is split across threads by the position of the first vessel.
+     Fleet slots are labelled, so fleets with repeated vessel types count each unlabelled layout several times.
+     This scales every count by the same factor and leaves the distribution unchanged.
+     @param fleet
+        The fleet to enumerate. Large or dense fleets quickly become too expensive to enumerate.
+     @param threads
+        The number of worker threads.
+     @param result
+        Receives the counts. Its board size selects the board to enumerate.
+     @param maxLayouts
+        The enumeration is abandoned once a thread has counted this many layouts.
+     @return
+        True if the enumeration completed.
+    */
+    bool exactOccupancy(const std::vector<Vessel::VType>& fleet, int threads, OccupancyCounts& result, long long maxLayouts)
+    {
+        if(fleet.empty())
+        {
+            Error argError("The fleet may not be empty.", LS_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        threads = std::max(1, threads);
+
+        /* Enumerate starting positions of the first vessel so they can be dealt out to the threads */
+        std::vector<VesselPlacement> starts;
+        Vessel::VType first = fleet[0];
+        int dirCount = isSquare(first) ? 1 : LS_DIRECTIONS;
+        for(int dirIdx = 0; dirIdx < dirCount; dirIdx++)
+        {
+            VesselPlacement placement;
+            placement.vtype = first;
+            placement.direction = (dirIdx == 0) ? GameBoard::VDirection::HORIZONTAL : GameBoard::VDirection::VERTICAL;
+            int height, span;
+            footprint(first, placement.direction, height, span);
+            for(int x = 0; x + height <= result.length; x++)
+            {
+                for(int y = 0; y + span <= result.width; y++)
+                {
+                    placement.border = GameBoard::VBorder(x, y, x + height, y + span);
+                    starts.push_back(placement);
+                }
+            }
+        }
+
+        std::vector<OccupancyCounts> partial(threads, OccupancyCounts(result.length, result.width));
+        std::vector<long long> leaves(threads, 0);
+        std::vector<std::thread> workers;
+        for(int tid = 0; tid < threads; tid++)
+        {
+            workers.emplace_back([&, tid]()
+            {
+                BitBoard occupied(result.length, result.width);
+                for(size_t idx = tid; idx < starts.size() && leaves[tid] <= maxLayouts; idx += threads)
+                {
+                    const GameBoard::VBorder& b = starts[idx].border;
+                    occupied.setRect(b.topX, b.topY, b.lowX, b.lowY);
+                    long long below = enumerateLayouts(fleet, 1, occupied, partial[tid], leaves[tid], maxLayouts);
+                    occupied.resetRect(b.topX, b.topY, b.lowX, b.lowY);
+
+                    if(below > 0)
+                        partial[tid].addPlacement(starts[idx], below);
+                    partial[tid].layouts += below;
+                }
+            });
+        }
+        for(auto& worker : workers)
+            worker.join();
+
+        bool complete = true;
+        for(int tid = 0; tid < threads; tid++)
+        {
+            if(leaves[tid] > maxLayouts)
+                complete = false;
+            result.merge(partial[tid]);
+        }
+        return complete;
+    }
+
+    /**
+     Read the vessel positions back from a game board populated by GameBoard::addVessel().
+    */
+    static void countBoard(const GameBoard& board, OccupancyCounts& counts, std::vector<bool>& seen)
+    {
+        seen.assign(board.vesselCount(), false);
+        for(int x = 0; x < counts.length; x++)
+        {
+            for(int y = 0; y < counts.width; y++)
+            {
+                const GameBoard::BoardData& cell = board.cellAt(x, y);
+                if(cell.vesselId == GB_NO_VESSEL)
+                    continue;
+
+                counts.cells[x * counts.width + y]++;
+
+                /* The first cell of a vessel in row major order is its top left corner */
+                if(!seen[cell.vesselId])
+                {
+                    seen[cell.vesselId] = true;
+                    Vessel::VType vtype = board.getVessel(cell.vesselId).getType();
+                    counts.anchors[counts.anchorIndex(vtype, cell.direction, x, y)]++;
+                }
+            }
+        }
+        counts.layouts++;
+    }
+
+    /**
+     Generate layouts with one of the available samplers and count their occupancy.
+     Each thread owns its sampler, seeded from the base seed and the thread. SAMPLER_ADDVESSEL seeds the
+     thread's GameBoard random stream instead.
+     @param fleet
+        The fleet to place.
+     @param sampler
+        The sampling method to measure.
+     @param layouts
+        The number of complete layouts to count. Incomplete layouts are discarded.
+     @param threads
+        The number of worker threads.
+     @param seed
+        The base seed for the samplers.
+     @param result
+        Receives the counts. Its board size selects the board to place vessels on.
+     @return
+        False if the fleet can't be placed on the board.
+    */
+    bool sampleOccupancy(const std::vector<Vessel::VType>& fleet, LayoutSampler sampler, long long layouts, int threads,
+        uint64_t seed, OccupancyCounts& result)
+    {
+        threads = std::max(1, threads);
+        std::vector<OccupancyCounts> partial(threads, OccupancyCounts(result.length, result.width));
+        std::vector<bool> failed(threads, false);
+        std::vector<std::thread> workers;
+
+        for(int tid = 0; tid < threads; tid++)
+        {
+            long long share = layouts / threads + ((tid < layouts % threads) ? 1 : 0);
+            workers.emplace_back([&, tid, share]()
+            {
+                OccupancyCounts& counts = partial[tid];
+                uint64_t threadSeed = seed + (tid + 1) * LS_SEED_STRIDE;
+                if(sampler == LayoutSampler::SAMPLER_ADDVESSEL)
+                {
+                    GameBoard::seedRandom(threadSeed);
+                    std::vector<bool> seen;
+                    int misses = 0;
+                    while(counts.layouts < share)
+                    {
+                        GameBoard board(counts.length, counts.width);
+                        bool complete = true;
+                        for(auto vtype : fleet)
+                            complete = complete && board.addVessel(vtype);
+
+                        if(complete)
+                            countBoard(board, counts, seen);
+                        else if(++misses > PG_MAX_ATTEMPTS && counts.layouts == 0)
+                        {
+                            failed[tid] = true;
+                            return;
+                        }
+                    }
+                    return;
+                }
+
+                LayoutMode mode = LayoutMode::LAYOUT_UNIFORM;
+                if(sampler == LayoutSampler::SAMPLER_EXACT)
+                    mode = LayoutMode::LAYOUT_EXACT;
+                else if(sampler == LayoutSampler::SAMPLER_SEQUENTIAL)
+                    mode = LayoutMode::LAYOUT_SEQUENTIAL;
+                PlacementGenerator generator(fleet, counts.length, counts.width, threadSeed, mode);
+                std::vector<VesselPlacement> layout;
+                while(counts.layouts < share)
+                {
+                    LayoutStatus status = generator.generate(layout);
+                    if(status == LayoutStatus::LAYOUT_FAILED)
+                    {
+                        failed[tid] = true;
+                        return;
+                    }
+                    if(status == LayoutStatus::LAYOUT_RETRY)
+                    {
+                        generator.reseed(++threadSeed);
+                        continue;
+                    }
+                    for(auto& placement : layout)
+                        counts.addPlacement(placement);
+                    counts.layouts++;
+                }
+            });
+        }
+        for(auto& worker : workers)
+            worker.join();
+
+        for(int tid = 0; tid < threads; tid++)
+        {
+            if(failed[tid])
+                return false;
+            result.merge(partial[tid]);
+        }
+        return true;
+    }
+
+    /**
+     Compare sampled occupancy against the exact distribution.
+     Per-cell occupancy is tested as a binomial per cell. The cells of a layout are not independent, so the
+     summed statistic is a deviation measure rather than a true chi-square; the largest per-cell z-score is
+     reported as well. Anchors of a vessel type that occurs once in the fleet form a multinomial and their
+     chi-square is exact; repeated types are approximate for the same reason as cells.
+     @param observed
+        The sampled counts.
+     @param expected
+        The exact counts from exactOccupancy().
+     @return
+        The deviation report.
+    */
+    BiasReport compareOccupancy(const OccupancyCounts& observed, const OccupancyCounts& expected)
+    {
+        if(observed.length != expected.length || observed.width != expected.width || expected.layouts == 0)
+        {
+            Error argError("Occupancy counts can't be compared.", LS_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+
+        BiasReport report;
+        const double samples = static_cast<double>(observed.layouts);
+        report.layouts = observed.layouts;
+
+        for(size_t idx = 0; idx < expected.cells.size(); idx++)
+        {
+            double p = static_cast<double>(expected.cells[idx]) / expected.layouts;
+            double z = 0.0;
+            if(p > 0.0 && p < 1.0)
+            {
+                z = (observed.cells[idx] - samples * p) / std::sqrt(samples * p * (1.0 - p));
+                report.cellChiSquare += z * z;
+                report.cellDof++;
+            }
+            else if(observed.cells[idx] != static_cast<long long>(samples * p))
+            {
+                z = INFINITY;
+            }
+
+            if(std::fabs(z) > report.maxCellZ)
+            {
+                report.maxCellZ = std::fabs(z);
+                report.maxCellX = idx / expected.width;
+                report.maxCellY = idx % expected.width;
+            }
+        }
+        report.cellZScore = wilsonHilferty(report.cellChiSquare, report.cellDof);
+
+        const size_t block = static_cast<size_t>(LS_DIRECTIONS) * expected.length * expected.width;
+        for(int type = 0; type < LS_VESSEL_TYPES; type++)
+        {
+            long long expectedTotal = 0;
+            long long observedTotal = 0;
+            for(size_t idx = type * block; idx < (type + 1) * block; idx++)
+            {
+                expectedTotal += expected.anchors[idx];
+                observedTotal += observed.anchors[idx];
+            }
+            if(expectedTotal == 0 && observedTotal == 0)
+                continue;
+
+            AnchorBias bias;
+            bias.vtype = static_cast<Vessel::VType>(type);
+            int categories = 0;
+            for(size_t idx = type * block; idx < (type + 1) * block; idx++)
+            {
+                if(expected.anchors[idx] == 0)
+                {
+                    bias.impossible += observed.anchors[idx];
+                    continue;
+                }
+                double e = static_cast<double>(observedTotal) * expected.anchors[idx] / expectedTotal;
+                double d = observed.anchors[idx] - e;
+                bias.chiSquare += d * d / e;
+                categories++;
+            }
+            bias.dof = categories - 1;
+            bias.zScore = wilsonHilferty(bias.chiSquare, bias.dof);
+            report.anchors.push_back(bias);
+        }
+        return report;
+    }
+
+    /**
+     Write a bias report to the output stream, one line for cells and one per vessel type.
+    */
+    std::ostream& operator<<(std::ostream& os, const BiasReport& report)
+    {
+        std::ios_base::fmtflags flags = os.flags();
+        os<<std::fixed<<std::setprecision(2);
+        os<<"  cells    chi2/dof "<<report.cellChiSquare<<"/"<<report.cellDof<<"  z "<<report.cellZScore
+          <<"  max |z| "<<report.maxCellZ<<" at ("<<report.maxCellX<<","<<report.maxCellY<<")\n";
+        for(auto& bias : report.anchors)
+        {
+            os<<"  "<<std::left<<std::setw(10)<<Vessel::formatVessel(bias.vtype, true)<<std::right
+              <<"chi2/dof "<<bias.chiSquare<<"/"<<bias.dof<<"  z "<<bias.zScore;
+            if(bias.impossible > 0)
+                os<<"  impossible anchors "<<bias.impossible;
+            os<<"\n";
+        }
+        os.flags(flags);
+        return os;
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef LAYOUTSTATS_H
+#define LAYOUTSTATS_H
+
+#include <iostream>
+#include <vector>
+#include "placement.h"
+
+#define LS_VESSEL_TYPES 6
+#define LS_MAX_EXACT_LAYOUTS 2000000000LL
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     @enum LayoutSampler
+     The layout sampling methods the bias harness can measure.
+    */
+    enum class LayoutSampler
+    {
+        SAMPLER_ADDVESSEL,      //GameBoard::addVessel() called once per vessel
+        SAMPLER_SEQUENTIAL,     //PlacementGenerator in LAYOUT_SEQUENTIAL mode
+        SAMPLER_EXACT,          //PlacementGenerator in LAYOUT_EXACT mode
+        SAMPLER_UNIFORM         //PlacementGenerator in LAYOUT_UNIFORM mode
+    };
+
+    /**
+     @struct OccupancyCounts
+     Per-cell and per-anchor occupancy counts accumulated over many layouts of the same fleet.
+     Anchors are counted per vessel type rather than per fleet slot so the counts don't depend on
+     the order a sampler places vessels in. Vessels whose footprint is the same in both directions
+     are always counted as HORIZONTAL.
+     Counts are cache line aligned, as each sampling thread updates its own counts in a shared vector.
+    */
+    struct alignas(64) OccupancyCounts
+    {
+        int length;
+        int width;
+        long long layouts = 0;          /**< Number of layouts counted */
+        std::vector<long long> cells;   /**< Layouts occupying each cell, indexed x * width + y */
+        std::vector<long long> anchors; /**< Vessels anchored at each (type, direction, cell) */
+
+        OccupancyCounts(int len = GB_BOARD_SIZE, int wid = GB_BOARD_SIZE);
+        void addPlacement(const VesselPlacement& placement, long long weight = 1);
+        void merge(const OccupancyCounts& other);
+        int anchorIndex(Vessel::VType vtype, GameBoard::VDirection vdir, int x, int y) const;
+    };
+
+    /**
+     @struct AnchorBias
+     Chi-square comparison of the anchor distribution of a single vessel type.
+    */
+    struct AnchorBias
+    {
+        Vessel::VType vtype;
+        double chiSquare = 0.0;
+        int dof = 0;                    /**< Degrees of freedom */
+        double zScore = 0.0;            /**< Wilson-Hilferty normal approximation of chiSquare */
+        long long impossible = 0;       /**< Anchors observed where the exact distribution has none */
+    };
+
+    /**
+     @struct BiasReport
+     The deviation of sampled occupancy from the exact distribution.
+    */
+    struct BiasReport
+    {
+        long long layouts = 0;
+        double cellChiSquare = 0.0;     /**< Sum of squared per-cell binomial z-scores */
+        int cellDof = 0;
+        double cellZScore = 0.0;
+        double maxCellZ = 0.0;          /**< Largest absolute per-cell z-score */
+        int maxCellX = -1;
+        int maxCellY = -1;
+        std::vector<AnchorBias> anchors;
+    };
+
+    bool exactOccupancy(const std::vector<Vessel::VType>& fleet, int threads, OccupancyCounts& result,
+        long long maxLayouts = LS_MAX_EXACT_LAYOUTS);
+    bool sampleOccupancy(const std::vector<Vessel::VType>& fleet, LayoutSampler sampler, long long layouts, int threads,
+        uint64_t seed, OccupancyCounts& result);
+    BiasReport compareOccupancy(const OccupancyCounts& observed, const OccupancyCounts& expected);
+
+    std::ostream& operator<<(std::ostream& os, const BiasReport& report);
+}
+
+#endif
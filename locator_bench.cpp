@@ -0,0 +1,108 @@
+/**
+ * @file locator_bench.cpp
+ * Compares resolving a board coordinate to a vessel through a dense per cell id grid, as GameBoard::board_ stores it,
+ * with the VesselIndex used by TiledBoard, as board and fleet sizes grow.
+ * Usage: locator_bench [lookups]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include "tiledboard.h"
+#include "vesselindex.h"
+
+#define BENCH_DEFAULT_LOOKUPS 2000000
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ Time a lookup function over the given coordinates.
+ @return
+    Nanoseconds per lookup. The sum of the ids found is written to checksum so the work can't be optimized away.
+*/
+template<typename Lookup>
+static double timeLookups(const std::vector<std::pair<int64_t, int64_t>>& points, Lookup lookup, long long& checksum)
+{
+    checksum = 0;
+    auto start = Clock::now();
+    for(const auto& point : points)
+        checksum += lookup(point.first, point.second);
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    return elapsed.count() / points.size();
+}
+
+/**
+ Place up to vessels random carriers and time lookups with both locators.
+*/
+static void benchLocators(int64_t size, int vessels, int lookups, std::mt19937_64& rng)
+{
+    Cylink::TiledBoard board(size, size);
+    std::uniform_int_distribution<int64_t> coordinate(0, size - 1);
+    for(int attempt = 0; attempt < vessels * 20 && board.vesselCount() < vessels; attempt++)
+    {
+        Cylink::TiledBoard::VBorder vrect(coordinate(rng), coordinate(rng));
+        Cylink::GameBoard::VDirection vdir = (rng() & 1) ? Cylink::GameBoard::VDirection::VERTICAL : Cylink::GameBoard::VDirection::HORIZONTAL;
+        board.emplaceVessel(vrect, Cylink::Vessel::VType::CARRIER, vdir);
+    }
+
+    /* Build both locators from the same footprints */
+    std::vector<int> dense(size * size, GB_NO_VESSEL);
+    Cylink::VesselIndex index;
+    for(int vesselId = 0; vesselId < board.vesselCount(); vesselId++)
+    {
+        const Cylink::TiledBoard::VBorder& vrect = board.getBorder(vesselId);
+        index.insert(vrect.topX, vrect.topY, vrect.lowX, vrect.lowY, vesselId);
+        for(int64_t x = vrect.topX; x < vrect.lowX; x++)
+        {
+            for(int64_t y = vrect.topY; y < vrect.lowY; y++)
+                dense[x * size + y] = vesselId;
+        }
+    }
+
+    /* Half the lookups land on a vessel, half anywhere on the board */
+    std::vector<std::pair<int64_t, int64_t>> points(lookups);
+    std::uniform_int_distribution<int> pickVessel(0, board.vesselCount() - 1);
+    for(auto& point : points)
+    {
+        if(rng() & 1)
+        {
+            point = std::make_pair(coordinate(rng), coordinate(rng));
+        }
+        else
+        {
+            const Cylink::TiledBoard::VBorder& vrect = board.getBorder(pickVessel(rng));
+            point = std::make_pair(vrect.topX + rng() % (vrect.lowX - vrect.topX), vrect.topY + rng() % (vrect.lowY - vrect.topY));
+        }
+    }
+
+    long long denseSum = 0, indexSum = 0;
+    double denseNs = timeLookups(points, [&](int64_t x, int64_t y) { return dense[x * size + y]; }, denseSum);
+    double indexNs = timeLookups(points, [&](int64_t x, int64_t y) { return index.find(x, y); }, indexSum);
+
+    std::cout<<std::setw(6)<<size<<std::setw(9)<<board.vesselCount()
+        <<std::setw(12)<<denseNs<<std::setw(12)<<(dense.size() * sizeof(int) / 1024)
+        <<std::setw(12)<<indexNs<<std::setw(12)<<(index.memoryUsage() / 1024)
+        <<((denseSum == indexSum) ? "" : "  MISMATCH")<<"\n";
+}
+
+int main(int argc, char* argv[])
+{
+    int lookups = (argc > 1) ? std::atoi(argv[1]) : BENCH_DEFAULT_LOOKUPS;
+    if(lookups <= 0)
+        lookups = BENCH_DEFAULT_LOOKUPS;
+
+    std::mt19937_64 rng(1);
+    std::cout<<std::fixed<<std::setprecision(1)
+        <<"  size  vessels  dense ns/op  dense KiB  index ns/op  index KiB\n";
+    for(int64_t size : {64, 256, 1024, 4096})
+    {
+        for(int vessels : {16, 256, 4096, 65536})
+        {
+            if(vessels * 14 * 4 > size * size)
+                continue;
+            benchLocators(size, vessels, lookups, rng);
+        }
+    }
+    return 0;
+}
@@ -1,117 +1,356 @@
-//CATCH_CONFIG_RUNNER tells the catch library that this 
-//project will now explicitly call for the tests to be run. 
-#define CATCH_CONFIG_RUNNER
-#include <catch2/catch_all.hpp>
-
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <cstdlib>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
-#include "player.h"
-
-#define BOARDX 10
-#define BOARDY 10
-#define PLAYER1_ATTACK 1
-#define PLAYER2_ATTACK 2
-
-//A macro used in main to determine if you want to run
-//the tests or not. If you don't want to run your tests,
-//change true to false in the line below.
-#define PERFORM_TESTS true
- 
+#include "error.h"
+#include "gameserver.h"
+#include "instrument.h"
+#include "simulation.h"
+#include "utils.h"
+
+/*
+* printUsage writes the command line options to
+* the supplied stream.
+*/
+void printUsage(std::ostream& os, const char* program)
+{
+    os<<"Usage: "<<program<<" [options]\n"
+      <<"  --games N        number of games to play (default 1)\n"
+      <<"  --threads N      number of worker threads (default 1)\n"
+      <<"  --inflight N     games in flight on the coroutine scheduler, 0 plays one game per thread (default 0)\n"
+      <<"  --numa on|off    pin threads to NUMA nodes read from /sys and report games per node (default off)\n"
+      <<"  --seed N         run seed, the same seed replays the same games (default 0)\n"
+      <<"  --replay N       play only game N of the run, exactly as the full run plays it\n"
+      <<"  --board LxW      board length and width (default "<<GB_BOARD_SIZE<<"x"<<GB_BOARD_SIZE<<")\n"
+      <<"  --fleet FILE     fleet file, one \"<vessel> [count]\" per line (default standard fleet)\n"
+      <<"  --layout MODE    uniform, exact or sequential random layouts, uniform is unbiased but slower (default sequential)\n"
+      <<"  --p1 NAME        strategy for player 1 (default random)\n"
+      <<"  --p2 NAME        strategy for player 2 (default random)\n"
+      <<"  --p1-params LIST strategy parameters of player 1, comma separated (see strategy_tuner)\n"
+      <<"  --p2-params LIST strategy parameters of player 2\n"
+      <<"  --p1-layouts FILE\n"
+      <<"                   draw player 1's layouts from a placement table written by placement_optimizer\n"
+      <<"  --p2-layouts FILE\n"
+      <<"                   draw player 2's layouts from a placement table\n"
+      <<"  --out FILE       write game records to FILE instead of stdout\n"
+      <<"  --backpressure P block or drop records when the writer falls behind (default block)\n"
+      <<"  --queue N        records queued for the writer thread (default "<<RW_QUEUE_SIZE<<")\n"
+      <<"  --metrics FMT    write hot path counters to stderr as json or prometheus\n"
+      <<"  --stats FILE     write game statistics to FILE, - for stderr\n"
+      <<"  --serve ADDRESS  host games for remote clients on unix:PATH or tcp:PORT until interrupted,\n"
+      <<"                   the server plays --p2 with one event loop per --threads\n"
+      <<"Strategies:";
+    for(auto& name : Cylink::Strategy::available())
+        os<<" "<<name;
+    os<<"\n";
+}
+
+/*
+* parseNumber converts an option value to a number
+* and reports whether the whole value was used and fits in a long long.
+*/
+bool parseNumber(const std::string& value, long long& number)
+{
+    char* end = nullptr;
+    errno = 0;
+    number = std::strtoll(value.c_str(), &end, 10);
+    return !value.empty() && *end == '\0' && errno != ERANGE;
+}
+
+/*
+* parseParameters converts a comma separated option value to strategy parameters
+* and reports whether every value was a number.
+*/
+bool parseParameters(const std::string& value, std::vector<double>& parameters)
+{
+    parameters.clear();
+    Cylink::StringUtils::Tokenizer tokenizer(value, ',');
+    for(std::string_view token; tokenizer.next(token); )
+    {
+        std::string text(token);
+        char* end = nullptr;
+        parameters.push_back(std::strtod(text.c_str(), &end));
+        if(text.empty() || *end != '\0')
+            return false;
+    }
+    return !parameters.empty();
+}
+
 /*
-* runCatchTests will cause Catch to go ahead and
-* run your tests (that are contained in the tests.cpp file.
-* to do that, it needs access to the command line
-* args - argc and argv. It returns an integer that
-* ultimately gets passed back up to the operating system.
-* See the if statement at the top of main for
-* a better overview.
+* serve hosts games against remote clients until SIGINT or SIGTERM
+* and reports request latencies on stderr.
 */
-int runCatchTests(int argc, char* const argv[])
+int serve(const Cylink::SimulationConfig& config, const std::string& address)
 {
-    //This line of code causes the Catch library to 
-    //run the tests in the project. 
-    return Catch::Session().run(argc, argv);
+    Cylink::ServerConfig settings;
+    settings.threads = config.threads;
+    settings.seed = config.seed;
+    settings.length = config.length;
+    settings.width = config.width;
+    settings.fleet = config.fleet;
+    settings.strategy = config.strategy[1];
+
+    //Block the signals before the workers start so only sigwait() sees them.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    try
+    {
+        Cylink::GameServer server(settings);
+        server.start(address);
+        std::cerr<<"serving on "<<server.address()<<"\n";
+
+        int signal = 0;
+        sigwait(&signals, &signal);
+        server.stop();
+
+        std::cerr<<server.connections()<<" connections, "<<server.games()<<" games\n";
+        Cylink::Protocol::writeLatencies(std::cerr, server.latencies());
+    }
+    catch(const Cylink::Error& err)
+    {
+        std::cerr<<err.what()<<"\n";
+        return 1;
+    }
+    return 0;
 }
- 
-int main( int argc, char* const argv[] )
+
+int main(int argc, char* argv[])
 {
-    //If the PERFORM_TESTS macro is defined to be true,
-    //runCatchTests will be called and immediately
-    //return causing the program to terminate. Change TEST
-    //to false in the macro def at the top of this file
-    //to skip tests and run the rest of your code.
-    if (PERFORM_TESTS)
+    Cylink::SimulationConfig config;
+    std::string outPath;
+    std::string metrics;
+    std::string statsPath;
+    std::string serveAddress;
+    long long replay = -1;
+
+    //Read the command line options.
+    for(int arg = 1; arg < argc; arg++)
     {
-        return runCatchTests(argc, argv);
+        std::string option = argv[arg];
+        if(option == "--help" || option == "-h")
+        {
+            printUsage(std::cout, argv[0]);
+            return 0;
+        }
+        if(arg + 1 >= argc)
+        {
+            std::cerr<<"Missing value for "<<option<<"\n";
+            printUsage(std::cerr, argv[0]);
+            return 1;
+        }
+
+        std::string value = argv[++arg];
+        long long number = 0;
+        bool valid = true;
+        if(option == "--games")
+        {
+            valid = parseNumber(value, number) && number > 0;
+            config.games = number;
+        }
+        else if(option == "--threads")
+        {
+            valid = parseNumber(value, number) && number > 0 && number <= INT_MAX;
+            config.threads = static_cast<int>(number);
+        }
+        else if(option == "--inflight")
+        {
+            valid = parseNumber(value, number) && number >= 0 && number <= INT_MAX;
+            config.inflight = static_cast<int>(number);
+        }
+        else if(option == "--numa")
+        {
+            valid = (value == "on" || value == "off");
+            config.numa = (value == "on");
+        }
+        else if(option == "--seed")
+        {
+            valid = parseNumber(value, number);
+            config.seed = static_cast<uint64_t>(number);
+        }
+        else if(option == "--replay")
+        {
+            valid = parseNumber(value, number) && number >= 0;
+            replay = number;
+        }
+        else if(option == "--board")
+        {
+            size_t split = value.find('x');
+            long long width = 0;
+            valid = split != std::string::npos && parseNumber(value.substr(0, split), number)
+                && parseNumber(value.substr(split + 1), width) && number > 0 && width > 0
+                && number <= INT_MAX / width;
+            config.length = static_cast<int>(number);
+            config.width = static_cast<int>(width);
+        }
+        else if(option == "--fleet")
+        {
+            try
+            {
+                config.fleet = Cylink::loadFleet(value);
+            }
+            catch(const Cylink::Error& err)
+            {
+                std::cerr<<err.what()<<"\n";
+                return 1;
+            }
+        }
+        else if(option == "--p1")
+        {
+            config.strategy[0] = value;
+        }
+        else if(option == "--p2")
+        {
+            config.strategy[1] = value;
+        }
+        else if(option == "--p1-params" || option == "--p2-params")
+        {
+            valid = parseParameters(value, config.parameters[option[3] - '1']);
+        }
+        else if(option == "--p1-layouts" || option == "--p2-layouts")
+        {
+            try
+            {
+                config.placements[option[3] - '1'] = std::make_shared<Cylink::PlacementTable>(Cylink::PlacementTable::load(value));
+            }
+            catch(const Cylink::Error& err)
+            {
+                std::cerr<<err.what()<<"\n";
+                return 1;
+            }
+        }
+        else if(option == "--out")
+        {
+            outPath = value;
+        }
+        else if(option == "--layout")
+        {
+            valid = (value == "uniform" || value == "exact" || value == "sequential");
+            if(value == "uniform")
+                config.layout = Cylink::LayoutMode::LAYOUT_UNIFORM;
+            else if(value == "exact")
+                config.layout = Cylink::LayoutMode::LAYOUT_EXACT;
+            else if(value == "sequential")
+                config.layout = Cylink::LayoutMode::LAYOUT_SEQUENTIAL;
+        }
+        else if(option == "--backpressure")
+        {
+            valid = (value == "block" || value == "drop");
+            config.backpressure = (value == "drop") ? Cylink::Backpressure::BACKPRESSURE_DROP : Cylink::Backpressure::BACKPRESSURE_BLOCK;
+        }
+        else if(option == "--queue")
+        {
+            valid = parseNumber(value, number) && number > 0;
+            config.queueSize = static_cast<size_t>(number);
+        }
+        else if(option == "--metrics")
+        {
+            valid = (value == "json" || value == "prometheus");
+            metrics = value;
+        }
+        else if(option == "--stats")
+        {
+            statsPath = value;
+        }
+        else if(option == "--serve")
+        {
+            serveAddress = value;
+        }
+        else
+        {
+            valid = false;
+        }
+
+        if(!valid)
+        {
+            std::cerr<<"Invalid option "<<option<<" "<<value<<"\n";
+            printUsage(std::cerr, argv[0]);
+            return 1;
+        }
     }
 
-    /* ======== start working on other parts of your project here. ======== */
+    if(!serveAddress.empty())
+        return serve(config, serveAddress);
 
-    //Create player resources.
-    Cylink::Player player1(BOARDX, BOARDY);
-    Cylink::Player player2(BOARDX, BOARDY);
+    //A replayed game draws from the same streams as in the full run, so nothing before it needs playing.
+    if(replay >= 0)
+    {
+        config.firstGame = replay;
+        config.games = 1;
+    }
 
-    //Create vector of game vessels
-    std::vector<Cylink::Vessel::VType> vessels;
-    vessels.insert(vessels.end(), 1, Cylink::Vessel::VType::CARRIER);
-    vessels.insert(vessels.end(), 3, Cylink::Vessel::VType::CRUISER);
-    vessels.insert(vessels.end(), 3, Cylink::Vessel::VType::DESTROYER);
-    vessels.insert(vessels.end(), 2, Cylink::Vessel::VType::FRIGATE);
-    vessels.insert(vessels.end(), 2, Cylink::Vessel::VType::SUBMARINE);
+    //Write game records to the record file or stdout.
+    int outFd = STDOUT_FILENO;
+    if(!outPath.empty())
+    {
+        outFd = ::open(outPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if(outFd < 0)
+        {
+            std::cerr<<"Unable to open "<<outPath<<"\n";
+            return 1;
+        }
+    }
 
-    //register vessels with players
-    int shipCount1 = player1.setupBoard(vessels);
-    int shipCount2 = player2.setupBoard(vessels);
+    std::ofstream statsFile;
+    if(!statsPath.empty() && statsPath != "-")
+    {
+        statsFile.open(statsPath);
+        if(!statsFile)
+        {
+            std::cerr<<"Unable to open "<<statsPath<<"\n";
+            return 1;
+        }
+    }
 
-    //Verify that both players have same number of ships
-    if(shipCount1 == shipCount2)
+    try
     {
-        /* Game starts with a random player then simulation continues */
-        int xCord, yCord;
-        int playerSelector = Cylink::GameBoard::randomNumber(1, 2, true);
-        bool gameOver = false;
-        do
+        std::unique_ptr<Cylink::GameStats> stats;
+        if(!statsPath.empty())
+            stats = std::make_unique<Cylink::GameStats>(config.length, config.width);
+        Cylink::SimulationSummary summary = Cylink::runSimulation(config, outFd, stats.get());
+        if(outFd != STDOUT_FILENO)
+            ::close(outFd);
+
+        //Report totals on stderr so they don't mix with the game records.
+        std::cerr<<summary.games<<" games in "<<summary.seconds<<"s ("
+            <<static_cast<long long>(summary.games / (summary.seconds > 0 ? summary.seconds : 1))<<" games/second)\n"
+            <<"player 1 ("<<config.strategy[0]<<") wins "<<summary.wins[SIM_PLAYER1]
+            <<", player 2 ("<<config.strategy[1]<<") wins "<<summary.wins[SIM_PLAYER2]
+            <<", draws "<<summary.wins[SIM_DRAW]<<"\n";
+        if(summary.dropped > 0)
+            std::cerr<<summary.dropped<<" game records dropped\n";
+        if(config.numa)
         {
-            switch(playerSelector)
+            for(auto& node : summary.nodes)
             {
-            /* Player 1 launches attack */
-            case PLAYER1_ATTACK:
-                //Get a fire position suggestion.
-                std::tie(xCord, yCord) = player1.suggestFirePosition();
-
-                //launch the attack.
-                player1.launchAttack(player2, xCord, yCord);
-
-                //determine if game is over because player2 is dead.
-                if(player2.hasVessels() == false)
-                {
-                    gameOver = true;
-                }
-
-                //toggle the player selector to the opponent.
-                playerSelector = PLAYER2_ATTACK;
-                break;
-
-            /* Player 2 launches attack */
-            case PLAYER2_ATTACK:
-                //Get a fire position suggestion.
-                std::tie(xCord, yCord) = player2.suggestFirePosition();
-
-                //launch the attack.
-                player2.launchAttack(player1, xCord, yCord);
-
-                //determine if game is over because player2 is dead.
-                if(player1.hasVessels() == false)
-                {
-                    gameOver = true;
-                }
-
-                //toggle the player selector to the opponent.
-                playerSelector = PLAYER1_ATTACK;
-                break;
-            };
-
-        } while (gameOver == false);
+                std::cerr<<"node "<<node.node<<": "<<node.threads<<" threads, "<<node.pinned<<" pinned, "<<node.games<<" games ("
+                    <<static_cast<long long>(node.games / (summary.seconds > 0 ? summary.seconds : 1))<<" games/second)\n";
+            }
+        }
+
+        //Dump the counters once every worker has finished.
+        if(metrics == "json")
+            Cylink::Instrument::report().writeJson(std::cerr);
+        else if(metrics == "prometheus")
+            Cylink::Instrument::report().writePrometheus(std::cerr);
+
+        if(stats)
+            (statsPath == "-" ? std::cerr : statsFile)<<*stats;
+    }
+    catch(const Cylink::Error& err)
+    {
+        std::cerr<<err.what()<<"\n";
+        return 1;
     }
 
     return 0;
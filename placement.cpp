@@ -0,0 +1,863 @@
+#include <algorithm>
+#include <climits>
+#include <mutex>
+#include <tuple>
+
+#include "placement.h"
+#include "error.h"
+#include "instrument.h"
+
+#define PG_ARG_ERROR ErrorCode::ERR_INVALID_ARG
+#define PG_WORD_BITS 64
+#define PG_HORIZONTAL 0
+#define PG_VERTICAL 1
+#define PG_DEPTH_BITS 3
+#define PG_DEPTH_MASK 7
+
+namespace Cylink
+{
+    /**
+     @struct PlacementGenerator::LayoutCounts
+     The number of ways to complete a layout from every state of a cell by cell sweep of the board, row by row.
+     A state is a key holding, for every column, how many more cells down from the sweep a vessel already placed
+     covers (PG_DEPTH_BITS per column), and above those the vessels still to place as a mixed radix number.
+     Placing a vessel at the sweep's cell sets the depth of its columns, so every layout is one path through
+     the states and drawing each step in proportion to the completions it leaves draws a uniform layout.
+    */
+    struct PlacementGenerator::LayoutCounts
+    {
+        int length = 0;
+        int width = 0;
+        std::vector<Vessel::VType> fleet;   /**< The fleet counted, as the generator orders it */
+        std::vector<Vessel::VType> types;   /**< Distinct vessel types of the fleet */
+        std::vector<int> number;            /**< Vessels of each type */
+        std::vector<uint64_t> radix;        /**< Weight of each type in the vessels part of a key */
+        uint64_t start = 0;                 /**< Key before the first cell: nothing placed */
+        bool tabled = false;                /**< False if the states didn't fit PG_MAX_COUNT_STATES or the counts overflowed */
+        std::vector<std::vector<uint64_t>> keys;        /**< States before each cell, sorted */
+        std::vector<std::vector<uint64_t>> completions; /**< Ways to complete the layout from each state */
+
+        uint64_t count(int pos, uint64_t key) const;
+        uint64_t remaining(uint64_t key, size_t type) const;
+        bool roomFor(int pos, uint64_t key) const;
+
+        template<typename Visit>
+        void successors(int pos, uint64_t key, Visit visit) const;
+    };
+
+    /**
+     @return
+        The number of ways to complete a layout from a state before the given cell, 0 for unknown states.
+    */
+    uint64_t PlacementGenerator::LayoutCounts::count(int pos, uint64_t key) const
+    {
+        const std::vector<uint64_t>& layer = keys[pos];
+        auto found = std::lower_bound(layer.begin(), layer.end(), key);
+        if(found == layer.end() || *found != key)
+            return 0;
+        return completions[pos][found - layer.begin()];
+    }
+
+    /**
+     @return
+        The number of vessels of a type still to place in a state.
+    */
+    uint64_t PlacementGenerator::LayoutCounts::remaining(uint64_t key, size_t type) const
+    {
+        return ((key >> (PG_DEPTH_BITS * width)) / radix[type]) % (number[type] + 1);
+    }
+
+    /**
+     @return
+        False if the vessels still to place cover more cells than are left free from the given cell on.
+    */
+    bool PlacementGenerator::LayoutCounts::roomFor(int pos, uint64_t key) const
+    {
+        long long free = static_cast<long long>(length) * width - pos;
+        for(int y = 0; y < width; y++)
+            free -= (key >> (PG_DEPTH_BITS * y)) & PG_DEPTH_MASK;
+        for(size_t type = 0; type < types.size(); type++)
+        {
+            std::pair<int, int> dims = Vessel::vesselDimensions(types[type]);
+            free -= static_cast<long long>(remaining(key, type)) * dims.first * dims.second;
+        }
+        return free >= 0;
+    }
+
+    /**
+     Call visit(next, type, direction) for every state following a state before the given cell: the cell left
+     empty or already covered, with type -1, and every vessel still to place anchored at the cell.
+    */
+    template<typename Visit>
+    void PlacementGenerator::LayoutCounts::successors(int pos, uint64_t key, Visit visit) const
+    {
+        int x = pos / width;
+        int y = pos % width;
+        int shift = PG_DEPTH_BITS * y;
+        if((key >> shift) & PG_DEPTH_MASK)
+        {
+            visit(key - (uint64_t(1) << shift), -1, PG_HORIZONTAL);
+            return;
+        }
+        visit(key, -1, PG_HORIZONTAL);
+        for(size_t type = 0; type < types.size(); type++)
+        {
+            if(remaining(key, type) == 0)
+                continue;
+            int vesselLength, vesselWidth;
+            std::tie(vesselLength, vesselWidth) = Vessel::vesselDimensions(types[type]);
+            for(int dir = PG_HORIZONTAL; dir <= ((vesselLength == vesselWidth) ? PG_HORIZONTAL : PG_VERTICAL); dir++)
+            {
+                int height = (dir == PG_HORIZONTAL) ? vesselWidth : vesselLength;
+                int span = (dir == PG_HORIZONTAL) ? vesselLength : vesselWidth;
+                if(x + height > length || y + span > width)
+                    continue;
+                uint64_t columns = (uint64_t(1) << (PG_DEPTH_BITS * span)) - 1;
+                if((key >> shift) & columns)
+                    continue;
+                uint64_t next = key;
+                for(int col = 0; col < span; col++)
+                    next |= uint64_t(height) << (shift + PG_DEPTH_BITS * col);
+                next -= uint64_t(1) << shift;
+                next -= radix[type] << (PG_DEPTH_BITS * width);
+                visit(next, static_cast<int>(type), dir);
+            }
+        }
+    }
+
+    /**
+     Create a generator for the given fleet and board size.
+     The fleet is stored largest vessel first since placing large vessels early makes dead ends far less likely.
+     @param fleet
+        The vessel types making up a complete layout. Duplicates are allowed.
+     @param length
+        The length of the board. Value must be greater than zero.
+     @param width
+        The width of the board. Value must be greater than zero.
+     @param seed
+        Seed for the generator's random engine.
+     @param mode
+        The sampling method, see LayoutMode.
+    */
+    PlacementGenerator::PlacementGenerator(const std::vector<Vessel::VType>& fleet, int length, int width,
+        uint64_t seed, LayoutMode mode)
+        : lengthOfBoard_(length), widthOfBoard_(width), maxAttempts_(PG_MAX_ATTEMPTS), mode_(mode),
+          method_(Method::METHOD_EXACT), fleet_(fleet), occupied_(), legal_(), free_(), feasible_(true), bounds_(), acceptance_(0.0), counts_(), drawn_(), engine_(seed)
+    {
+        if(lengthOfBoard_ <= 0 || widthOfBoard_ <= 0)
+        {
+            Error argError("Board length and height must be greater than zero.", PG_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+
+        occupied_ = BitBoard(lengthOfBoard_, widthOfBoard_);
+        int words = occupied_.wordsPerRow();
+        legal_[PG_HORIZONTAL].assign(static_cast<size_t>(lengthOfBoard_) * words, 0);
+        legal_[PG_VERTICAL].assign(static_cast<size_t>(lengthOfBoard_) * words, 0);
+        free_.assign(words, 0);
+
+        std::stable_sort(fleet_.begin(), fleet_.end(), [](Vessel::VType a, Vessel::VType b)
+        {
+            Vessel va(a), vb(b);
+            return va.getDamageLevel(true) > vb.getDamageLevel(true);
+        });
+
+        /* A fleet is infeasible if it covers more cells than the board or a vessel can't fit in any orientation. */
+        long long cells = 0;
+        for(auto vtype : fleet_)
+        {
+            int length, breadth;
+            std::tie(length, breadth) = Vessel::vesselDimensions(vtype);
+            cells += length * breadth;
+            bool fitsH = (breadth <= lengthOfBoard_ && length <= widthOfBoard_);
+            bool fitsV = (length <= lengthOfBoard_ && breadth <= widthOfBoard_);
+            if(!fitsH && !fitsV)
+                feasible_ = false;
+        }
+        if(cells > static_cast<long long>(lengthOfBoard_) * widthOfBoard_)
+            feasible_ = false;
+
+        /* The bound on a vessel's open positions depends only on the cells the vessels before it cover */
+        int covered = 0;
+        for(auto vtype : fleet_)
+        {
+            int heightH, spanH, heightV, spanV;
+            footprint(vtype, GameBoard::VDirection::HORIZONTAL, heightH, spanH);
+            footprint(vtype, GameBoard::VDirection::VERTICAL, heightV, spanV);
+            bounds_.push_back(static_cast<uint64_t>(openBound(lengthOfBoard_, widthOfBoard_, heightH, spanH, covered))
+                + openBound(lengthOfBoard_, widthOfBoard_, heightV, spanV, covered));
+            covered += heightH * spanH;
+        }
+
+        if(mode_ == LayoutMode::LAYOUT_SEQUENTIAL)
+            method_ = Method::METHOD_SEQUENTIAL;
+        else if(mode_ == LayoutMode::LAYOUT_UNIFORM && feasible_)
+        {
+            /* Plain rejection has the cheapest attempts, bounded rejection the better odds, counting is for fleets too dense for either */
+            double exact, bounded;
+            estimateAcceptance(exact, bounded);
+            acceptance_ = exact;
+            if(exact < PG_EXACT_ACCEPTANCE)
+            {
+                method_ = Method::METHOD_BOUNDED;
+                acceptance_ = bounded;
+            }
+            if(bounded < PG_MIN_ACCEPTANCE)
+            {
+                std::shared_ptr<const LayoutCounts> counts = countLayouts(fleet_, lengthOfBoard_, widthOfBoard_);
+                if(counts->tabled && counts->count(0, counts->start) == 0)
+                    feasible_ = false;
+                else if(counts->tabled)
+                {
+                    counts_ = counts;
+                    method_ = Method::METHOD_COUNTED;
+                }
+            }
+
+            /* Budget enough attempts that running out is as unlikely as it is for a sparse fleet */
+            if(acceptance_ > 0.0)
+                maxAttempts_ = static_cast<int>(std::min<double>(INT_MAX, std::max<double>(maxAttempts_, PG_ATTEMPT_MARGIN / acceptance_)));
+        }
+    }
+
+    /**
+     Generate a complete layout for the fleet.
+     On success the layout holds one placement per vessel, ordered largest vessel first.
+     The placements never overlap and always lie within the board so they may be passed directly to GameBoard::emplaceVessel().
+     @param layout
+        Receives the generated placements. Its capacity is reused between calls.
+     @return
+        LAYOUT_OK on success, LAYOUT_RETRY if the attempt budget ran out (the caller should reseed and call again),
+        or LAYOUT_FAILED if the fleet can never fit on the board.
+    */
+    LayoutStatus PlacementGenerator::generate(std::vector<VesselPlacement>& layout)
+    {
+        if(!feasible_)
+            return LayoutStatus::LAYOUT_FAILED;
+        if(method_ == Method::METHOD_COUNTED)
+        {
+            placeCounted(layout);
+            return LayoutStatus::LAYOUT_OK;
+        }
+
+        for(int attempt = 0; attempt < maxAttempts_; attempt++)
+        {
+            bool placed;
+            if(method_ == Method::METHOD_EXACT)
+                placed = placeExact(layout);
+            else if(method_ == Method::METHOD_BOUNDED)
+                placed = placeBounded(layout);
+            else
+                placed = placeSequential(layout);
+            if(placed)
+                return LayoutStatus::LAYOUT_OK;
+            HS_COUNT(LAYOUT_RESTART);
+        }
+        layout.clear();
+        return LayoutStatus::LAYOUT_RETRY;
+    }
+
+    /**
+     Reseed the generator's random engine.
+     @param seed
+        The new seed.
+    */
+    void PlacementGenerator::reseed(uint64_t seed)
+    {
+        engine_.seed(seed);
+    }
+
+    /**
+     Set the number of restarts allowed per call to generate() before LAYOUT_RETRY is returned.
+     @param attempts
+        The attempt budget. Values less than one are treated as one.
+    */
+    void PlacementGenerator::setMaxAttempts(int attempts)
+    {
+        maxAttempts_ = std::max(1, attempts);
+    }
+
+    /**
+     @return
+        False if the fleet can never fit on the board, in which case generate() always returns LAYOUT_FAILED.
+    */
+    bool PlacementGenerator::isFeasible() const
+    {
+        return feasible_;
+    }
+
+    /**
+     @return
+        True if the generator draws uniform layouts from layout counts rather than by rejection.
+    */
+    bool PlacementGenerator::isCounted() const
+    {
+        return method_ == Method::METHOD_COUNTED;
+    }
+
+    /**
+     @return
+        The estimated chance that one attempt of the rejection method picked for a LAYOUT_UNIFORM generator
+        yields a layout. Zero for the other modes.
+    */
+    double PlacementGenerator::acceptance() const
+    {
+        return acceptance_;
+    }
+
+    /**
+     Place every vessel uniformly among the positions left open by the vessels placed before it.
+     @param exactWeight
+        If not null, receives the product over the vessels of their open positions divided by their in-bounds
+        positions. Averaged over many layouts, counting dead ends as zero, this is the chance a LAYOUT_EXACT attempt succeeds.
+     @param boundedWeight
+        If not null, receives the same product divided by the bounds in bounds_ instead, the chance a placeBounded() attempt succeeds.
+     @return
+        True if all vessels were placed, false if a vessel had nowhere to go.
+    */
+    bool PlacementGenerator::placeSequential(std::vector<VesselPlacement>& layout, double* exactWeight, double* boundedWeight)
+    {
+        occupied_.clear();
+        layout.clear();
+        if(exactWeight)
+            *exactWeight = 1.0;
+        if(boundedWeight)
+            *boundedWeight = 1.0;
+
+        for(size_t idx = 0; idx < fleet_.size(); idx++)
+        {
+            VesselPlacement placement;
+            placement.vtype = fleet_[idx];
+            int countH, countV;
+            legalCounts(placement.vtype, countH, countV);
+            if(countH + countV == 0)
+                return false;
+            if(exactWeight)
+                *exactWeight *= static_cast<double>(countH + countV) / inBounds(placement.vtype);
+            if(boundedWeight)
+                *boundedWeight *= static_cast<double>(countH + countV) / bounds_[idx];
+
+            legalAnchor(engine_.below(static_cast<uint64_t>(countH) + countV), countH, placement);
+            occupied_.setRect(placement.border.topX, placement.border.topY, placement.border.lowX, placement.border.lowY);
+            layout.push_back(placement);
+        }
+        return true;
+    }
+
+    /**
+     Place every vessel uniformly among all in-bounds positions, abandoning the attempt on the first overlap.
+     Abandoning early yields the same distribution as rejecting complete overlapping layouts, ie. uniform over valid layouts.
+     @return
+        True if all vessels were placed without overlap.
+    */
+    bool PlacementGenerator::placeExact(std::vector<VesselPlacement>& layout)
+    {
+        occupied_.clear();
+        layout.clear();
+
+        for(auto vtype : fleet_)
+        {
+            VesselPlacement placement;
+            placement.vtype = vtype;
+            inBoundsAnchor(engine_.below(inBounds(vtype)), placement);
+            if(!claim(placement.border))
+                return false;
+            layout.push_back(placement);
+        }
+        return true;
+    }
+
+    /**
+     Place every vessel with the same chance, one over its bound in bounds_, at each of its open positions,
+     abandoning the attempt with the remaining chance. Since the bounds don't depend on the layout, every
+     valid layout is equally likely, and an attempt succeeds far more often than with placeExact().
+     Each vessel first gets a draw among the in-bounds positions like placeExact(), which needs no count of the
+     open positions. Only when it lands on a closed one are they counted, to make up the difference between
+     the two chances of each open position.
+     @return
+        True if all vessels were placed.
+    */
+    bool PlacementGenerator::placeBounded(std::vector<VesselPlacement>& layout)
+    {
+        occupied_.clear();
+        layout.clear();
+
+        for(size_t idx = 0; idx < fleet_.size(); idx++)
+        {
+            VesselPlacement placement;
+            placement.vtype = fleet_[idx];
+            uint64_t positions = inBounds(placement.vtype);
+            inBoundsAnchor(engine_.below(positions), placement);
+            if(claim(placement.border))
+            {
+                layout.push_back(placement);
+                continue;
+            }
+
+            /* The first draw chose a given open position with chance 1 / positions, make it up to 1 / bound */
+            int countH, countV;
+            legalCounts(placement.vtype, countH, countV);
+            uint64_t open = static_cast<uint64_t>(countH) + countV;
+            uint64_t bound = bounds_[idx];
+            uint64_t pick = engine_.below(bound * (positions - open));
+            if(pick >= open * (positions - bound))
+                return false;
+
+            legalAnchor(pick % open, countH, placement);
+            occupied_.setRect(placement.border.topX, placement.border.topY, placement.border.lowX, placement.border.lowY);
+            layout.push_back(placement);
+        }
+        return true;
+    }
+
+    /**
+     Draw a uniform layout from the layout counts: sweep the board cell by cell, choosing what each cell holds
+     in proportion to the number of layouts each choice can still be completed to.
+     @param layout
+        Receives the placements, ordered like the fleet.
+    */
+    void PlacementGenerator::placeCounted(std::vector<VesselPlacement>& layout)
+    {
+        const LayoutCounts& counts = *counts_;
+        drawn_.clear();
+        uint64_t key = counts.start;
+        for(int pos = 0; pos < lengthOfBoard_ * widthOfBoard_; pos++)
+        {
+            uint64_t pick = engine_.below(counts.count(pos, key));
+            uint64_t chosen = key;
+            bool found = false;
+            counts.successors(pos, key, [&](uint64_t next, int type, int dir)
+            {
+                if(found)
+                    return;
+                uint64_t ways = counts.count(pos + 1, next);
+                if(pick >= ways)
+                {
+                    pick -= ways;
+                    return;
+                }
+                found = true;
+                chosen = next;
+                if(type < 0)
+                    return;
+                VesselPlacement placement;
+                placement.vtype = counts.types[type];
+                placement.direction = (dir == PG_HORIZONTAL) ? GameBoard::VDirection::HORIZONTAL : GameBoard::VDirection::VERTICAL;
+                int height, span;
+                footprint(placement.vtype, placement.direction, height, span);
+                placement.border = GameBoard::VBorder(pos / widthOfBoard_, pos % widthOfBoard_);
+                placement.border.lowX = placement.border.topX + height;
+                placement.border.lowY = placement.border.topY + span;
+                drawn_.push_back(placement);
+            });
+            key = chosen;
+        }
+
+        /* Hand the placements out in fleet order, largest vessel first */
+        layout.clear();
+        for(auto vtype : fleet_)
+        {
+            for(auto& placement : drawn_)
+            {
+                if(placement.vtype == vtype && placement.border.topX >= 0)
+                {
+                    layout.push_back(placement);
+                    placement.border.topX = -1;
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     Mark a vessel's cells occupied unless one of them already is. A vessel within one word of each row,
+     as on any board up to 64 wide, is tested and set a row word at a time.
+     @return
+        False if the vessel overlaps an occupied cell, in which case nothing is marked.
+    */
+    bool PlacementGenerator::claim(const GameBoard::VBorder& border)
+    {
+        int word = border.topY / PG_WORD_BITS;
+        if(word != (border.lowY - 1) / PG_WORD_BITS)
+        {
+            if(occupied_.anyInRect(border.topX, border.topY, border.lowX, border.lowY))
+                return false;
+            occupied_.setRect(border.topX, border.topY, border.lowX, border.lowY);
+            return true;
+        }
+        uint64_t mask = (~uint64_t(0) >> (PG_WORD_BITS - (border.lowY - border.topY))) << (border.topY % PG_WORD_BITS);
+        for(int x = border.topX; x < border.lowX; x++)
+        {
+            if(occupied_.row(x)[word] & mask)
+                return false;
+        }
+        for(int x = border.topX; x < border.lowX; x++)
+            occupied_.row(x)[word] |= mask;
+        return true;
+    }
+
+    /**
+     Estimate the chances that one plain and one bounded rejection attempt yield a layout from PG_PILOT_LAYOUTS
+     sequential layouts, see placeSequential(). The pilot uses a fixed seed, so the estimates depend only on the fleet
+     and board and are kept for the other generators of the same fleet and board, which a run may create by the thousand.
+     @param exact
+        Receives the chance for a LAYOUT_EXACT attempt.
+     @param bounded
+        Receives the chance for a bounded attempt.
+    */
+    void PlacementGenerator::estimateAcceptance(double& exact, double& bounded)
+    {
+        struct Pilot
+        {
+            int length;
+            int width;
+            std::vector<Vessel::VType> fleet;
+            double exact;
+            double bounded;
+        };
+        static std::mutex pilotsLock;
+        static std::vector<Pilot> pilots;
+
+        std::lock_guard<std::mutex> guard(pilotsLock);
+        for(auto& pilot : pilots)
+        {
+            if(pilot.length == lengthOfBoard_ && pilot.width == widthOfBoard_ && pilot.fleet == fleet_)
+            {
+                exact = pilot.exact;
+                bounded = pilot.bounded;
+                return;
+            }
+        }
+
+        Xoshiro256 saved = engine_;
+        engine_.seed(0);
+        std::vector<VesselPlacement> layout;
+        exact = 0.0;
+        bounded = 0.0;
+        for(int pilot = 0; pilot < PG_PILOT_LAYOUTS; pilot++)
+        {
+            double exactWeight, boundedWeight;
+            if(placeSequential(layout, &exactWeight, &boundedWeight))
+            {
+                exact += exactWeight;
+                bounded += boundedWeight;
+            }
+        }
+        engine_ = saved;
+        exact /= PG_PILOT_LAYOUTS;
+        bounded /= PG_PILOT_LAYOUTS;
+        pilots.push_back({lengthOfBoard_, widthOfBoard_, fleet_, exact, bounded});
+    }
+
+    /**
+     Get the layout counts of a fleet on a board of the given size, counting them on first use. Safe to call
+     from any thread. Boards wider than the keys hold, fleets with too many states and counts that overflow
+     give counts that aren't tabled.
+     @param fleet
+        The fleet, ordered as the generator orders it.
+    */
+    std::shared_ptr<const PlacementGenerator::LayoutCounts> PlacementGenerator::countLayouts(const std::vector<Vessel::VType>& fleet,
+        int length, int width)
+    {
+        /* Counts live until the process exits, a run only ever sees a few fleets and board sizes */
+        static std::mutex countsLock;
+        static std::vector<std::shared_ptr<const LayoutCounts>> known;
+
+        std::lock_guard<std::mutex> guard(countsLock);
+        for(auto& counts : known)
+        {
+            if(counts->length == length && counts->width == width && counts->fleet == fleet)
+                return counts;
+        }
+
+        std::shared_ptr<LayoutCounts> counts = std::make_shared<LayoutCounts>();
+        known.push_back(counts);
+        counts->length = length;
+        counts->width = width;
+        counts->fleet = fleet;
+        for(auto vtype : fleet)
+        {
+            auto found = std::find(counts->types.begin(), counts->types.end(), vtype);
+            if(found == counts->types.end())
+            {
+                counts->types.push_back(vtype);
+                counts->number.push_back(1);
+            }
+            else
+                counts->number[found - counts->types.begin()]++;
+        }
+
+        /* The column depths and the vessels still to place must share a 64-bit key */
+        int keyBits = PG_DEPTH_BITS * width;
+        uint64_t weight = 1;
+        for(int number : counts->number)
+        {
+            counts->radix.push_back(weight);
+            if(keyBits >= PG_WORD_BITS || weight > (~uint64_t(0) >> keyBits) / (number + 1))
+                return counts;
+            counts->start += weight * number;
+            weight *= number + 1;
+        }
+        counts->start <<= keyBits;
+
+        /* Sweep forward to find the states reachable with room left for the remaining vessels */
+        int cells = length * width;
+        size_t states = 1;
+        counts->keys.resize(cells + 1);
+        counts->keys[0].push_back(counts->start);
+        for(int pos = 0; pos < cells; pos++)
+        {
+            std::vector<uint64_t>& next = counts->keys[pos + 1];
+            for(uint64_t key : counts->keys[pos])
+            {
+                counts->successors(pos, key, [&](uint64_t following, int type, int dir)
+                {
+                    if(counts->roomFor(pos + 1, following))
+                        next.push_back(following);
+                });
+            }
+            std::sort(next.begin(), next.end());
+            next.erase(std::unique(next.begin(), next.end()), next.end());
+            states += next.size();
+            if(states > PG_MAX_COUNT_STATES)
+            {
+                counts->keys.clear();
+                return counts;
+            }
+        }
+
+        /* Then count the completions backwards. Only the empty state is complete after the last cell */
+        counts->completions.resize(cells + 1);
+        for(uint64_t key : counts->keys[cells])
+            counts->completions[cells].push_back(key == 0 ? 1 : 0);
+        for(int pos = cells - 1; pos >= 0; pos--)
+        {
+            for(uint64_t key : counts->keys[pos])
+            {
+                uint64_t ways = 0;
+                bool overflow = false;
+                counts->successors(pos, key, [&](uint64_t following, int type, int dir)
+                {
+                    overflow |= __builtin_add_overflow(ways, counts->count(pos + 1, following), &ways);
+                });
+                if(overflow)
+                {
+                    counts->keys.clear();
+                    counts->completions.clear();
+                    return counts;
+                }
+                counts->completions[pos].push_back(ways);
+            }
+        }
+        counts->tabled = true;
+        return counts;
+    }
+
+    /**
+     @return
+        The number of in-bounds positions of a vessel, counting both directions.
+    */
+    uint64_t PlacementGenerator::inBounds(Vessel::VType vtype) const
+    {
+        int heightH, spanH, heightV, spanV;
+        footprint(vtype, GameBoard::VDirection::HORIZONTAL, heightH, spanH);
+        footprint(vtype, GameBoard::VDirection::VERTICAL, heightV, spanV);
+        return static_cast<uint64_t>(std::max(0, lengthOfBoard_ - heightH + 1)) * std::max(0, widthOfBoard_ - spanH + 1)
+            + static_cast<uint64_t>(std::max(0, lengthOfBoard_ - heightV + 1)) * std::max(0, widthOfBoard_ - spanV + 1);
+    }
+
+    /**
+     Set a placement to the pick-th in-bounds position of its vessel, horizontal positions first.
+     @param placement
+        The placement, with its vessel type set.
+    */
+    void PlacementGenerator::inBoundsAnchor(uint64_t pick, VesselPlacement& placement) const
+    {
+        int heightH, spanH, heightV, spanV;
+        footprint(placement.vtype, GameBoard::VDirection::HORIZONTAL, heightH, spanH);
+        footprint(placement.vtype, GameBoard::VDirection::VERTICAL, heightV, spanV);
+
+        int colsH = std::max(0, widthOfBoard_ - spanH + 1);
+        int colsV = std::max(0, widthOfBoard_ - spanV + 1);
+        uint64_t countH = static_cast<uint64_t>(std::max(0, lengthOfBoard_ - heightH + 1)) * colsH;
+        if(pick < countH)
+        {
+            placement.direction = GameBoard::VDirection::HORIZONTAL;
+            placement.border = GameBoard::VBorder(pick / colsH, pick % colsH);
+            placement.border.lowX = placement.border.topX + heightH;
+            placement.border.lowY = placement.border.topY + spanH;
+        }
+        else
+        {
+            pick -= countH;
+            placement.direction = GameBoard::VDirection::VERTICAL;
+            placement.border = GameBoard::VBorder(pick / colsV, pick % colsV);
+            placement.border.lowX = placement.border.topX + heightV;
+            placement.border.lowY = placement.border.topY + spanV;
+        }
+    }
+
+    /**
+     Compute the legal anchor masks of a vessel in both directions against the current occupancy.
+     @param countH
+        Receives the number of legal horizontal anchors.
+     @param countV
+        Receives the number of legal vertical anchors.
+    */
+    void PlacementGenerator::legalCounts(Vessel::VType vtype, int& countH, int& countV)
+    {
+        int height, span;
+        footprint(vtype, GameBoard::VDirection::HORIZONTAL, height, span);
+        countH = legalAnchors(height, span, legal_[PG_HORIZONTAL].data());
+        footprint(vtype, GameBoard::VDirection::VERTICAL, height, span);
+        countV = legalAnchors(height, span, legal_[PG_VERTICAL].data());
+    }
+
+    /**
+     Set a placement to the pick-th legal anchor across both directions of the masks computed by legalCounts().
+     @param countH
+        The number of legal horizontal anchors, which come first.
+     @param placement
+        The placement, with its vessel type set.
+    */
+    void PlacementGenerator::legalAnchor(uint64_t pick, int countH, VesselPlacement& placement) const
+    {
+        const int words = occupied_.wordsPerRow();
+        int dirIdx = PG_HORIZONTAL;
+        if(pick >= static_cast<uint64_t>(countH))
+        {
+            pick -= countH;
+            dirIdx = PG_VERTICAL;
+        }
+
+        const uint64_t* legal = legal_[dirIdx].data();
+        size_t wordIdx = 0;
+        int bits = __builtin_popcountll(legal[wordIdx]);
+        while(pick >= static_cast<uint64_t>(bits))
+        {
+            pick -= bits;
+            bits = __builtin_popcountll(legal[++wordIdx]);
+        }
+        uint64_t word = legal[wordIdx];
+        for(; pick > 0; pick--)
+            word &= word - 1;
+
+        int height, span;
+        placement.direction = (dirIdx == PG_HORIZONTAL) ? GameBoard::VDirection::HORIZONTAL : GameBoard::VDirection::VERTICAL;
+        footprint(placement.vtype, placement.direction, height, span);
+        placement.border.topX = static_cast<int>(wordIdx / words);
+        placement.border.topY = static_cast<int>((wordIdx % words) * PG_WORD_BITS) + __builtin_ctzll(word);
+        placement.border.lowX = placement.border.topX + height;
+        placement.border.lowY = placement.border.topY + span;
+    }
+
+    /**
+     Compute the mask of legal anchors for a footprint of the given size against the current occupancy.
+     An anchor (x, y) is legal when rows [x, x+height) and columns [y, y+span) are all unoccupied.
+     The mask is computed a band of rows at a time: the band's rows are OR-ed together, inverted and then
+     AND-ed with itself shifted by 1..span-1 columns.
+     @param height
+        The number of rows the footprint covers.
+     @param span
+        The number of columns the footprint covers.
+     @param legal
+        Receives one row of words per board row. Rows where the footprint doesn't fit are cleared.
+     @return
+        The number of legal anchors.
+    */
+    int PlacementGenerator::legalAnchors(int height, int span, uint64_t* legal)
+    {
+        const int words = occupied_.wordsPerRow();
+        const int tailBits = widthOfBoard_ % PG_WORD_BITS;
+        const uint64_t tailMask = (tailBits == 0) ? ~uint64_t(0) : ((uint64_t(1) << tailBits) - 1);
+        int total = 0;
+
+        std::fill(legal, legal + static_cast<size_t>(lengthOfBoard_) * words, 0);
+        if(height > lengthOfBoard_ || span > widthOfBoard_)
+            return 0;
+
+        for(int x = 0; x + height <= lengthOfBoard_; x++)
+        {
+            /* Free columns across the band of rows */
+            for(int w = 0; w < words; w++)
+            {
+                uint64_t band = 0;
+                for(int r = 0; r < height; r++)
+                    band |= occupied_.row(x + r)[w];
+                free_[w] = ~band & ((w == words - 1) ? tailMask : ~uint64_t(0));
+            }
+
+            /* An anchor is legal when the next span columns are all free. Bits beyond the board are zero. */
+            uint64_t* out = legal + static_cast<size_t>(x) * words;
+            for(int w = 0; w < words; w++)
+            {
+                uint64_t mask = free_[w];
+                for(int k = 1; k < span && mask != 0; k++)
+                {
+                    uint64_t next = (w + 1 < words) ? (free_[w + 1] << (PG_WORD_BITS - k)) : 0;
+                    mask &= (free_[w] >> k) | next;
+                }
+                out[w] = mask;
+                total += __builtin_popcountll(mask);
+            }
+        }
+        return total;
+    }
+
+    /**
+     Determine the rows and columns covered by a vessel in the given direction, consistent with GameBoard::border().
+     @param height
+        Receives the number of rows (x extent) covered.
+     @param span
+        Receives the number of columns (y extent) covered.
+    */
+    void PlacementGenerator::footprint(Vessel::VType vtype, GameBoard::VDirection vdir, int& height, int& span)
+    {
+        int vesselLength, vesselWidth;
+        std::tie(vesselLength, vesselWidth) = Vessel::vesselDimensions(vtype);
+        if(vdir == GameBoard::VDirection::HORIZONTAL)
+        {
+            height = vesselWidth;
+            span = vesselLength;
+        }
+        else
+        {
+            height = vesselLength;
+            span = vesselWidth;
+        }
+    }
+
+    /**
+     Bound the open anchors of a footprint in one direction, whatever way vessels covering the given number
+     of cells lie on the board. Three bounds hold and the least is taken:
+     every covered cell that is itself an in-bounds anchor is closed; a row of the board with k covered cells
+     leaves at most width - span + 1 - k anchors in it, and the covered cells leave the most open when they fill
+     whole rows, the first of them the height - 1 rows that hold no anchors; likewise for the columns.
+     @param covered
+        The number of cells covered by the vessels placed so far.
+     @return
+        The bound, at least as large as the open anchors of any layout of those vessels.
+    */
+    int PlacementGenerator::openBound(int length, int width, int height, int span, int covered)
+    {
+        if(height > length || span > width)
+            return 0;
+        int rows = length - height + 1;
+        int cols = width - span + 1;
+        int bound = rows * cols - std::max(0, covered - (length * width - rows * cols));
+
+        /* Rows first, then columns with the roles swapped */
+        for(int pass = 0; pass < 2; pass++)
+        {
+            int lines = (pass == 0) ? rows : cols;
+            int perLine = (pass == 0) ? cols : rows;
+            int cells = (pass == 0) ? width : length;
+            int spare = (pass == 0) ? height - 1 : span - 1;
+            int rest = std::max(0, covered - spare * cells);
+            int full = std::min(lines, rest / cells);
+            int closed = full * perLine + ((full < lines) ? std::min(rest % cells, perLine) : 0);
+            bound = std::min(bound, lines * perLine - closed);
+        }
+        return std::max(0, bound);
+    }
+}
@@ -0,0 +1,137 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include <memory>
+#include <vector>
+#include "bitboard.h"
+#include "gameboard.h"
+#include "random.h"
+
+#define PG_MAX_ATTEMPTS 1000
+#define PG_PILOT_LAYOUTS 256
+#define PG_EXACT_ACCEPTANCE 0.05
+#define PG_MIN_ACCEPTANCE 1e-4
+#define PG_ATTEMPT_MARGIN 20.0
+#define PG_MAX_COUNT_STATES (1 << 20)
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     @struct VesselPlacement
+     The position of a single vessel within a generated fleet layout.
+     The border always has both corners set, with (lowX, lowY) being exclusive.
+    */
+    struct VesselPlacement
+    {
+        Vessel::VType vtype = Vessel::VType::GUNBOAT;
+        GameBoard::VBorder border;
+        GameBoard::VDirection direction = GameBoard::VDirection::HORIZONTAL;
+    };
+
+    /**
+     @enum LayoutStatus
+     The outcome of a request to generate a fleet layout.
+    */
+    enum class LayoutStatus
+    {
+        LAYOUT_OK,          //A complete layout was generated
+        LAYOUT_RETRY,       //The attempt budget ran out, reseed and try again
+        LAYOUT_FAILED       //The fleet can never fit on the board
+    };
+
+    /**
+     @enum LayoutMode
+     The sampling method used to generate a layout.
+     LAYOUT_UNIFORM makes every valid layout equally likely. It samples like LAYOUT_EXACT when a random attempt
+     succeeds often enough. Otherwise it places each vessel among the open positions like LAYOUT_SEQUENTIAL, but
+     draws from a bound on the open positions that holds whatever the previous vessels did and restarts when the
+     draw lands past the open ones, which keeps every layout equally likely. When even that rarely succeeds it counts
+     the layouts of the fleet and draws one by its index, if the board and fleet are small enough for the counts to be tabled.
+     LAYOUT_EXACT places each vessel uniformly among all in-bounds positions and restarts on the first overlap.
+     Every valid layout is then equally likely, but dense fleets may need a very large attempt budget.
+     LAYOUT_SEQUENTIAL places each vessel uniformly among the positions still open after the previous vessels
+     and restarts on a dead end. It is fast whatever the fleet, but biased: layouts with the first vessels
+     near the edges are too likely. It is the default: a uniform layout of the standard fleet still costs
+     close to a hundred times as much, so LAYOUT_UNIFORM is asked for where the bias matters.
+    */
+    enum class LayoutMode
+    {
+        LAYOUT_UNIFORM,
+        LAYOUT_EXACT,
+        LAYOUT_SEQUENTIAL
+    };
+
+    /**
+     Generates complete random fleet layouts for a board of fixed size using occupancy masks.
+     By default layouts are drawn with LAYOUT_SEQUENTIAL, ask for LAYOUT_UNIFORM for uniformly distributed ones, see LayoutMode.
+     A generator owns its random engine and scratch space so it can be reused to produce layouts at a high rate.
+     Each generator should be used by a single thread.
+    */
+    class PlacementGenerator
+    {
+    public:
+        PlacementGenerator(const std::vector<Vessel::VType>& fleet, int length = GB_BOARD_SIZE, int width = GB_BOARD_SIZE,
+            uint64_t seed = 0, LayoutMode mode = LayoutMode::LAYOUT_SEQUENTIAL);
+
+        LayoutStatus generate(std::vector<VesselPlacement>& layout);
+        void reseed(uint64_t seed);
+        void setMaxAttempts(int attempts);
+        bool isFeasible() const;
+        bool isCounted() const;
+        double acceptance() const;
+
+    private:
+        struct LayoutCounts;
+
+        /**
+         @enum Method
+         How generate() draws a layout: the mode asked for, or for LAYOUT_UNIFORM the method picked for the fleet.
+        */
+        enum class Method
+        {
+            METHOD_SEQUENTIAL,
+            METHOD_EXACT,
+            METHOD_BOUNDED,
+            METHOD_COUNTED
+        };
+
+        bool placeSequential(std::vector<VesselPlacement>& layout, double* exactWeight = nullptr, double* boundedWeight = nullptr);
+        bool placeExact(std::vector<VesselPlacement>& layout);
+        bool placeBounded(std::vector<VesselPlacement>& layout);
+        void placeCounted(std::vector<VesselPlacement>& layout);
+        bool claim(const GameBoard::VBorder& border);
+        uint64_t inBounds(Vessel::VType vtype) const;
+        void inBoundsAnchor(uint64_t pick, VesselPlacement& placement) const;
+        void legalCounts(Vessel::VType vtype, int& countH, int& countV);
+        void legalAnchor(uint64_t pick, int countH, VesselPlacement& placement) const;
+        int legalAnchors(int height, int span, uint64_t* legal);
+        void estimateAcceptance(double& exact, double& bounded);
+
+        static void footprint(Vessel::VType vtype, GameBoard::VDirection vdir, int& height, int& span);
+        static int openBound(int length, int width, int height, int span, int covered);
+        static std::shared_ptr<const LayoutCounts> countLayouts(const std::vector<Vessel::VType>& fleet, int length, int width);
+
+    private:
+        int lengthOfBoard_;
+        int widthOfBoard_;
+        int maxAttempts_;               /**< Restarts allowed per call to generate(), raised for LAYOUT_UNIFORM to PG_ATTEMPT_MARGIN over the acceptance */
+        LayoutMode mode_;
+        Method method_;
+        std::vector<Vessel::VType> fleet_;  /**< Fleet ordered by decreasing footprint */
+        BitBoard occupied_;             /**< Cells covered by vessels placed so far */
+        std::vector<uint64_t> legal_[2];    /**< Scratch masks of legal anchors per direction */
+        std::vector<uint64_t> free_;    /**< Scratch mask of free columns for one band of rows */
+        bool feasible_;                 /**< False if the fleet can never fit on the board */
+        std::vector<uint64_t> bounds_;  /**< Upper bounds on the open positions of each vessel, in fleet order */
+        double acceptance_;             /**< Estimated chance an attempt of the picked method succeeds */
+        std::shared_ptr<const LayoutCounts> counts_;    /**< Layout counts a LAYOUT_UNIFORM generator draws from, if tabled */
+        std::vector<VesselPlacement> drawn_;    /**< Scratch placements of a counted draw, in board order */
+        Xoshiro256 engine_;
+    };
+}
+
+#endif
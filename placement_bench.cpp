@@ -0,0 +1,112 @@
+/**
+ * @file placement_bench.cpp
+ * Measures fleet layout generation throughput in layouts per second.
+ * Usage: placement_bench [layouts]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include "placement.h"
+
+#define BENCH_DEFAULT_LAYOUTS 200000
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ Run the generator for the given number of layouts and print the throughput.
+ @return
+    The number of layouts that were not generated on the first call.
+*/
+static int benchGenerator(const char* label, Cylink::PlacementGenerator& generator, int layouts)
+{
+    std::vector<Cylink::VesselPlacement> layout;
+    int retries = 0;
+
+    auto start = Clock::now();
+    for(int run = 0; run < layouts; run++)
+    {
+        Cylink::LayoutStatus status = generator.generate(layout);
+        while(status == Cylink::LayoutStatus::LAYOUT_RETRY)
+        {
+            retries++;
+            generator.reseed(run + retries);
+            status = generator.generate(layout);
+        }
+        if(status == Cylink::LayoutStatus::LAYOUT_FAILED)
+        {
+            std::cout<<label<<": fleet does not fit\n";
+            return retries;
+        }
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    std::cout<<label<<": "<<static_cast<long long>(layouts / elapsed.count())<<" layouts/second"
+        <<" ("<<retries<<" retries)\n";
+    return retries;
+}
+
+/**
+ Time the existing one-vessel-at-a-time GameBoard::addVessel() path for comparison.
+*/
+static void benchAddVessel(const std::vector<Cylink::Vessel::VType>& fleet, int layouts)
+{
+    int incomplete = 0;
+
+    auto start = Clock::now();
+    for(int run = 0; run < layouts; run++)
+    {
+        Cylink::GameBoard board(GB_BOARD_SIZE, GB_BOARD_SIZE);
+        for(auto vtype : fleet)
+        {
+            if(!board.addVessel(vtype))
+            {
+                incomplete++;
+                break;
+            }
+        }
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    std::cout<<"GameBoard::addVessel: "<<static_cast<long long>(layouts / elapsed.count())<<" layouts/second"
+        <<" ("<<incomplete<<" incomplete)\n";
+}
+
+int main(int argc, char* argv[])
+{
+    int layouts = (argc > 1) ? std::atoi(argv[1]) : BENCH_DEFAULT_LAYOUTS;
+    if(layouts <= 0)
+        layouts = BENCH_DEFAULT_LAYOUTS;
+
+    std::vector<Cylink::Vessel::VType> fleet;
+    fleet.insert(fleet.end(), 1, Cylink::Vessel::VType::CARRIER);
+    fleet.insert(fleet.end(), 3, Cylink::Vessel::VType::CRUISER);
+    fleet.insert(fleet.end(), 3, Cylink::Vessel::VType::DESTROYER);
+    fleet.insert(fleet.end(), 2, Cylink::Vessel::VType::FRIGATE);
+    fleet.insert(fleet.end(), 2, Cylink::Vessel::VType::SUBMARINE);
+
+    std::vector<Cylink::Vessel::VType> sparse = {Cylink::Vessel::VType::CARRIER, Cylink::Vessel::VType::SUBMARINE,
+        Cylink::Vessel::VType::FRIGATE, Cylink::Vessel::VType::CRUISER, Cylink::Vessel::VType::GUNBOAT};
+
+    std::cout<<"Generating "<<layouts<<" layouts per configuration on a "<<GB_BOARD_SIZE<<"x"<<GB_BOARD_SIZE<<" board\n";
+
+    Cylink::PlacementGenerator sequential(fleet, GB_BOARD_SIZE, GB_BOARD_SIZE, 1, Cylink::LayoutMode::LAYOUT_SEQUENTIAL);
+    benchGenerator("Sequential, standard fleet", sequential, layouts);
+
+    Cylink::PlacementGenerator sequentialSparse(sparse, GB_BOARD_SIZE, GB_BOARD_SIZE, 1, Cylink::LayoutMode::LAYOUT_SEQUENTIAL);
+    benchGenerator("Sequential, sparse fleet", sequentialSparse, layouts);
+
+    /* Uniform layouts of the standard fleet cost far more, so they get a smaller sample */
+    Cylink::PlacementGenerator uniform(fleet, GB_BOARD_SIZE, GB_BOARD_SIZE, 1, Cylink::LayoutMode::LAYOUT_UNIFORM);
+    benchGenerator("Uniform, standard fleet", uniform, std::max(1, layouts / 100));
+
+    Cylink::PlacementGenerator uniformSparse(sparse, GB_BOARD_SIZE, GB_BOARD_SIZE, 1, Cylink::LayoutMode::LAYOUT_UNIFORM);
+    benchGenerator("Uniform, sparse fleet", uniformSparse, layouts);
+
+    Cylink::PlacementGenerator exactSparse(sparse, GB_BOARD_SIZE, GB_BOARD_SIZE, 1, Cylink::LayoutMode::LAYOUT_EXACT);
+    exactSparse.setMaxAttempts(100000);
+    benchGenerator("Exact, sparse fleet", exactSparse, layouts);
+
+    benchAddVessel(fleet, layouts / 10);
+    return 0;
+}
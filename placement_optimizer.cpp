@@ -0,0 +1,52 @@
+/**
+ * @file placement_optimizer.cpp
+ * Offline search for fleet layouts that a targeting strategy needs the most shots to sink. Writes a weighted
+ * placement table to stdout for battleship --p1-layouts/--p2-layouts and progress to stderr.
+ * Usage: placement_optimizer STRATEGY [candidates] [keep] [threads] [seed] [fleet file]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include "error.h"
+#include "placementtable.h"
+#include "simulation.h"
+
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char* argv[])
+{
+    if(argc < 2 || argc > 7)
+    {
+        std::cerr<<"Usage: placement_optimizer STRATEGY [candidates] [keep] [threads] [seed] [fleet file]\n";
+        return 1;
+    }
+
+    Cylink::OptimizerConfig config;
+    config.strategy = argv[1];
+    if(argc > 2)
+        config.candidates = std::atoi(argv[2]);
+    if(argc > 3)
+        config.keep = std::atoi(argv[3]);
+    config.threads = (argc > 4) ? std::atoi(argv[4]) : static_cast<int>(std::thread::hardware_concurrency());
+    if(argc > 5)
+        config.seed = std::strtoull(argv[5], nullptr, 10);
+
+    try
+    {
+        config.fleet = (argc > 6) ? Cylink::loadFleet(argv[6]) : Cylink::defaultFleet();
+
+        auto start = Clock::now();
+        Cylink::PlacementTable table = Cylink::optimizePlacements(config, &std::cerr);
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+        std::cerr<<table.size()<<" layouts kept from "<<config.candidates<<" candidates in "<<elapsed.count()<<"s\n";
+
+        table.save(std::cout);
+    }
+    catch(const Cylink::Error& err)
+    {
+        std::cerr<<err.what()<<"\n";
+        return 1;
+    }
+    return 0;
+}
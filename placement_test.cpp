@@ -0,0 +1,154 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <map>
+#include <string>
+#include "layoutstats.h"
+
+TEST_CASE ("Testing Placement Generator", "[PlacementGenerator]")
+{
+    std::vector<Cylink::Vessel::VType> fleet;
+    fleet.insert(fleet.end(), 1, Cylink::Vessel::VType::CARRIER);
+    fleet.insert(fleet.end(), 3, Cylink::Vessel::VType::CRUISER);
+    fleet.insert(fleet.end(), 3, Cylink::Vessel::VType::DESTROYER);
+    fleet.insert(fleet.end(), 2, Cylink::Vessel::VType::FRIGATE);
+    fleet.insert(fleet.end(), 2, Cylink::Vessel::VType::SUBMARINE);
+
+    std::vector<Cylink::VesselPlacement> layout;
+
+    SECTION("Generated layouts are complete and accepted by the GameBoard")
+    {
+        std::cout<<"Testing uniform layouts on a 10x10 board"<<std::endl;
+        Cylink::PlacementGenerator generator(fleet, 10, 10, 42, Cylink::LayoutMode::LAYOUT_UNIFORM);
+        CHECK(generator.acceptance() > 0.0);
+
+        for(int run = 0; run < 200; run++)
+        {
+            REQUIRE(generator.generate(layout) == Cylink::LayoutStatus::LAYOUT_OK);
+            REQUIRE(layout.size() == fleet.size());
+
+            /* emplaceVessel rejects out of bounds and overlapping vessels */
+            Cylink::GameBoard board(10, 10);
+            for(auto& placement : layout)
+            {
+                Cylink::GameBoard::VBorder vrect(placement.border.topX, placement.border.topY);
+                REQUIRE(board.emplaceVessel(vrect, placement.vtype, placement.direction));
+            }
+        }
+    }
+
+    SECTION("Exact layouts on a non-square board")
+    {
+        std::cout<<"Testing exact layouts on a 12x30 board"<<std::endl;
+        std::vector<Cylink::Vessel::VType> sparse = {Cylink::Vessel::VType::CARRIER, Cylink::Vessel::VType::FRIGATE,
+            Cylink::Vessel::VType::GUNBOAT};
+        Cylink::PlacementGenerator generator(sparse, 12, 30, 7, Cylink::LayoutMode::LAYOUT_EXACT);
+
+        for(int run = 0; run < 200; run++)
+        {
+            REQUIRE(generator.generate(layout) == Cylink::LayoutStatus::LAYOUT_OK);
+
+            Cylink::GameBoard board(12, 30);
+            for(auto& placement : layout)
+            {
+                Cylink::GameBoard::VBorder vrect(placement.border.topX, placement.border.topY);
+                REQUIRE(board.emplaceVessel(vrect, placement.vtype, placement.direction));
+            }
+        }
+    }
+
+    SECTION("Failure outcomes are explicit")
+    {
+        std::cout<<"Testing infeasible and exhausted layouts"<<std::endl;
+
+        /* A carrier can never fit on a 5x5 board */
+        Cylink::PlacementGenerator tooSmall(fleet, 5, 5);
+        CHECK_FALSE(tooSmall.isFeasible());
+        CHECK(tooSmall.generate(layout) == Cylink::LayoutStatus::LAYOUT_FAILED);
+        CHECK(layout.empty());
+
+        /* Exact sampling of the dense standard fleet practically never succeeds with a single attempt */
+        Cylink::PlacementGenerator dense(fleet, 10, 10, 1, Cylink::LayoutMode::LAYOUT_EXACT);
+        dense.setMaxAttempts(1);
+        CHECK(dense.generate(layout) == Cylink::LayoutStatus::LAYOUT_RETRY);
+        CHECK(layout.empty());
+    }
+
+    SECTION("Exact occupancy and bias measurement")
+    {
+        std::cout<<"Testing exact layout enumeration and sampler bias"<<std::endl;
+        std::vector<Cylink::Vessel::VType> tiny = {Cylink::Vessel::VType::CRUISER, Cylink::Vessel::VType::GUNBOAT};
+
+        /* 12 cruiser positions on a 3x3 board, each leaving 7 cells for the gunboat */
+        Cylink::OccupancyCounts expected(3, 3);
+        REQUIRE(Cylink::exactOccupancy(tiny, 2, expected));
+        CHECK(expected.layouts == 84);
+        long long covered = 0;
+        for(long long cell : expected.cells)
+            covered += cell;
+        CHECK(covered == 84 * 3);
+
+        /* Exact rejection sampling should be statistically indistinguishable from the enumeration */
+        Cylink::OccupancyCounts observed(3, 3);
+        REQUIRE(Cylink::sampleOccupancy(tiny, Cylink::LayoutSampler::SAMPLER_EXACT, 20000, 2, 3, observed));
+        Cylink::BiasReport report = Cylink::compareOccupancy(observed, expected);
+        CHECK(report.layouts == 20000);
+        CHECK(report.maxCellZ < 5.0);
+        for(auto& bias : report.anchors)
+        {
+            CHECK(bias.impossible == 0);
+            CHECK(bias.zScore < 5.0);
+        }
+    }
+
+    SECTION("Uniform layouts of dense fleets")
+    {
+        std::cout<<"Testing bounded and counted uniform layouts"<<std::endl;
+        std::vector<Cylink::Vessel::VType> dense = {Cylink::Vessel::VType::CARRIER, Cylink::Vessel::VType::SUBMARINE,
+            Cylink::Vessel::VType::DESTROYER, Cylink::Vessel::VType::FRIGATE, Cylink::Vessel::VType::CRUISER,
+            Cylink::Vessel::VType::GUNBOAT};
+
+        /* 34 of 35 cells covered: plain rejection rarely succeeds, so bounded rejection is picked */
+        Cylink::PlacementGenerator bounded(dense, 5, 7, 0, Cylink::LayoutMode::LAYOUT_UNIFORM);
+        CHECK(bounded.acceptance() < PG_EXACT_ACCEPTANCE);
+        CHECK_FALSE(bounded.isCounted());
+
+        Cylink::OccupancyCounts expected(5, 7);
+        REQUIRE(Cylink::exactOccupancy(dense, 2, expected));
+        Cylink::OccupancyCounts observed(5, 7);
+        REQUIRE(Cylink::sampleOccupancy(dense, Cylink::LayoutSampler::SAMPLER_UNIFORM, 20000, 2, 5, observed));
+        Cylink::BiasReport report = Cylink::compareOccupancy(observed, expected);
+        CHECK(report.maxCellZ < 5.0);
+        for(auto& bias : report.anchors)
+        {
+            CHECK(bias.impossible == 0);
+            CHECK(bias.zScore < 5.0);
+        }
+
+        /* Twelve frigates tile a 6x6 board in 64 ways, too dense even for bounded rejection */
+        std::vector<Cylink::Vessel::VType> frigates(12, Cylink::Vessel::VType::FRIGATE);
+        Cylink::PlacementGenerator counted(frigates, 6, 6, 11, Cylink::LayoutMode::LAYOUT_UNIFORM);
+        REQUIRE(counted.isCounted());
+
+        const int tilings = 64, draws = 300 * tilings;
+        std::map<std::string, int> seen;
+        for(int run = 0; run < draws; run++)
+        {
+            REQUIRE(counted.generate(layout) == Cylink::LayoutStatus::LAYOUT_OK);
+            REQUIRE(layout.size() == frigates.size());
+
+            Cylink::GameBoard board(6, 6);
+            std::string tiling(36, '.');
+            for(auto& placement : layout)
+            {
+                Cylink::GameBoard::VBorder vrect(placement.border.topX, placement.border.topY);
+                REQUIRE(board.emplaceVessel(vrect, placement.vtype, placement.direction));
+                tiling[placement.border.topX * 6 + placement.border.topY] =
+                    (placement.direction == Cylink::GameBoard::VDirection::HORIZONTAL) ? 'H' : 'V';
+            }
+            seen[tiling]++;
+        }
+        CHECK(seen.size() == static_cast<size_t>(tilings));
+        for(auto& entry : seen)
+            CHECK(std::abs(entry.second - 300) < 5.0 * std::sqrt(300.0));
+    }
+}
@@ -0,0 +1,433 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "placementtable.h"
+#include "error.h"
+#include "player.h"
+#include "random.h"
+#include "scheduler.h"
+
+#define PT_ARG_ERROR ErrorCode::ERR_INVALID_ARG
+#define PT_IO_ERROR ErrorCode::ERR_IO
+#define PT_SCALE 4294967296.0
+#define PT_HEADER "# highseas placement table"
+#define PT_MOVE_ATTEMPTS 64
+#define PT_STREAM_MOVES 0
+
+namespace Cylink
+{
+    /**
+     Create an empty table for layouts of a board of the given size.
+    */
+    PlacementTable::PlacementTable(int length, int width)
+        : lengthOfBoard_(length), widthOfBoard_(width), layouts_(), weights_(), threshold_(), alias_()
+    {
+    }
+
+    /**
+     Add a layout. The table must be built again before sampling.
+     A weight that isn't positive and finite will result in an exception.
+     @param layout
+        A complete, legal fleet layout for the table's board.
+     @param weight
+        The relative probability of drawing the layout.
+    */
+    void PlacementTable::add(const std::vector<VesselPlacement>& layout, double weight)
+    {
+        if(!(weight > 0.0) || !std::isfinite(weight))
+        {
+            Error argError("Layout weights must be positive.", PT_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        layouts_.push_back(layout);
+        weights_.push_back(weight);
+        threshold_.clear();
+        alias_.clear();
+    }
+
+    /**
+     Build the alias tables with Vose's method: columns whose scaled weight is below one are topped up by an alias
+     taken from a column above one, so every column holds exactly one unit of probability.
+    */
+    void PlacementTable::build()
+    {
+        size_t count = layouts_.size();
+        threshold_.assign(count, 0);
+        alias_.resize(count);
+
+        double total = 0.0;
+        for(double weight : weights_)
+            total += weight;
+
+        std::vector<double> scaled(count);
+        std::vector<uint32_t> small, large;
+        for(size_t idx = 0; idx < count; idx++)
+        {
+            scaled[idx] = weights_[idx] * count / total;
+            alias_[idx] = static_cast<uint32_t>(idx);
+            (scaled[idx] < 1.0 ? small : large).push_back(static_cast<uint32_t>(idx));
+        }
+        while(!small.empty() && !large.empty())
+        {
+            uint32_t less = small.back();
+            uint32_t more = large.back();
+            small.pop_back();
+            threshold_[less] = static_cast<uint64_t>(scaled[less] * PT_SCALE);
+            alias_[less] = more;
+            scaled[more] -= 1.0 - scaled[less];
+            if(scaled[more] < 1.0)
+            {
+                large.pop_back();
+                small.push_back(more);
+            }
+        }
+        /* Whatever is left holds a full unit up to rounding */
+        for(uint32_t idx : large)
+            threshold_[idx] = static_cast<uint64_t>(PT_SCALE);
+        for(uint32_t idx : small)
+            threshold_[idx] = static_cast<uint64_t>(PT_SCALE);
+    }
+
+    /**
+     Draw a layout. The low half of the random word picks a column, the high half decides between the column's
+     layout and its alias. Sampling an empty or unbuilt table will result in an exception.
+     @param random
+        A uniformly random 64-bit word.
+     @return
+        The drawn layout.
+    */
+    const std::vector<VesselPlacement>& PlacementTable::sample(uint64_t random) const
+    {
+        if(threshold_.empty())
+        {
+            Error argError("The placement table is empty or not built.", PT_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        size_t column = static_cast<size_t>(((random & 0xFFFFFFFFULL) * threshold_.size()) >> 32);
+        return layouts_[((random >> 32) < threshold_[column]) ? column : alias_[column]];
+    }
+
+    size_t PlacementTable::size() const
+    {
+        return layouts_.size();
+    }
+
+    int PlacementTable::getLength() const
+    {
+        return lengthOfBoard_;
+    }
+
+    int PlacementTable::getWidth() const
+    {
+        return widthOfBoard_;
+    }
+
+    const std::vector<VesselPlacement>& PlacementTable::layout(size_t idx) const
+    {
+        return layouts_.at(idx);
+    }
+
+    double PlacementTable::weight(size_t idx) const
+    {
+        return weights_.at(idx);
+    }
+
+    /**
+     Write the table as text: a header line, the board size and layout count, then one line per layout holding
+     its weight, its vessel count and each vessel as its short name, top corner and H or V.
+    */
+    void PlacementTable::save(std::ostream& os) const
+    {
+        os<<PT_HEADER<<"\n"<<lengthOfBoard_<<" "<<widthOfBoard_<<" "<<layouts_.size()<<"\n";
+        for(size_t idx = 0; idx < layouts_.size(); idx++)
+        {
+            os<<weights_[idx]<<" "<<layouts_[idx].size();
+            for(auto& placement : layouts_[idx])
+            {
+                os<<" "<<Vessel::formatVessel(placement.vtype, false)<<" "<<placement.border.topX<<" "<<placement.border.topY
+                  <<" "<<((placement.direction == GameBoard::VDirection::HORIZONTAL) ? "H" : "V");
+            }
+            os<<"\n";
+        }
+    }
+
+    /**
+     Read a table written by save() and build it. Every layout is placed on a board to check it is legal.
+     Malformed input, illegal layouts or an empty table result in an exception.
+    */
+    PlacementTable PlacementTable::load(std::istream& is)
+    {
+        std::string line;
+        while(std::getline(is, line) && (line.empty() || line[0] == '#'))
+            ;
+        std::istringstream header(line);
+        int length = 0, width = 0;
+        size_t count = 0;
+        if(!(header>>length>>width>>count) || length <= 0 || width <= 0 || count == 0)
+        {
+            Error argError("Invalid placement table header.", PT_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+
+        PlacementTable table(length, width);
+        GameBoard board(length, width);
+        for(size_t idx = 0; idx < count; idx++)
+        {
+            bool valid = static_cast<bool>(std::getline(is, line));
+            std::istringstream entry(line);
+            double weight = 0.0;
+            size_t vessels = 0;
+            valid = valid && (entry>>weight>>vessels) && vessels > 0 && weight > 0.0;
+
+            std::vector<VesselPlacement> layout;
+            board.clear();
+            for(size_t vessel = 0; valid && vessel < vessels; vessel++)
+            {
+                std::string code, direction;
+                VesselPlacement placement;
+                valid = static_cast<bool>(entry>>code>>placement.border.topX>>placement.border.topY>>direction)
+                    && (direction == "H" || direction == "V");
+                bool found = false;
+                for(int type = static_cast<int>(Vessel::VType::GUNBOAT); !found && type <= static_cast<int>(Vessel::VType::CARRIER); type++)
+                {
+                    placement.vtype = static_cast<Vessel::VType>(type);
+                    found = (code == Vessel::formatVessel(placement.vtype, false));
+                }
+                placement.direction = (direction == "V") ? GameBoard::VDirection::VERTICAL : GameBoard::VDirection::HORIZONTAL;
+
+                std::error_code ec;
+                valid = valid && found && board.emplaceVessel(placement.border, placement.vtype, placement.direction, ec);
+                layout.push_back(placement);
+            }
+
+            if(!valid)
+            {
+                Error argError("Invalid placement table entry " + std::to_string(idx + 1) + ".", PT_ARG_ERROR, __FILE__, __LINE__);
+                throw argError;
+            }
+            table.add(layout, weight);
+        }
+        table.build();
+        return table;
+    }
+
+    /**
+     Read a table from a file. See load(std::istream&).
+    */
+    PlacementTable PlacementTable::load(const std::string& path)
+    {
+        std::ifstream file(path);
+        if(!file)
+        {
+            Error ioError("Unable to open placement table " + path + ".", PT_IO_ERROR, __FILE__, __LINE__);
+            throw ioError;
+        }
+        return load(file);
+    }
+
+    /**
+     @struct Candidate
+     A layout under evaluation and the shots the targeting strategy needed against it so far.
+    */
+    struct Candidate
+    {
+        std::vector<VesselPlacement> layout;
+        uint64_t id = 0;                    /**< Unique within a search, picks the candidate's games */
+        long long shots = 0;
+        long long games = 0;
+
+        double meanShots() const
+        {
+            return games ? static_cast<double>(shots) / games : 0.0;
+        }
+    };
+
+    /**
+     Derive the strategy seed of one evaluation game, so results don't depend on the thread count.
+    */
+    static uint64_t gameSeed(uint64_t seed, size_t candidate, long long game)
+    {
+        uint64_t z = seed + 0x9E3779B97F4A7C15ULL * (static_cast<uint64_t>(candidate) * 0x100000001ULL + game + 1);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     @struct Duel
+     The players one pool thread plays evaluation games with, kept for the whole search.
+    */
+    struct Duel
+    {
+        Player attacker;
+        Player defender;
+
+        Duel(const OptimizerConfig& config) : attacker(config.length, config.width), defender(config.length, config.width)
+        {
+            std::unique_ptr<Strategy> strategy = Strategy::create(config.strategy, config.length, config.width);
+            strategy->setFleet(config.fleet);
+            attacker.setStrategy(std::move(strategy));
+        }
+    };
+
+    /**
+     Play config.roundGames games of the targeting strategy against every listed candidate on the pool, one task
+     per candidate. Each game counts the shots needed to sink the whole fleet.
+    */
+    static void evaluate(const OptimizerConfig& config, ThreadPool& threads, std::vector<std::unique_ptr<Duel>>& duels,
+        std::vector<Candidate>& pool, const std::vector<size_t>& alive)
+    {
+        const int maxShots = config.length * config.width;
+        threads.run(alive.size(), [&](size_t task, int worker)
+        {
+            Duel& duel = *duels[worker];
+            Candidate& candidate = pool[alive[task]];
+            for(int game = 0; game < config.roundGames; game++)
+            {
+                duel.attacker.reset(gameSeed(config.seed, candidate.id, candidate.games));
+                duel.defender.reset(0);
+                duel.defender.setupBoard(candidate.layout);
+                int shots = 0;
+                while(duel.defender.hasVessels() && shots < maxShots)
+                {
+                    std::pair<int, int> position = duel.attacker.suggestFirePosition();
+                    duel.attacker.launchAttack(duel.defender, position.first, position.second);
+                    shots++;
+                }
+                candidate.shots += shots;
+                candidate.games++;
+            }
+        });
+    }
+
+    /**
+     A local move: take one vessel out of a layout and put it back at a random position where
+     GameBoard::emplaceVessel() accepts it among the others. Rejected positions are redrawn, up to
+     PT_MOVE_ATTEMPTS times.
+     @return
+        True if the vessel moved, otherwise the layout is unchanged.
+    */
+    static bool moveVessel(std::vector<VesselPlacement>& layout, int length, int width, Xoshiro256& engine)
+    {
+        GameBoard board(length, width);
+        size_t moved = engine.below(layout.size());
+        for(size_t idx = 0; idx < layout.size(); idx++)
+        {
+            GameBoard::VBorder vrect = layout[idx].border;
+            if(idx != moved)
+                board.emplaceVessel(vrect, layout[idx].vtype, layout[idx].direction);
+        }
+        for(int attempt = 0; attempt < PT_MOVE_ATTEMPTS; attempt++)
+        {
+            GameBoard::VBorder vrect(engine.below(length), engine.below(width));
+            GameBoard::VDirection vdir = engine.below(2) ? GameBoard::VDirection::VERTICAL : GameBoard::VDirection::HORIZONTAL;
+            if(board.emplaceVessel(vrect, layout[moved].vtype, vdir))
+            {
+                layout[moved].border = vrect;
+                layout[moved].direction = vdir;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     Search for layouts that take a targeting strategy the most shots to sink. The pool starts from
+     config.candidates random layouts. Every round each live candidate plays config.roundGames more games, and
+     the half needing the fewest shots is dropped. For the first config.rounds rounds the dropped places are
+     refilled with local moves of survivors (see moveVessel()), so the search explores around the best layouts
+     found so far. After that the pool is halved down to config.keep candidates.
+     The survivors make up the table with softmax weights exp((shots - best) / config.temperature), so harder
+     layouts are drawn more often while the defense stays mixed. Invalid settings or an unknown strategy
+     result in an exception.
+     @param config
+        The search settings.
+     @param log
+        If not null, progress is written to it once per round.
+     @return
+        The built table.
+    */
+    PlacementTable optimizePlacements(const OptimizerConfig& config, std::ostream* log)
+    {
+        if(config.fleet.empty() || config.candidates <= 0 || config.roundGames <= 0 || config.keep <= 0 || config.rounds < 0
+            || !(config.temperature > 0.0))
+        {
+            Error argError("Invalid placement optimizer settings.", PT_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        Strategy::create(config.strategy, config.length, config.width);
+
+        std::vector<Candidate> pool(config.candidates);
+        PlacementGenerator generator(config.fleet, config.length, config.width, config.seed);
+        uint64_t layoutSeed = config.seed;
+        uint64_t nextId = 0;
+        for(auto& candidate : pool)
+        {
+            candidate.id = nextId++;
+            LayoutStatus status = generator.generate(candidate.layout);
+            while(status == LayoutStatus::LAYOUT_RETRY)
+            {
+                generator.reseed(++layoutSeed);
+                status = generator.generate(candidate.layout);
+            }
+            if(status == LayoutStatus::LAYOUT_FAILED)
+            {
+                Error argError("The fleet does not fit on the board.", PT_ARG_ERROR, __FILE__, __LINE__);
+                throw argError;
+            }
+        }
+
+        std::vector<size_t> alive(pool.size());
+        for(size_t idx = 0; idx < alive.size(); idx++)
+            alive[idx] = idx;
+
+        ThreadPool threads(std::max(1, config.threads));
+        std::vector<std::unique_ptr<Duel>> duels;
+        for(int idx = 0; idx < threads.threads(); idx++)
+            duels.push_back(std::make_unique<Duel>(config));
+        Xoshiro256 engine(streamSeed(config.seed, 0, PT_STREAM_MOVES));
+
+        for(int round = 1; ; round++)
+        {
+            evaluate(config, threads, duels, pool, alive);
+            std::stable_sort(alive.begin(), alive.end(), [&pool](size_t left, size_t right)
+            {
+                return pool[left].meanShots() > pool[right].meanShots();
+            });
+            if(log)
+            {
+                *log<<"round "<<round<<": "<<alive.size()<<" candidates, best "<<pool[alive.front()].meanShots()
+                    <<" worst "<<pool[alive.back()].meanShots()<<" shots over "<<pool[alive.front()].games<<" games\n";
+            }
+            size_t survivors = std::max<size_t>(config.keep, (alive.size() + 1) / 2);
+            if(round > config.rounds)
+            {
+                if(alive.size() <= static_cast<size_t>(config.keep))
+                    break;
+                alive.resize(survivors);
+                continue;
+            }
+            for(size_t slot = survivors; slot < alive.size(); slot++)
+            {
+                Candidate& child = pool[alive[slot]];
+                child = Candidate();
+                child.layout = pool[alive[engine.below(survivors)]].layout;
+                child.id = nextId++;
+                moveVessel(child.layout, config.length, config.width, engine);
+            }
+        }
+
+        PlacementTable table(config.length, config.width);
+        double best = pool[alive.front()].meanShots();
+        for(size_t idx : alive)
+        {
+            double weight = std::exp((pool[idx].meanShots() - best) / config.temperature);
+            table.add(pool[idx].layout, std::max(weight, std::numeric_limits<double>::min()));
+        }
+        table.build();
+        return table;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef PLACEMENTTABLE_H
+#define PLACEMENTTABLE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "placement.h"
+
+#define PT_CANDIDATES 256
+#define PT_ROUND_GAMES 8
+#define PT_KEEP 16
+#define PT_ROUNDS 8
+#define PT_TEMPERATURE 2.0
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     A weighted set of complete fleet layouts for one board size. Once built, a layout is drawn in O(1)
+     with Walker's alias method: one random word picks a column and decides between the column's own
+     layout and its alias.
+    */
+    class PlacementTable
+    {
+    public:
+        PlacementTable(int length = GB_BOARD_SIZE, int width = GB_BOARD_SIZE);
+
+        void add(const std::vector<VesselPlacement>& layout, double weight);
+        void build();
+        const std::vector<VesselPlacement>& sample(uint64_t random) const;
+
+        size_t size() const;
+        int getLength() const;
+        int getWidth() const;
+        const std::vector<VesselPlacement>& layout(size_t idx) const;
+        double weight(size_t idx) const;
+
+        void save(std::ostream& os) const;
+        static PlacementTable load(std::istream& is);
+        static PlacementTable load(const std::string& path);
+
+    private:
+        int lengthOfBoard_;
+        int widthOfBoard_;
+        std::vector<std::vector<VesselPlacement>> layouts_;
+        std::vector<double> weights_;
+        std::vector<uint64_t> threshold_;   /**< Column keeps its own layout below this, scaled to 2^32 */
+        std::vector<uint32_t> alias_;       /**< Layout drawn when the column's threshold is exceeded */
+    };
+
+    /**
+     @struct OptimizerConfig
+     Settings for optimizePlacements(). Declaration shows default field values.
+    */
+    struct OptimizerConfig
+    {
+        int length = GB_BOARD_SIZE;
+        int width = GB_BOARD_SIZE;
+        std::vector<Vessel::VType> fleet;   /**< Must not be empty */
+        std::string strategy = "random";    /**< The targeting strategy played against */
+        int candidates = PT_CANDIDATES;     /**< Random layouts the search starts from */
+        int roundGames = PT_ROUND_GAMES;    /**< Games each surviving candidate plays per round */
+        int keep = PT_KEEP;                 /**< Layouts in the resulting table */
+        int rounds = PT_ROUNDS;             /**< Rounds that refill the pool with moved layouts before the final halving */
+        double temperature = PT_TEMPERATURE;    /**< Shots by which a layout's weight falls by a factor e, must be positive */
+        int threads = 1;
+        uint64_t seed = 0;
+    };
+
+    PlacementTable optimizePlacements(const OptimizerConfig& config, std::ostream* log = nullptr);
+}
+
+#endif
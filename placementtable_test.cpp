@@ -0,0 +1,159 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <sstream>
+#include "error.h"
+#include "placementtable.h"
+#include "simulation.h"
+
+/**
+ A single gunboat layout at the given position.
+*/
+static std::vector<Cylink::VesselPlacement> gunboatAt(int x, int y)
+{
+    Cylink::VesselPlacement placement;
+    placement.border = Cylink::GameBoard::VBorder(x, y, x + 1, y + 1);
+    return {placement};
+}
+
+TEST_CASE ("Testing PlacementTable", "[PlacementTable]")
+{
+    SECTION("Alias sampling follows the weights")
+    {
+        std::cout<<"Testing placement table sampling"<<std::endl;
+        Cylink::PlacementTable table;
+        CHECK_THROWS_AS(table.sample(0), Cylink::Error);
+        CHECK_THROWS_AS(table.add(gunboatAt(0, 0), 0.0), Cylink::Error);
+
+        const double weights[4] = {1.0, 2.0, 5.0, 0.5};
+        for(int idx = 0; idx < 4; idx++)
+            table.add(gunboatAt(idx, 0), weights[idx]);
+        table.build();
+
+        std::mt19937_64 engine(3);
+        const int draws = 170000;
+        int counts[4] = {0, 0, 0, 0};
+        for(int draw = 0; draw < draws; draw++)
+            counts[table.sample(engine()).front().border.topX]++;
+        for(int idx = 0; idx < 4; idx++)
+        {
+            double expected = weights[idx] / 8.5;
+            double observed = static_cast<double>(counts[idx]) / draws;
+            CHECK(observed > expected - 0.01);
+            CHECK(observed < expected + 0.01);
+        }
+    }
+
+    SECTION("Tables survive a save and load")
+    {
+        std::cout<<"Testing placement table files"<<std::endl;
+        Cylink::PlacementGenerator generator(Cylink::defaultFleet(), GB_BOARD_SIZE, GB_BOARD_SIZE, 11);
+        Cylink::PlacementTable table;
+        std::vector<Cylink::VesselPlacement> layout;
+        for(int idx = 0; idx < 5; idx++)
+        {
+            REQUIRE(generator.generate(layout) == Cylink::LayoutStatus::LAYOUT_OK);
+            table.add(layout, idx + 1.0);
+        }
+        table.build();
+
+        std::stringstream file;
+        table.save(file);
+        Cylink::PlacementTable loaded = Cylink::PlacementTable::load(file);
+        REQUIRE(loaded.size() == table.size());
+        for(size_t idx = 0; idx < table.size(); idx++)
+        {
+            CHECK(loaded.weight(idx) == table.weight(idx));
+            REQUIRE(loaded.layout(idx).size() == table.layout(idx).size());
+            for(size_t vessel = 0; vessel < table.layout(idx).size(); vessel++)
+            {
+                const Cylink::VesselPlacement& left = loaded.layout(idx)[vessel];
+                const Cylink::VesselPlacement& right = table.layout(idx)[vessel];
+                CHECK(left.vtype == right.vtype);
+                CHECK(left.direction == right.direction);
+                CHECK(left.border.topX == right.border.topX);
+                CHECK(left.border.topY == right.border.topY);
+                CHECK(left.border.lowX == right.border.lowX);
+                CHECK(left.border.lowY == right.border.lowY);
+            }
+        }
+
+        std::istringstream overlapping("10 10 1\n1 2 GB 3 3 H GB 3 3 H\n");
+        CHECK_THROWS_AS(Cylink::PlacementTable::load(overlapping), Cylink::Error);
+        std::istringstream offBoard("10 10 1\n1 1 CA 9 9 H\n");
+        CHECK_THROWS_AS(Cylink::PlacementTable::load(offBoard), Cylink::Error);
+        std::istringstream truncated("10 10 2\n1 1 GB 0 0 H\n");
+        CHECK_THROWS_AS(Cylink::PlacementTable::load(truncated), Cylink::Error);
+        std::istringstream empty("# nothing\n");
+        CHECK_THROWS_AS(Cylink::PlacementTable::load(empty), Cylink::Error);
+    }
+
+    SECTION("Optimized layouts hold out longer")
+    {
+        std::cout<<"Testing the placement optimizer"<<std::endl;
+        Cylink::OptimizerConfig config;
+        config.fleet = {Cylink::Vessel::VType::FRIGATE, Cylink::Vessel::VType::CRUISER};
+        config.strategy = "scan";
+        config.candidates = 16;
+        config.roundGames = 1;
+        config.keep = 4;
+        config.threads = 2;
+        config.seed = 5;
+
+        /* Row by row scanning sinks a layout once it reaches the last vessel cell, so the search pushes vessels down */
+        auto scanShots = [](const std::vector<Cylink::VesselPlacement>& layout)
+        {
+            int last = 0;
+            for(auto& placement : layout)
+                last = std::max(last, (placement.border.lowX - 1) * GB_BOARD_SIZE + placement.border.lowY);
+            return last;
+        };
+        Cylink::PlacementTable table = Cylink::optimizePlacements(config);
+        REQUIRE(table.size() == 4);
+        int fewest = GB_BOARD_SIZE * GB_BOARD_SIZE;
+        for(size_t idx = 0; idx < table.size(); idx++)
+        {
+            fewest = std::min(fewest, scanShots(table.layout(idx)));
+            CHECK(table.weight(idx) > 0.0);
+            CHECK(table.weight(idx) <= 1.0);
+        }
+        CHECK(table.weight(0) == 1.0);
+        CHECK(fewest >= GB_BOARD_SIZE * GB_BOARD_SIZE - 2);
+
+        /* Without local moves the table can only hold layouts of the initial sample */
+        config.rounds = 0;
+        Cylink::PlacementTable sampled = Cylink::optimizePlacements(config);
+        int sampledFewest = GB_BOARD_SIZE * GB_BOARD_SIZE;
+        for(size_t idx = 0; idx < sampled.size(); idx++)
+            sampledFewest = std::min(sampledFewest, scanShots(sampled.layout(idx)));
+        CHECK(sampledFewest < fewest);
+        config.rounds = PT_ROUNDS;
+
+        config.temperature = 0.0;
+        CHECK_THROWS_AS(Cylink::optimizePlacements(config), Cylink::Error);
+        config.temperature = PT_TEMPERATURE;
+
+        config.keep = 0;
+        CHECK_THROWS_AS(Cylink::optimizePlacements(config), Cylink::Error);
+
+        /* Games draw the defender's layouts from the table */
+        Cylink::SimulationConfig simulation;
+        simulation.fleet = config.fleet;
+        simulation.games = 20;
+        simulation.strategy[0] = "scan";
+        simulation.placements[1] = std::make_shared<Cylink::PlacementTable>(table);
+        std::ostringstream out;
+        CHECK(Cylink::runSimulation(simulation, out).games == 20);
+
+        simulation.length = 12;
+        CHECK_THROWS_AS(Cylink::runSimulation(simulation, out), Cylink::Error);
+
+        /* Tables must hold layouts of the run's fleet */
+        simulation.length = GB_BOARD_SIZE;
+        simulation.fleet.push_back(Cylink::Vessel::VType::SUBMARINE);
+        CHECK_THROWS_AS(Cylink::runSimulation(simulation, out), Cylink::Error);
+        simulation.fleet = {Cylink::Vessel::VType::CRUISER, Cylink::Vessel::VType::FRIGATE};
+        CHECK(Cylink::runSimulation(simulation, out).games == 20);
+    }
+}
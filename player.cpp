@@ -1,7 +1,23 @@
 #include "player.h"
+#include "instrument.h"
 
 namespace Cylink
 {
+   /**
+    Board observer noting the type of the vessel an attack destroyed.
+   */
+   struct SinkObserver : public NullBoardObserver
+   {
+      bool destroyed = false;
+      Vessel::VType vtype = Vessel::VType::GUNBOAT;
+
+      void onDestroyed(int xCord, int yCord, const Vessel& vessel)
+      {
+         destroyed = true;
+         vtype = vessel.getType();
+      }
+   };
+
    /**
     Create a player for battle ship and assign them a board of the size specified by the parameters.
    If no parameters are specified a 10 x 10 board is assumed and created.
@@ -11,7 +27,8 @@ namespace Cylink
    The height of the board.
    */
    Player::Player(int boardLength, int boardHeight)
-   : board_(boardLength, boardHeight)
+   : board_(boardLength, boardHeight),
+     strategy_(new RandomStrategy(boardLength, boardHeight, GameBoard::randomNumber(0, RAND_MAX)))
    {
    }
 
@@ -21,7 +38,7 @@ namespace Cylink
    An existing Player object used to copy initialize the new object.
    */
    Player::Player(const Player& other)
-   : board_(other.board_)
+   : board_(other.board_), strategy_(other.strategy_->clone())
    {
    }
 
@@ -44,6 +61,7 @@ namespace Cylink
       if(this != &other)
       {
          board_ = other.board_;
+         strategy_ = other.strategy_->clone();
       }
       return *this;
    }
@@ -69,25 +87,183 @@ namespace Cylink
       return result;
    }
 
+   /**
+    Sets up the player's game board with a complete fleet layout produced by the generator.
+    Unlike adding vessels one at a time, either the whole fleet is placed or the board is left untouched.
+    @param generator
+      A generator configured with the fleet and the dimensions of the player's board.
+    @return
+      LAYOUT_OK if the fleet was placed, otherwise the generator's failure outcome.
+   */
+   LayoutStatus Player::setupBoard(PlacementGenerator& generator)
+   {
+      std::vector<VesselPlacement> layout;
+      LayoutStatus result = generator.generate(layout);
+      if(result == LayoutStatus::LAYOUT_OK)
+      {
+         for(auto& placement : layout)
+         {
+            board_.emplaceVessel(placement.border, placement.vtype, placement.direction);
+         }
+      }
+      return result;
+   }
+
+   /**
+    Sets up the player's game board with a given fleet layout. Either the whole fleet is placed or the board is cleared.
+    @param layout
+      The vessels to place, eg. from a PlacementTable.
+    @return
+      True if every vessel was placed.
+   */
+   bool Player::setupBoard(const std::vector<VesselPlacement>& layout)
+   {
+      for(auto placement : layout)
+      {
+         std::error_code ec;
+         if(!board_.emplaceVessel(placement.border, placement.vtype, placement.direction, ec))
+         {
+            board_.clear();
+            return false;
+         }
+      }
+      return true;
+   }
+
+   /**
+    Sets up the player's game board with a layout drawn from a placement table in constant time.
+    @param table
+      A built table for the dimensions of the player's board.
+    @param random
+      A uniformly random 64-bit word choosing the layout.
+    @return
+      True if every vessel of the drawn layout was placed, otherwise the board is left clear.
+   */
+   bool Player::setupBoard(const PlacementTable& table, uint64_t random)
+   {
+      return setupBoard(table.sample(random));
+   }
+
+   /**
+    Place one vessel at a chosen position, as a remote player lays out their fleet.
+    Positions off the board are rejected like overlapping ones, without an exception.
+    @param vrect
+      The (topX, topY) corner of the vessel. On success the full border is filled in.
+    @return
+      True if the vessel was placed.
+   */
+   bool Player::placeVessel(GameBoard::VBorder& vrect, Vessel::VType vtype, GameBoard::VDirection vdir)
+   {
+      std::error_code ec;
+      return board_.emplaceVessel(vrect, vtype, vdir, ec);
+   }
+
+   /**
+    Replace the strategy the player uses to choose where to fire.
+    @param strategy
+      The new strategy. A null strategy is ignored.
+   */
+   void Player::setStrategy(std::unique_ptr<Strategy> strategy)
+   {
+      if(strategy)
+      {
+         strategy_ = std::move(strategy);
+      }
+   }
+
+   /**
+    Prepare the player for a new game by clearing the board and resetting the strategy.
+    Allocated storage is kept so players can be reused for many games.
+    @param seed
+      Seed for the strategy's randomness.
+   */
+   void Player::reset(uint64_t seed)
+   {
+      board_.clear();
+      strategy_->reset(seed);
+   }
+
+   /**
+    Ask the player's strategy for the next position to fire at.
+    @return
+      The (x, y) coordinates to fire at.
+   */
    std::pair<int, int> Player::suggestFirePosition()
    {
+      HS_TIME(SUGGEST_FIRE);
+      return strategy_->suggestFirePosition(board_);
+   }
+
+   /**
+    @return
+      True if the player's strategy answers asynchronously, see requestFirePosition().
+   */
+   bool Player::firesAsync() const
+   {
+      return strategy_->isAsync();
    }
 
-   void Player::launchAttack(Player& other, int xCord, int yCord)
+   /**
+    Ask an asynchronous strategy for the next position to fire at. The answer arrives through the request.
+   */
+   void Player::requestFirePosition(FireRequest& request)
+   {
+      strategy_->requestFirePosition(board_, request);
+   }
+
+   /**
+    Fire at the opponent and record the result on both boards. The strategy is told the result and the type of any
+    vessel the shot destroyed.
+    @param other
+      The opponent being attacked.
+    @param xCord
+      The x coordinate to attack.
+    @param yCord
+      The y coordinate to attack.
+    @return
+      The result of the attack.
+   */
+   GameBoard::StrikeResult Player::launchAttack(Player& other, int xCord, int yCord)
    {
+      //update opponents game board with attack information, noting the type of a vessel destroyed.
+      SinkObserver sunk;
       GameBoard::VBorder vrect(xCord, yCord);
-      //update opponents game board with attack information.
-      GameBoard::StrikeResult sResult = other.board_.logReceivedAttack(vrect);
+      GameBoard::StrikeResult sResult = other.board_.logReceivedAttack(vrect, sunk);
       //log the launch information 
       board_.logLaunchedAttack(vrect, sResult);
+      strategy_->recordResult(xCord, yCord, sResult);
+      if(sunk.destroyed)
+         strategy_->recordSunk(sunk.vtype);
+      return sResult;
+   }
+
+   /**
+    Record an attack from the opponent on the player's board.
+    @return
+      The result of the attack.
+   */
+   GameBoard::StrikeResult Player::receiveAttack(int xpos, int ypos)
+   {
+      GameBoard::VBorder vrect(xpos, ypos);
+      return board_.logReceivedAttack(vrect);
    }
 
-   int Player::receiveAttack(int xpos, int ypos)
+   /**
+    @return
+      True while the player has at least one vessel that hasn't been destroyed.
+   */
+   bool Player::hasVessels() const
    {
+      return board_.activeVessels() > 0;
    }
 
-   bool Player::hasVessels()
+   /**
+    @return
+      The player's game board.
+   */
+   const GameBoard& Player::getBoard() const
    {
+      return board_;
    }
 
-}
\ No newline at end of file
+}
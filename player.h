@@ -2,7 +2,11 @@
 #define PLAYER_H
 
 #include <iostream>
+#include <memory>
 #include "gameboard.h"
+#include "placement.h"
+#include "placementtable.h"
+#include "strategy.h"
 
 #define BOARD_SIZE 10
 
@@ -14,6 +18,8 @@ namespace Cylink
 {
     /**
      Models a player within the highseas game.
+     A player is cache line aligned through its board, and its strategy through the Strategy base class, so
+     players of different games never share a line.
     */
     class Player
     {
@@ -24,17 +30,26 @@ namespace Cylink
 
         Player& operator = (const Player& other);
         int setupBoard(const std::vector<Vessel::VType>& vessels);
-        //GameBoard::StrikeResult launchAttack(Player& other, int xpos, int ypos);
-        void launchAttack(Player& other, int xCord, int yCord);
-        bool hasVessels();
+        LayoutStatus setupBoard(PlacementGenerator& generator);
+        bool setupBoard(const std::vector<VesselPlacement>& layout);
+        bool setupBoard(const PlacementTable& table, uint64_t random);
+        bool placeVessel(GameBoard::VBorder& vrect, Vessel::VType vtype, GameBoard::VDirection vdir);
+        void setStrategy(std::unique_ptr<Strategy> strategy);
+        void reset(uint64_t seed);
+        GameBoard::StrikeResult launchAttack(Player& other, int xCord, int yCord);
+        bool hasVessels() const;
         std::pair<int, int> suggestFirePosition();
+        bool firesAsync() const;
+        void requestFirePosition(FireRequest& request);
+        const GameBoard& getBoard() const;
     
     private:
-        int receiveAttack(int xpos, int ypos);
+        GameBoard::StrikeResult receiveAttack(int xpos, int ypos);
 
     private:
         GameBoard board_; 
+        std::unique_ptr<Strategy> strategy_;    /**< Chooses where the player fires */
     };
 }
 
-#endif
\ No newline at end of file
+#endif
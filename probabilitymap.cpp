@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <tuple>
+
+#include "probabilitymap.h"
+#include "error.h"
+
+#define PM_ARG_ERROR ErrorCode::ERR_INVALID_ARG
+
+namespace Cylink
+{
+    /**
+     Enumerate every placement of the fleet's vessel classes and index them by the cells they cover.
+     Dimensions that aren't positive result in an exception.
+     @param fleet
+        The opponent's fleet.
+    */
+    ProbabilityMap::ProbabilityMap(const std::vector<Vessel::VType>& fleet, int length, int width)
+        : lengthOfBoard_(length), widthOfBoard_(width), placements_(), footprint_(), coverStart_(), cover_(),
+          classStart_(), fleet_(), afloat_(), possible_(), initialHeat_(), heat_()
+    {
+        if(length <= 0 || width <= 0)
+        {
+            Error argError("Board dimensions must be positive.", PM_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        for(Vessel::VType vtype : fleet)
+            fleet_[static_cast<int>(vtype)]++;
+
+        std::vector<int> covering(static_cast<size_t>(length) * width, 0);
+        for(int type = 0; type < PM_VESSEL_TYPES; type++)
+        {
+            classStart_[type] = static_cast<int>(placements_.size());
+            if(fleet_[type] == 0)
+                continue;
+            int vesselLength, vesselWidth;
+            std::tie(vesselLength, vesselWidth) = Vessel::vesselDimensions(static_cast<Vessel::VType>(type));
+            /* Both directions, once for a square footprint */
+            for(int dir = 0; dir < ((vesselLength == vesselWidth) ? 1 : 2); dir++)
+            {
+                int height = dir ? vesselLength : vesselWidth;
+                int span = dir ? vesselWidth : vesselLength;
+                for(int x = 0; x + height <= length; x++)
+                {
+                    for(int y = 0; y + span <= width; y++)
+                    {
+                        Placement placement = {static_cast<Vessel::VType>(type), static_cast<int>(footprint_.size()), height * span};
+                        for(int cx = x; cx < x + height; cx++)
+                        {
+                            for(int cy = y; cy < y + span; cy++)
+                            {
+                                footprint_.push_back(cx * width + cy);
+                                covering[cx * width + cy]++;
+                            }
+                        }
+                        placements_.push_back(placement);
+                    }
+                }
+            }
+        }
+        classStart_[PM_VESSEL_TYPES] = static_cast<int>(placements_.size());
+
+        coverStart_.assign(covering.size() + 1, 0);
+        for(size_t cell = 0; cell < covering.size(); cell++)
+            coverStart_[cell + 1] = coverStart_[cell] + covering[cell];
+        cover_.resize(coverStart_.back());
+        std::vector<int> fill(coverStart_.begin(), coverStart_.end() - 1);
+        for(size_t idx = 0; idx < placements_.size(); idx++)
+        {
+            const Placement& placement = placements_[idx];
+            for(int cell = placement.first; cell < placement.first + placement.count; cell++)
+                cover_[fill[footprint_[cell]]++] = static_cast<int>(idx);
+        }
+
+        std::copy(fleet_, fleet_ + PM_VESSEL_TYPES, afloat_);
+        possible_.assign(placements_.size(), 1);
+        initialHeat_ = recompute();
+        heat_ = initialHeat_;
+    }
+
+    /**
+     Return to the start of a game: every placement possible and the whole fleet afloat.
+    */
+    void ProbabilityMap::reset()
+    {
+        std::copy(fleet_, fleet_ + PM_VESSEL_TYPES, afloat_);
+        std::fill(possible_.begin(), possible_.end(), 1);
+        std::copy(initialHeat_.begin(), initialHeat_.end(), heat_.begin());
+    }
+
+    /**
+     Observe a launched attack. A miss rules out every placement covering the cell. Hits leave the placements
+     through the cell possible. Coordinates off the board are ignored.
+    */
+    void ProbabilityMap::onLaunched(int xCord, int yCord, GameBoard::StrikeResult result)
+    {
+        if(result != GameBoard::StrikeResult::STRIKE_MISS || xCord < 0 || xCord >= lengthOfBoard_ || yCord < 0 || yCord >= widthOfBoard_)
+            return;
+        int cell = xCord * widthOfBoard_ + yCord;
+        for(int idx = coverStart_[cell]; idx < coverStart_[cell + 1]; idx++)
+        {
+            int placement = cover_[idx];
+            if(possible_[placement])
+            {
+                possible_[placement] = 0;
+                removePlacement(placement, afloat_[static_cast<int>(placements_[placement].vtype)]);
+            }
+        }
+    }
+
+    /**
+     Observe a sunk vessel: its class carries one vessel less, so each of the class's possible placements
+     contributes one less to the cells it covers.
+    */
+    void ProbabilityMap::onSunk(Vessel::VType vtype)
+    {
+        int type = static_cast<int>(vtype);
+        if(afloat_[type] == 0)
+            return;
+        afloat_[type]--;
+        for(int placement = classStart_[type]; placement < classStart_[type + 1]; placement++)
+        {
+            if(possible_[placement])
+                removePlacement(placement, 1);
+        }
+    }
+
+    void ProbabilityMap::removePlacement(int placement, int weight)
+    {
+        const Placement& entry = placements_[placement];
+        for(int cell = entry.first; cell < entry.first + entry.count; cell++)
+            heat_[footprint_[cell]] -= weight;
+    }
+
+    int ProbabilityMap::heat(int xCord, int yCord) const
+    {
+        return heat_[xCord * widthOfBoard_ + yCord];
+    }
+
+    /**
+     @return
+        The heat of every cell, indexed x * width + y.
+    */
+    const std::vector<int>& ProbabilityMap::heatMap() const
+    {
+        return heat_;
+    }
+
+    /**
+     Count the heat of every cell from scratch, the way the map would without incremental updates.
+     @return
+        The heat of every cell, indexed x * width + y.
+    */
+    std::vector<int> ProbabilityMap::recompute() const
+    {
+        std::vector<int> heat(static_cast<size_t>(lengthOfBoard_) * widthOfBoard_, 0);
+        for(size_t idx = 0; idx < placements_.size(); idx++)
+        {
+            if(!possible_[idx])
+                continue;
+            const Placement& placement = placements_[idx];
+            int weight = afloat_[static_cast<int>(placement.vtype)];
+            for(int cell = placement.first; cell < placement.first + placement.count; cell++)
+                heat[footprint_[cell]] += weight;
+        }
+        return heat;
+    }
+
+    /**
+     @return
+        The number of placements enumerated.
+    */
+    int ProbabilityMap::placements() const
+    {
+        return static_cast<int>(placements_.size());
+    }
+
+    int ProbabilityMap::getLength() const
+    {
+        return lengthOfBoard_;
+    }
+
+    int ProbabilityMap::getWidth() const
+    {
+        return widthOfBoard_;
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef PROBABILITYMAP_H
+#define PROBABILITYMAP_H
+
+#include <vector>
+#include "gameboard.h"
+
+#define PM_VESSEL_TYPES 6
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     Targeting heatmap kept up to date incrementally. Every in-bounds placement of every vessel class in the
+     opponent's fleet is enumerated once, together with an index of the placements covering each cell.
+     A cell's heat is the number of still possible placements covering it, weighted by how many vessels of
+     the placement's class are afloat. A miss only visits the placements covering the missed cell and a sunk
+     vessel only its own class's placements, instead of recounting every placement on every cell.
+     The map is an observer for GameBoard::logLaunchedAttack().
+    */
+    class ProbabilityMap
+    {
+    public:
+        ProbabilityMap(const std::vector<Vessel::VType>& fleet, int length = GB_BOARD_SIZE, int width = GB_BOARD_SIZE);
+
+        void reset();
+        void onLaunched(int xCord, int yCord, GameBoard::StrikeResult result);
+        void onSunk(Vessel::VType vtype);
+
+        int heat(int xCord, int yCord) const;
+        const std::vector<int>& heatMap() const;
+        std::vector<int> recompute() const;
+        int placements() const;
+        int getLength() const;
+        int getWidth() const;
+
+    private:
+        /**
+         @struct Placement
+         One in-bounds position of a vessel class. Its cells are footprint_[first, first + count).
+        */
+        struct Placement
+        {
+            Vessel::VType vtype;
+            int first;
+            int count;
+        };
+
+        void removePlacement(int placement, int weight);
+
+    private:
+        int lengthOfBoard_;
+        int widthOfBoard_;
+        std::vector<Placement> placements_;
+        std::vector<int> footprint_;        /**< Cells of every placement, back to back */
+        std::vector<int> coverStart_;       /**< Placements covering cell c are cover_[coverStart_[c], coverStart_[c + 1]) */
+        std::vector<int> cover_;
+        int classStart_[PM_VESSEL_TYPES + 1];   /**< Placements are grouped by class in VType order */
+        int fleet_[PM_VESSEL_TYPES];        /**< Vessels of each class in the fleet */
+        int afloat_[PM_VESSEL_TYPES];       /**< Vessels of each class not sunk yet */
+        std::vector<char> possible_;        /**< Placement doesn't cover a miss */
+        std::vector<int> initialHeat_;
+        std::vector<int> heat_;
+    };
+}
+
+#endif
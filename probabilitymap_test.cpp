@@ -0,0 +1,116 @@
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include "error.h"
+#include "probabilitymap.h"
+#include "simulation.h"
+#include "strategy.h"
+
+TEST_CASE ("Testing ProbabilityMap", "[ProbabilityMap]")
+{
+    SECTION("Placements are counted per cell")
+    {
+        std::cout<<"Testing probability map counts"<<std::endl;
+        /* A cruiser is 2 long: on a 1 x 3 board it fits twice horizontally and not at all vertically */
+        Cylink::ProbabilityMap strip({Cylink::Vessel::VType::CRUISER}, 1, 3);
+        CHECK(strip.placements() == 2);
+        CHECK(strip.heat(0, 0) == 1);
+        CHECK(strip.heat(0, 1) == 2);
+        CHECK(strip.heat(0, 2) == 1);
+
+        /* Two cruisers weigh every placement twice */
+        Cylink::ProbabilityMap pair({Cylink::Vessel::VType::CRUISER, Cylink::Vessel::VType::CRUISER}, 1, 3);
+        CHECK(pair.heat(0, 1) == 4);
+        pair.onSunk(Cylink::Vessel::VType::CRUISER);
+        CHECK(pair.heat(0, 1) == 2);
+        pair.onLaunched(0, 0, Cylink::GameBoard::StrikeResult::STRIKE_MISS);
+        CHECK(pair.heat(0, 0) == 0);
+        CHECK(pair.heat(0, 1) == 1);
+        CHECK(pair.heat(0, 2) == 1);
+        pair.reset();
+        CHECK(pair.heat(0, 1) == 4);
+
+        CHECK_THROWS_AS(Cylink::ProbabilityMap({Cylink::Vessel::VType::CRUISER}, 0, 3), Cylink::Error);
+    }
+
+    SECTION("Incremental updates match a full recount")
+    {
+        std::cout<<"Testing incremental probability updates"<<std::endl;
+        std::vector<Cylink::Vessel::VType> fleet = Cylink::defaultFleet();
+        Cylink::ProbabilityMap map(fleet, GB_BOARD_SIZE, GB_BOARD_SIZE);
+        std::mt19937_64 engine(17);
+        for(int game = 0; game < 20; game++)
+        {
+            map.reset();
+            std::vector<Cylink::Vessel::VType> afloat = fleet;
+            for(int shot = 0; shot < 60; shot++)
+            {
+                int x = static_cast<int>(engine() % GB_BOARD_SIZE);
+                int y = static_cast<int>(engine() % GB_BOARD_SIZE);
+                map.onLaunched(x, y, (engine() % 3) ? Cylink::GameBoard::StrikeResult::STRIKE_MISS
+                                                    : Cylink::GameBoard::StrikeResult::STRIKE_HIT);
+                if(!afloat.empty() && engine() % 8 == 0)
+                {
+                    size_t idx = engine() % afloat.size();
+                    map.onSunk(afloat[idx]);
+                    afloat.erase(afloat.begin() + idx);
+                }
+                REQUIRE(map.heatMap() == map.recompute());
+            }
+        }
+    }
+
+    SECTION("The map observes launched attacks on a game board")
+    {
+        std::cout<<"Testing probability map observers"<<std::endl;
+        Cylink::GameBoard board;
+        Cylink::ProbabilityMap map({Cylink::Vessel::VType::CARRIER}, GB_BOARD_SIZE, GB_BOARD_SIZE);
+        int before = map.heat(5, 5);
+
+        Cylink::GameBoard::VBorder miss(5, 5);
+        board.logLaunchedAttack(miss, Cylink::GameBoard::StrikeResult::STRIKE_MISS, map);
+        CHECK(board.cellAt(5, 5).launched == Cylink::GameBoard::StrikeType::STYPE_FAIL);
+        CHECK(map.heat(5, 5) == 0);
+        CHECK(map.heat(5, 6) < before);
+        CHECK(map.heatMap() == map.recompute());
+
+        /* Attacks off the board are neither logged nor observed */
+        std::vector<int> heat = map.heatMap();
+        Cylink::GameBoard::VBorder outside(GB_BOARD_SIZE, 0);
+        board.logLaunchedAttack(outside, Cylink::GameBoard::StrikeResult::STRIKE_MISS, map);
+        CHECK(map.heatMap() == heat);
+    }
+
+    SECTION("Density targeting prunes misses reported through recordResult")
+    {
+        std::cout<<"Testing density misses"<<std::endl;
+        Cylink::DensityStrategy strategy(GB_BOARD_SIZE, GB_BOARD_SIZE, 3);
+        strategy.setFleet(Cylink::defaultFleet());
+        strategy.reset(3);
+        REQUIRE(strategy.map().heat(4, 4) > 0);
+        strategy.recordResult(4, 4, Cylink::GameBoard::StrikeResult::STRIKE_MISS);
+        CHECK(strategy.map().heat(4, 4) == 0);
+        CHECK(strategy.map().heatMap() == strategy.map().recompute());
+    }
+
+    SECTION("Density targeting beats parity targeting")
+    {
+        std::cout<<"Testing density games"<<std::endl;
+        Cylink::SimulationConfig config;
+        config.fleet = Cylink::defaultFleet();
+        config.seed = 43;
+        config.strategy[0] = "density";
+        config.strategy[1] = "parity";
+
+        Cylink::GameRunner runner(config);
+        int wins = 0, losses = 0;
+        for(long long game = 0; game < 200; game++)
+        {
+            Cylink::GameResult result = runner.play(game);
+            if(result.winner == SIM_PLAYER1)
+                wins++;
+            else if(result.winner == SIM_PLAYER2)
+                losses++;
+        }
+        CHECK(wins > losses);
+    }
+}
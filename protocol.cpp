@@ -0,0 +1,229 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "protocol.h"
+#include "error.h"
+
+#define PROTO_ARG_ERROR ErrorCode::ERR_INVALID_ARG
+#define PROTO_IO_ERROR ErrorCode::ERR_IO
+
+namespace Cylink
+{
+    static const char* const messageNames[PROTO_MESSAGE_TYPES] = {"invalid", "new_game", "place", "fire", "resign"};
+
+    static inline void putShort(uint8_t* pos, uint16_t value)
+    {
+        pos[0] = static_cast<uint8_t>(value);
+        pos[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    static inline uint16_t getShort(const uint8_t* pos)
+    {
+        return static_cast<uint16_t>(pos[0] | (pos[1] << 8));
+    }
+
+    /**
+     Turn an address into a socket address.
+     @return
+        The length of the socket address written to storage.
+    */
+    static socklen_t socketAddress(const std::string& address, sockaddr_storage& storage)
+    {
+        std::memset(&storage, 0, sizeof(storage));
+        if(address.compare(0, 5, "unix:") == 0)
+        {
+            std::string path = address.substr(5);
+            sockaddr_un* local = reinterpret_cast<sockaddr_un*>(&storage);
+            if(!path.empty() && path.size() < sizeof(local->sun_path))
+            {
+                local->sun_family = AF_UNIX;
+                std::memcpy(local->sun_path, path.c_str(), path.size() + 1);
+                return sizeof(sockaddr_un);
+            }
+        }
+        else if(address.compare(0, 4, "tcp:") == 0)
+        {
+            char* end = nullptr;
+            long port = std::strtol(address.c_str() + 4, &end, 10);
+            if(address.size() > 4 && *end == '\0' && port >= 0 && port <= 65535)
+            {
+                sockaddr_in* inet = reinterpret_cast<sockaddr_in*>(&storage);
+                inet->sin_family = AF_INET;
+                inet->sin_port = htons(static_cast<uint16_t>(port));
+                inet->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                return sizeof(sockaddr_in);
+            }
+        }
+
+        Error argError("Invalid address " + address + ", use unix:PATH or tcp:PORT.", PROTO_ARG_ERROR, __FILE__, __LINE__);
+        throw argError;
+    }
+
+    /**
+     Close a socket and report the failed call that made it useless.
+    */
+    [[noreturn]] static void socketError(int fd, const char* call, const std::string& address)
+    {
+        int error = errno;
+        if(fd >= 0)
+            ::close(fd);
+        Error ioError(std::string(call) + " " + address + ": " + std::strerror(error), PROTO_IO_ERROR, __FILE__, __LINE__);
+        throw ioError;
+    }
+
+    void Protocol::encode(const Request& request, uint8_t* frame)
+    {
+        frame[0] = static_cast<uint8_t>(request.type);
+        frame[1] = request.arg;
+        putShort(frame + 2, request.x);
+        putShort(frame + 4, request.y);
+        putShort(frame + 6, 0);
+    }
+
+    void Protocol::encode(const Response& response, uint8_t* frame)
+    {
+        frame[0] = static_cast<uint8_t>(response.type);
+        frame[1] = static_cast<uint8_t>(response.status);
+        frame[2] = response.result;
+        frame[3] = response.reply;
+        putShort(frame + 4, response.x);
+        putShort(frame + 6, response.y);
+    }
+
+    /**
+     Decode a request frame. An unknown message type decodes as MSG_INVALID.
+    */
+    Request Protocol::decodeRequest(const uint8_t* frame)
+    {
+        Request request;
+        request.type = (frame[0] < PROTO_MESSAGE_TYPES) ? static_cast<MessageType>(frame[0]) : MessageType::MSG_INVALID;
+        request.arg = frame[1];
+        request.x = getShort(frame + 2);
+        request.y = getShort(frame + 4);
+        return request;
+    }
+
+    Response Protocol::decodeResponse(const uint8_t* frame)
+    {
+        Response response;
+        response.type = (frame[0] < PROTO_MESSAGE_TYPES) ? static_cast<MessageType>(frame[0]) : MessageType::MSG_INVALID;
+        response.status = static_cast<ReplyStatus>(frame[1]);
+        response.result = frame[2];
+        response.reply = frame[3];
+        response.x = getShort(frame + 4);
+        response.y = getShort(frame + 6);
+        return response;
+    }
+
+    /**
+     Open a non-blocking listening socket. A stale Unix domain socket left at the path is removed first,
+     any other file there is left alone and makes bind() fail.
+     @param address
+        unix:PATH or tcp:PORT, port 0 picks a free port (see localAddress()).
+     @param backlog
+        The length of the queue of pending connections.
+     @return
+        The listening socket.
+    */
+    int Protocol::listen(const std::string& address, int backlog)
+    {
+        sockaddr_storage storage;
+        socklen_t length = socketAddress(address, storage);
+
+        int fd = ::socket(storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if(fd < 0)
+            socketError(fd, "socket", address);
+
+        if(storage.ss_family == AF_UNIX)
+        {
+            const char* path = reinterpret_cast<sockaddr_un*>(&storage)->sun_path;
+            struct stat info;
+            if(::stat(path, &info) == 0 && S_ISSOCK(info.st_mode))
+                ::unlink(path);
+        }
+        else
+        {
+            int reuse = 1;
+            ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        }
+
+        if(::bind(fd, reinterpret_cast<sockaddr*>(&storage), length) != 0)
+            socketError(fd, "bind", address);
+        if(::listen(fd, backlog) != 0)
+            socketError(fd, "listen", address);
+        return fd;
+    }
+
+    /**
+     Open a blocking connection to a server. Nagle's algorithm is turned off on TCP connections since
+     every frame is a complete request.
+    */
+    int Protocol::connect(const std::string& address)
+    {
+        sockaddr_storage storage;
+        socklen_t length = socketAddress(address, storage);
+
+        int fd = ::socket(storage.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if(fd < 0)
+            socketError(fd, "socket", address);
+        if(::connect(fd, reinterpret_cast<sockaddr*>(&storage), length) != 0)
+            socketError(fd, "connect", address);
+        if(storage.ss_family == AF_INET)
+        {
+            int noDelay = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        return fd;
+    }
+
+    /**
+     @return
+        The address a listening socket is bound to, in the form connect() accepts.
+    */
+    std::string Protocol::localAddress(int fd)
+    {
+        sockaddr_storage storage;
+        socklen_t length = sizeof(storage);
+        if(::getsockname(fd, reinterpret_cast<sockaddr*>(&storage), &length) != 0)
+            socketError(-1, "getsockname", std::to_string(fd));
+
+        if(storage.ss_family == AF_UNIX)
+            return std::string("unix:") + reinterpret_cast<sockaddr_un*>(&storage)->sun_path;
+        return "tcp:" + std::to_string(ntohs(reinterpret_cast<sockaddr_in*>(&storage)->sin_port));
+    }
+
+    const char* Protocol::messageName(MessageType type)
+    {
+        return messageNames[static_cast<size_t>(type) < PROTO_MESSAGE_TYPES ? static_cast<size_t>(type) : 0];
+    }
+
+    /**
+     Write one line of latency quantiles in microseconds for every message type that was seen.
+    */
+    std::ostream& Protocol::writeLatencies(std::ostream& os, const LatencyTable& latencies)
+    {
+        std::ios_base::fmtflags flags = os.flags();
+        os<<std::fixed<<std::setprecision(1);
+        for(size_t type = 0; type < latencies.size(); type++)
+        {
+            const LatencyHistogram& lat = latencies[type];
+            if(lat.count() == 0)
+                continue;
+            os<<std::left<<std::setw(10)<<messageNames[type]<<std::right<<"count "<<lat.count()
+              <<"  latency (us): mean "<<lat.mean() / 1000.0<<"  p50 "<<lat.quantile(0.5) / 1000.0
+              <<"  p99 "<<lat.quantile(0.99) / 1000.0<<"  p99.9 "<<lat.quantile(0.999) / 1000.0
+              <<"  max "<<lat.max() / 1000.0<<"\n";
+        }
+        os.flags(flags);
+        return os;
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "statistics.h"
+
+#define PROTO_FRAME_BYTES 8
+#define PROTO_MESSAGE_TYPES 5
+#define PROTO_AUTO_PLACE 0x01
+#define PROTO_VERTICAL 0x80
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     @enum MessageType
+     The requests a client can send to the game server.
+    */
+    enum class MessageType : uint8_t
+    {
+        MSG_INVALID,
+        MSG_NEW_GAME,           //Start a game, arg PROTO_AUTO_PLACE lets the server place the client's fleet
+        MSG_PLACE,              //Place a vessel at (x, y), arg is the VType, or'ed with PROTO_VERTICAL
+        MSG_FIRE,               //Fire at (x, y) on the server's board
+        MSG_RESIGN              //Give up the current game
+    };
+
+    /**
+     @enum ReplyStatus
+     The outcome of a request.
+    */
+    enum class ReplyStatus : uint8_t
+    {
+        STATUS_OK,
+        STATUS_WON,             //The client's shot sank the server's last vessel
+        STATUS_LOST,            //The server's reply shot sank the client's last vessel, or the client resigned
+        STATUS_REJECTED         //The request is malformed or not allowed in the current phase of the game
+    };
+
+    /**
+     @struct Request
+     A client request. Every request is sent as one PROTO_FRAME_BYTES frame:
+     type, arg, x and y little endian, two reserved bytes.
+    */
+    struct Request
+    {
+        MessageType type = MessageType::MSG_INVALID;
+        uint8_t arg = 0;
+        uint16_t x = 0;
+        uint16_t y = 0;
+    };
+
+    /**
+     @struct Response
+     The server's answer to a request, also sent as one PROTO_FRAME_BYTES frame: type, status, result, reply,
+     x and y little endian. Responses arrive in request order.
+     For MSG_NEW_GAME (x, y) is the board size and result the number of vessels in the fleet.
+     For MSG_PLACE result is 1 if the vessel was placed.
+     For MSG_FIRE result is the StrikeResult of the client's shot and, unless the client won, (x, y) and reply
+     are the server's shot back and its StrikeResult.
+    */
+    struct Response
+    {
+        MessageType type = MessageType::MSG_INVALID;
+        ReplyStatus status = ReplyStatus::STATUS_REJECTED;
+        uint8_t result = 0;
+        uint8_t reply = 0;
+        uint16_t x = 0;
+        uint16_t y = 0;
+    };
+
+    using LatencyTable = std::array<LatencyHistogram, PROTO_MESSAGE_TYPES>;    /**< Latencies indexed by MessageType */
+
+    /**
+     Encoding of protocol frames and the sockets they travel over.
+     Addresses are "unix:PATH" for a Unix domain socket or "tcp:PORT" for the loopback interface.
+    */
+    class Protocol
+    {
+    public:
+        static void encode(const Request& request, uint8_t* frame);
+        static void encode(const Response& response, uint8_t* frame);
+        static Request decodeRequest(const uint8_t* frame);
+        static Response decodeResponse(const uint8_t* frame);
+
+        static int listen(const std::string& address, int backlog);
+        static int connect(const std::string& address);
+        static std::string localAddress(int fd);
+
+        static const char* messageName(MessageType type);
+        static std::ostream& writeLatencies(std::ostream& os, const LatencyTable& latencies);
+    };
+}
+
+#endif
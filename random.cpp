@@ -0,0 +1,111 @@
+#include <cmath>
+#include <numbers>
+
+#include "random.h"
+
+namespace Cylink
+{
+    /**
+     Create a generator with the given seed, see seed().
+    */
+    Xoshiro256::Xoshiro256(uint64_t seed)
+        : state_()
+    {
+        this->seed(seed);
+    }
+
+    /**
+     Restart the generator. The state is expanded from the seed with SplitMix64, which never yields the
+     all zero state xoshiro can't leave.
+    */
+    void Xoshiro256::seed(uint64_t seed)
+    {
+        SplitMix64 expand(seed);
+        for(auto& word : state_)
+            word = expand();
+    }
+
+    /**
+     Draw a uniform number in [0, bound) by multiplying into 128 bits and rejecting the few products
+     that would favour some numbers. Unlike std::uniform_int_distribution the result is the same on
+     every standard library.
+     @param bound
+        One more than the largest number wanted, must not be 0.
+    */
+    uint64_t Xoshiro256::below(uint64_t bound)
+    {
+        unsigned __int128 product = static_cast<unsigned __int128>((*this)()) * bound;
+        uint64_t low = static_cast<uint64_t>(product);
+        if(low < bound)
+        {
+            uint64_t threshold = -bound % bound;
+            while(low < threshold)
+            {
+                product = static_cast<unsigned __int128>((*this)()) * bound;
+                low = static_cast<uint64_t>(product);
+            }
+        }
+        return static_cast<uint64_t>(product >> 64);
+    }
+
+    /**
+     Draw a standard normal number with the Box-Muller transform, keeping only the cosine half so the
+     generator's four words remain its whole state. Unlike std::normal_distribution the draws are the
+     same on every standard library.
+    */
+    double Xoshiro256::normal()
+    {
+        /* 1 - unit() lies in (0, 1], so the logarithm is finite */
+        double radius = std::sqrt(-2.0 * std::log(1.0 - unit()));
+        return radius * std::cos(2.0 * std::numbers::pi * unit());
+    }
+
+    /**
+     Copy out the generator's state, eg. to save it in a checkpoint.
+    */
+    void Xoshiro256::getState(uint64_t words[4]) const
+    {
+        for(int idx = 0; idx < 4; idx++)
+            words[idx] = state_[idx];
+    }
+
+    /**
+     Restore a state saved with getState().
+     @return
+        False, leaving the generator unchanged, if every word is zero, a state xoshiro never reaches.
+    */
+    bool Xoshiro256::setState(const uint64_t words[4])
+    {
+        if((words[0] | words[1] | words[2] | words[3]) == 0)
+            return false;
+        for(int idx = 0; idx < 4; idx++)
+            state_[idx] = words[idx];
+        return true;
+    }
+
+    bool Xoshiro256::operator==(const Xoshiro256& other) const
+    {
+        for(int idx = 0; idx < 4; idx++)
+        {
+            if(state_[idx] != other.state_[idx])
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     Derive the seed of one random stream from a run seed, eg. the layout stream of player 2 in game 734211.
+     The seed depends only on its arguments, so any game can be replayed without playing the games before it,
+     on any thread and in any order.
+     @param seed
+        The run seed.
+     @param index
+        The game, or other unit of work, the stream belongs to.
+     @param stream
+        Which of the unit's streams, 0 to 7.
+    */
+    uint64_t streamSeed(uint64_t seed, long long index, int stream)
+    {
+        return SplitMix64(seed + 0x9E3779B97F4A7C15ULL * (static_cast<uint64_t>(index) * 8 + stream))();
+    }
+}
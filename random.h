@@ -0,0 +1,95 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     SplitMix64 generator. Every output is a strong mix of a counter, so it also serves to expand one seed
+     into the state of other generators and to derive independent seeds from (seed, index) pairs.
+    */
+    class SplitMix64
+    {
+    public:
+        using result_type = uint64_t;
+
+        explicit SplitMix64(uint64_t seed = 0) : state_(seed) {}
+
+        uint64_t operator()()
+        {
+            uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        static constexpr uint64_t min() { return 0; }
+        static constexpr uint64_t max() { return std::numeric_limits<uint64_t>::max(); }
+
+    private:
+        uint64_t state_;
+    };
+
+    /**
+     xoshiro256** generator, the engine of every game's random streams. Its 32 bytes of state are seeded
+     from one 64 bit value in a few instructions, where std::mt19937_64 fills 2.5KB, so every game and player
+     can cheaply get a fresh stream derived with streamSeed(). Output depends only on the seed, so a stream
+     plays the same on any thread and with any standard library.
+    */
+    class Xoshiro256
+    {
+    public:
+        using result_type = uint64_t;
+
+        explicit Xoshiro256(uint64_t seed = 0);
+
+        void seed(uint64_t seed);
+        uint64_t below(uint64_t bound);
+        double normal();
+        void getState(uint64_t words[4]) const;
+        bool setState(const uint64_t words[4]);
+
+        /** @return A uniform number in [0, 1) with 53 random bits. */
+        double unit()
+        {
+            return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+        }
+
+        uint64_t operator()()
+        {
+            uint64_t result = rotate(state_[1] * 5, 7) * 9;
+            uint64_t t = state_[1] << 17;
+            state_[2] ^= state_[0];
+            state_[3] ^= state_[1];
+            state_[1] ^= state_[2];
+            state_[0] ^= state_[3];
+            state_[2] ^= t;
+            state_[3] = rotate(state_[3], 45);
+            return result;
+        }
+
+        bool operator==(const Xoshiro256& other) const;
+
+        static constexpr uint64_t min() { return 0; }
+        static constexpr uint64_t max() { return std::numeric_limits<uint64_t>::max(); }
+
+    private:
+        static uint64_t rotate(uint64_t value, int bits)
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+    private:
+        uint64_t state_[4];
+    };
+
+    uint64_t streamSeed(uint64_t seed, long long index, int stream);
+}
+
+#endif
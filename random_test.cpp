@@ -0,0 +1,131 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "error.h"
+#include "gameboard.h"
+#include "random.h"
+#include "simulation.h"
+
+/**
+ Split a run's output into its game record lines, sorted since threads finish games out of order.
+*/
+static std::vector<std::string> sortedRecords(const std::string& text)
+{
+    std::vector<std::string> lines;
+    std::istringstream is(text);
+    std::string line;
+    std::getline(is, line);
+    while(std::getline(is, line))
+        lines.push_back(line);
+    std::sort(lines.begin(), lines.end());
+    return lines;
+}
+
+TEST_CASE ("Testing Random", "[Random]")
+{
+    SECTION("Streams depend only on their seed")
+    {
+        std::cout<<"Testing random streams"<<std::endl;
+        /* Reference output of SplitMix64 seeded with 0 */
+        Cylink::SplitMix64 split(0);
+        CHECK(split() == 0xE220A8397B1DCDAFULL);
+
+        Cylink::Xoshiro256 first(42), second(7);
+        CHECK_FALSE(first == second);
+        second.seed(42);
+        CHECK(first == second);
+        for(int idx = 0; idx < 100; idx++)
+            CHECK(first() == second());
+
+        std::vector<int> counts(6, 0);
+        for(int idx = 0; idx < 6000; idx++)
+        {
+            uint64_t value = first.below(6);
+            REQUIRE(value < 6);
+            counts[value]++;
+            double unit = first.unit();
+            REQUIRE(unit >= 0.0);
+            REQUIRE(unit < 1.0);
+        }
+        CHECK(*std::min_element(counts.begin(), counts.end()) > 850);
+
+        /* Normal draws have zero mean and unit variance, and a restored state continues the stream */
+        double sum = 0.0, squares = 0.0;
+        for(int idx = 0; idx < 20000; idx++)
+        {
+            double value = first.normal();
+            sum += value;
+            squares += value * value;
+        }
+        CHECK(std::abs(sum / 20000) < 0.05);
+        CHECK(std::abs(squares / 20000 - 1.0) < 0.05);
+        uint64_t words[4];
+        first.getState(words);
+        CHECK(second.setState(words));
+        CHECK(second == first);
+        CHECK(second.normal() == first.normal());
+        uint64_t zero[4] = {0, 0, 0, 0};
+        CHECK_FALSE(second.setState(zero));
+        CHECK(second == first);
+
+        /* Neighbouring games and streams get unrelated seeds */
+        CHECK(Cylink::streamSeed(1, 734211, 0) == Cylink::streamSeed(1, 734211, 0));
+        CHECK(Cylink::streamSeed(1, 734211, 0) != Cylink::streamSeed(1, 734211, 1));
+        CHECK(Cylink::streamSeed(1, 734211, 0) != Cylink::streamSeed(1, 734212, 0));
+        CHECK(Cylink::streamSeed(1, 734211, 0) != Cylink::streamSeed(2, 734211, 0));
+    }
+
+    SECTION("Seeded boards place vessels the same way on every thread")
+    {
+        std::cout<<"Testing seeded board streams"<<std::endl;
+        Cylink::GameBoard::seedRandom(9);
+        std::vector<int> picks;
+        for(int idx = 0; idx < 50; idx++)
+            picks.push_back(Cylink::GameBoard::randomNumber(0, 99));
+        Cylink::GameBoard::seedRandom(9);
+        for(int idx = 0; idx < 50; idx++)
+            CHECK(Cylink::GameBoard::randomNumber(0, 99) == picks[idx]);
+        CHECK_THROWS_AS(Cylink::GameBoard::randomNumber(5, 4), Cylink::Error);
+    }
+
+    SECTION("Runs are identical on any thread count and single games replay")
+    {
+        std::cout<<"Testing replayable runs"<<std::endl;
+        Cylink::SimulationConfig config;
+        config.games = 60;
+        config.seed = 734211;
+        config.strategy[0] = "parity";
+        config.strategy[1] = "density";
+
+        std::ostringstream single;
+        Cylink::runSimulation(config, single);
+        std::vector<std::string> expected = sortedRecords(single.str());
+        REQUIRE(expected.size() == 60);
+
+        config.threads = 4;
+        std::ostringstream threaded;
+        Cylink::runSimulation(config, threaded);
+        CHECK(sortedRecords(threaded.str()) == expected);
+
+        config.inflight = 7;
+        std::ostringstream scheduled;
+        Cylink::runSimulation(config, scheduled);
+        CHECK(sortedRecords(scheduled.str()) == expected);
+
+        /* Replaying one game alone gives the line the full run wrote for it */
+        config.firstGame = 37;
+        config.games = 1;
+        std::ostringstream replayed;
+        Cylink::runSimulation(config, replayed);
+        std::vector<std::string> game = sortedRecords(replayed.str());
+        REQUIRE(game.size() == 1);
+        CHECK(std::find(expected.begin(), expected.end(), game[0]) != expected.end());
+        CHECK(game[0].rfind("37", 0) == 0);
+
+        config.firstGame = -1;
+        CHECK_THROWS_AS(Cylink::runSimulation(config, replayed), Cylink::Error);
+    }
+}
@@ -0,0 +1,244 @@
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <sys/uio.h>
+
+#include "recordwriter.h"
+#include "error.h"
+
+#define RW_IO_ERROR ErrorCode::ERR_IO
+
+#define RW_SPIN_LIMIT 64
+#define RW_IDLE_MICROSECONDS 100
+
+namespace Cylink
+{
+    static const char rwHeader[] = "# game winner first turns shots1 shots2 hits1 hits2\n";
+
+    /**
+     Back off while waiting on another thread: yield for a while, then sleep briefly so a waiting thread
+     doesn't steal the core of the thread it waits for.
+    */
+    static void backoff(int& spins)
+    {
+        if(++spins < RW_SPIN_LIMIT)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(RW_IDLE_MICROSECONDS));
+    }
+
+    /**
+     Start a writer for an open file descriptor. Records are written with writev() and the descriptor is not closed.
+     The header line is written before any record.
+     @param fd
+        The descriptor to write to.
+     @param policy
+        What submit() does when the queue is full.
+     @param queueSize
+        The number of records the queue holds, rounded up to a power of two.
+    */
+    RecordWriter::RecordWriter(int fd, Backpressure policy, size_t queueSize)
+        : fd_(fd), os_(nullptr), policy_(policy), queue_(queueSize), chunks_(RW_MAX_CHUNKS * RW_CHUNK_BYTES),
+          lengths_(), error_(0), closing_(false), dropped_(0), written_(0)
+    {
+        writer_ = std::thread(&RecordWriter::run, this);
+    }
+
+    /**
+     Start a writer for an output stream. Only the writer thread touches the stream until close() returns.
+    */
+    RecordWriter::RecordWriter(std::ostream& os, Backpressure policy, size_t queueSize)
+        : fd_(-1), os_(&os), policy_(policy), queue_(queueSize), chunks_(RW_MAX_CHUNKS * RW_CHUNK_BYTES),
+          lengths_(), error_(0), closing_(false), dropped_(0), written_(0)
+    {
+        writer_ = std::thread(&RecordWriter::run, this);
+    }
+
+    /**
+     Drain the queue and stop the writer thread. Write errors are lost, call close() to see them.
+    */
+    RecordWriter::~RecordWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch(...)
+        {
+        }
+    }
+
+    /**
+     Hand a record to the writer thread. Safe to call from any number of threads, but not after close().
+     @return
+        True if the record was queued, false if it was dropped because the queue was full.
+    */
+    bool RecordWriter::submit(const GameRecord& record)
+    {
+        int spins = 0;
+        while(!queue_.tryPush(record))
+        {
+            if(policy_ == Backpressure::BACKPRESSURE_DROP)
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            backoff(spins);
+        }
+        return true;
+    }
+
+    /**
+     Write every queued record and stop the writer thread. Records submitted before close() are always written.
+     A write error on the file descriptor is reported by an exception.
+    */
+    void RecordWriter::close()
+    {
+        if(!writer_.joinable())
+            return;
+
+        closing_.store(true, std::memory_order_release);
+        writer_.join();
+        if(os_)
+            os_->flush();
+        if(error_ != 0)
+        {
+            Error ioError(std::string("Unable to write game records: ") + std::strerror(error_), RW_IO_ERROR, __FILE__, __LINE__);
+            throw ioError;
+        }
+    }
+
+    /**
+     @return
+        The number of records written so far.
+    */
+    long long RecordWriter::written() const
+    {
+        return written_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     @return
+        The number of records dropped because the queue was full. Always zero with BACKPRESSURE_BLOCK.
+    */
+    long long RecordWriter::dropped() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     Format a record as the space separated line GameResult's output operator writes, with the line ending.
+     @param buffer
+        Receives the text. Must have room for RW_RECORD_CHARS characters.
+     @return
+        The number of characters written.
+    */
+    size_t RecordWriter::formatRecord(char* buffer, const GameRecord& record)
+    {
+        char* end = buffer + RW_RECORD_CHARS;
+        char* pos = std::to_chars(buffer, end, record.game).ptr;
+        const unsigned fields[] = {record.winner, record.firstPlayer, record.turns,
+            record.shots[0], record.shots[1], record.hits[0], record.hits[1]};
+        for(unsigned field : fields)
+        {
+            *pos++ = ' ';
+            pos = std::to_chars(pos, end, field).ptr;
+        }
+        *pos++ = '\n';
+        return pos - buffer;
+    }
+
+    /**
+     The writer thread. Formats records into the chunks and writes them once every chunk is full or the queue runs dry.
+    */
+    void RecordWriter::run()
+    {
+        size_t chunk = 0;
+        lengths_[0] = sizeof(rwHeader) - 1;
+        std::memcpy(chunks_.data(), rwHeader, lengths_[0]);
+
+        int spins = 0;
+        for(;;)
+        {
+            /* Read the flag first so every record submitted before close() is popped below */
+            bool closing = closing_.load(std::memory_order_acquire);
+
+            GameRecord record;
+            while(queue_.tryPop(record))
+            {
+                if(lengths_[chunk] + RW_RECORD_CHARS > RW_CHUNK_BYTES)
+                {
+                    if(++chunk == RW_MAX_CHUNKS)
+                    {
+                        flush(RW_MAX_CHUNKS);
+                        chunk = 0;
+                    }
+                    lengths_[chunk] = 0;
+                }
+                lengths_[chunk] += formatRecord(chunks_.data() + chunk * RW_CHUNK_BYTES + lengths_[chunk], record);
+                written_.fetch_add(1, std::memory_order_relaxed);
+                spins = 0;
+            }
+
+            if(chunk > 0 || lengths_[0] > 0)
+            {
+                flush(chunk + 1);
+                chunk = 0;
+                lengths_[0] = 0;
+            }
+            if(closing)
+                break;
+            backoff(spins);
+        }
+    }
+
+    /**
+     Write the first chunks of output. After a write error nothing more is written and the error is kept for close().
+    */
+    void RecordWriter::flush(size_t chunks)
+    {
+        if(error_ != 0)
+            return;
+
+        if(os_)
+        {
+            for(size_t idx = 0; idx < chunks; idx++)
+                os_->write(chunks_.data() + idx * RW_CHUNK_BYTES, lengths_[idx]);
+            return;
+        }
+
+        struct iovec iov[RW_MAX_CHUNKS];
+        for(size_t idx = 0; idx < chunks; idx++)
+        {
+            iov[idx].iov_base = chunks_.data() + idx * RW_CHUNK_BYTES;
+            iov[idx].iov_len = lengths_[idx];
+        }
+
+        /* writev may write less than asked, continue from where it stopped */
+        struct iovec* next = iov;
+        int count = chunks;
+        while(count > 0)
+        {
+            ssize_t bytes = ::writev(fd_, next, count);
+            if(bytes < 0)
+            {
+                if(errno == EINTR)
+                    continue;
+                error_ = errno;
+                return;
+            }
+            while(count > 0 && static_cast<size_t>(bytes) >= next->iov_len)
+            {
+                bytes -= next->iov_len;
+                next++;
+                count--;
+            }
+            if(count > 0)
+            {
+                next->iov_base = static_cast<char*>(next->iov_base) + bytes;
+                next->iov_len -= bytes;
+            }
+        }
+    }
+}
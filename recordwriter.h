@@ -0,0 +1,199 @@
+#ifndef RECORDWRITER_H
+#define RECORDWRITER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#define RW_QUEUE_SIZE 16384
+#define RW_CHUNK_BYTES 65536
+#define RW_MAX_CHUNKS 8
+#define RW_RECORD_CHARS 96
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     A bounded lock-free queue for many producers and a single consumer (after Dmitry Vyukov's bounded queue).
+     Every slot carries a sequence number that tells producers whether it is free and the consumer whether it is filled,
+     so a push costs one CAS on the shared tail and a pop costs no read-modify-write at all.
+     The capacity is rounded up to a power of two.
+    */
+    template<typename T>
+    class MpscRing
+    {
+    public:
+        MpscRing(size_t capacity = RW_QUEUE_SIZE);
+
+        bool tryPush(const T& value);
+        bool tryPop(T& value);
+        size_t capacity() const;
+
+    private:
+        /**
+         @struct Slot
+         A queue slot. The slot is free for the producer at position p when sequence == p and
+         filled for the consumer when sequence == p + 1.
+        */
+        struct Slot
+        {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+    private:
+        size_t mask_;
+        std::unique_ptr<Slot[]> slots_;
+        alignas(64) std::atomic<size_t> tail_;  /**< Next position producers claim */
+        alignas(64) size_t head_;               /**< Next position the consumer reads, owned by the consumer thread */
+    };
+
+    /**
+     @struct GameRecord
+     The compact form of a game result passed from simulation workers to the writer thread.
+     Counts are clamped to their field size.
+    */
+    struct GameRecord
+    {
+        int64_t game;
+        uint16_t turns;
+        uint16_t shots[2];
+        uint16_t hits[2];
+        uint8_t winner;
+        uint8_t firstPlayer;
+    };
+
+    /**
+     @enum Backpressure
+     What a worker does when the record queue is full.
+    */
+    enum class Backpressure
+    {
+        BACKPRESSURE_BLOCK,     //Wait for the writer to make room
+        BACKPRESSURE_DROP       //Discard the record and count it
+    };
+
+    /**
+     Writes game records from many worker threads on a dedicated writer thread.
+     Workers push compact records into an MpscRing. The writer formats them into RW_CHUNK_BYTES text chunks and
+     writes up to RW_MAX_CHUNKS chunks at a time with writev() when writing to a file descriptor.
+     Workers never take a lock and, with BACKPRESSURE_DROP, never wait on the writer.
+    */
+    class RecordWriter
+    {
+    public:
+        RecordWriter(int fd, Backpressure policy = Backpressure::BACKPRESSURE_BLOCK, size_t queueSize = RW_QUEUE_SIZE);
+        RecordWriter(std::ostream& os, Backpressure policy = Backpressure::BACKPRESSURE_BLOCK, size_t queueSize = RW_QUEUE_SIZE);
+        RecordWriter(const RecordWriter& other) = delete;
+        RecordWriter& operator =(const RecordWriter& other) = delete;
+        ~RecordWriter();
+
+        bool submit(const GameRecord& record);
+        void close();
+
+        long long written() const;
+        long long dropped() const;
+
+        static size_t formatRecord(char* buffer, const GameRecord& record);
+
+    private:
+        void run();
+        void flush(size_t chunks);
+
+    private:
+        int fd_;                            /**< Output file descriptor or -1 to write to os_ */
+        std::ostream* os_;
+        Backpressure policy_;
+        MpscRing<GameRecord> queue_;
+        std::vector<char> chunks_;          /**< RW_MAX_CHUNKS output chunks of RW_CHUNK_BYTES each */
+        size_t lengths_[RW_MAX_CHUNKS];     /**< Bytes used in each chunk */
+        int error_;                         /**< errno of a failed write, set by the writer thread */
+        std::atomic<bool> closing_;
+        alignas(64) std::atomic<long long> dropped_;
+        std::atomic<long long> written_;
+        std::thread writer_;
+    };
+
+    /**
+     Create a queue with room for at least capacity values.
+    */
+    template<typename T>
+    MpscRing<T>::MpscRing(size_t capacity)
+        : mask_(0), slots_(), tail_(0), head_(0)
+    {
+        size_t size = 2;
+        while(size < capacity)
+            size <<= 1;
+        mask_ = size - 1;
+        slots_.reset(new Slot[size]);
+        for(size_t idx = 0; idx < size; idx++)
+            slots_[idx].sequence.store(idx, std::memory_order_relaxed);
+    }
+
+    /**
+     Add a value to the queue. Safe to call from any number of threads.
+     @return
+        False if the queue is full.
+    */
+    template<typename T>
+    bool MpscRing<T>::tryPush(const T& value)
+    {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            Slot& slot = slots_[pos & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if(diff == 0)
+            {
+                if(tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot.value = value;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     Take the oldest value off the queue. Only one thread may pop.
+     @return
+        False if the queue is empty.
+    */
+    template<typename T>
+    bool MpscRing<T>::tryPop(T& value)
+    {
+        Slot& slot = slots_[head_ & mask_];
+        if(slot.sequence.load(std::memory_order_acquire) != head_ + 1)
+            return false;
+
+        value = slot.value;
+        slot.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+        head_++;
+        return true;
+    }
+
+    template<typename T>
+    size_t MpscRing<T>::capacity() const
+    {
+        return mask_ + 1;
+    }
+}
+
+#endif
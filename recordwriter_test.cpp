@@ -0,0 +1,151 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include "recordwriter.h"
+#include "simulation.h"
+
+/**
+ A stream buffer that holds the writer thread in its first write until released.
+*/
+class GateBuffer : public std::stringbuf
+{
+public:
+    std::atomic<bool> open{false};
+    std::atomic<bool> entered{false};
+
+protected:
+    std::streamsize xsputn(const char* s, std::streamsize count) override
+    {
+        entered = true;
+        while(!open)
+            std::this_thread::yield();
+        return std::stringbuf::xsputn(s, count);
+    }
+};
+
+TEST_CASE ("Testing RecordWriter", "[RecordWriter]")
+{
+    SECTION("The ring hands every value to the consumer once, in order per producer")
+    {
+        std::cout<<"Testing multi producer ring"<<std::endl;
+        const int producers = 4, perProducer = 50000;
+        Cylink::MpscRing<int> ring(64);
+        CHECK(ring.capacity() == 64);
+
+        std::vector<std::thread> threads;
+        for(int tid = 0; tid < producers; tid++)
+        {
+            threads.emplace_back([&ring, tid]()
+            {
+                for(int idx = 0; idx < perProducer; idx++)
+                {
+                    while(!ring.tryPush(tid * perProducer + idx))
+                        std::this_thread::yield();
+                }
+            });
+        }
+
+        std::vector<int> next(producers, 0);
+        bool ordered = true;
+        for(int received = 0; received < producers * perProducer; )
+        {
+            int value;
+            if(!ring.tryPop(value))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            int tid = value / perProducer;
+            ordered = ordered && (value % perProducer == next[tid]);
+            next[tid]++;
+            received++;
+        }
+        for(auto& thread : threads)
+            thread.join();
+
+        int value;
+        CHECK(ordered);
+        CHECK_FALSE(ring.tryPop(value));
+    }
+
+    SECTION("Records are written in the game result format")
+    {
+        std::cout<<"Testing record formatting"<<std::endl;
+        std::ostringstream out;
+        Cylink::RecordWriter writer(out);
+        for(int game = 0; game < 5000; game++)
+        {
+            Cylink::GameRecord record = {game, 120, {60, 59}, {17, 12}, 1, 2};
+            CHECK(writer.submit(record));
+        }
+        writer.close();
+        CHECK(writer.written() == 5000);
+
+        Cylink::GameResult result;
+        result.game = 4999;
+        result.winner = 1;
+        result.firstPlayer = 2;
+        result.turns = 120;
+        result.shots[0] = 60;
+        result.shots[1] = 59;
+        result.hits[0] = 17;
+        result.hits[1] = 12;
+        std::ostringstream expected;
+        expected<<result<<"\n";
+
+        std::string text = out.str();
+        CHECK(std::count(text.begin(), text.end(), '\n') == 5001);
+        CHECK(text.substr(0, 7) == "# game ");
+        CHECK(text.substr(text.size() - expected.str().size()) == expected.str());
+    }
+
+    SECTION("Dropping records when the writer is stalled")
+    {
+        std::cout<<"Testing drop backpressure"<<std::endl;
+        GateBuffer buffer;
+        std::ostream out(&buffer);
+        Cylink::RecordWriter writer(out, Cylink::Backpressure::BACKPRESSURE_DROP, 2);
+
+        /* The header write holds the writer, so only two records fit */
+        while(!buffer.entered)
+            std::this_thread::yield();
+        Cylink::GameRecord record = {0, 1, {1, 0}, {1, 0}, 1, 1};
+        CHECK(writer.submit(record));
+        CHECK(writer.submit(record));
+        CHECK_FALSE(writer.submit(record));
+        CHECK(writer.dropped() == 1);
+
+        buffer.open = true;
+        writer.close();
+        CHECK(writer.written() == 2);
+    }
+
+    SECTION("Simulations write through a file descriptor")
+    {
+        std::cout<<"Testing writev output"<<std::endl;
+        char path[] = "/tmp/highseas_recordsXXXXXX";
+        int fd = mkstemp(path);
+        REQUIRE(fd >= 0);
+
+        Cylink::SimulationConfig config;
+        config.games = 300;
+        config.threads = 3;
+        Cylink::SimulationSummary summary = Cylink::runSimulation(config, fd);
+        ::close(fd);
+        CHECK(summary.games == 300);
+        CHECK(summary.dropped == 0);
+
+        std::ifstream file(path);
+        std::string line;
+        int lines = 0;
+        while(std::getline(file, line))
+            lines++;
+        std::remove(path);
+        CHECK(lines == 301);
+    }
+}
@@ -0,0 +1,96 @@
+/**
+ * @file render_bench.cpp
+ * Compares rendering boards through iostream formatting, as GameBoard's output operator used to, with BoardRenderer,
+ * and measures dumping boards through an AsyncWriter.
+ * Usage: render_bench [boards]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+#include "placement.h"
+#include "renderer.h"
+#include "utils.h"
+
+#define BENCH_DEFAULT_BOARDS 20000
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ The iostream rendering GameBoard's output operator used, with open water printed as '.'.
+*/
+static void streamBoard(std::ostream& os, const Cylink::GameBoard& gb)
+{
+    os<<"\n"<<std::setw(RENDER_CELL_WIDTH)<<" ";
+    for(int y = 0; y < gb.getWidth(); y++)
+        os<<std::setw(RENDER_CELL_WIDTH)<<Cylink::StringUtils::centered(std::to_string(y+1));
+    os<<"\n";
+
+    for(int x = 0; x < gb.getLength(); x++)
+    {
+        os<<std::setw(RENDER_CELL_WIDTH)<<Cylink::StringUtils::centered(std::to_string(x+1));
+        for(int y = 0; y < gb.getWidth(); y++)
+        {
+            int vesselId = gb.cellAt(x, y).vesselId;
+            std::string code = (vesselId == GB_NO_VESSEL) ? "." : Cylink::Vessel::formatVessel(gb.getVessel(vesselId).getType(), false);
+            os<<std::setw(RENDER_CELL_WIDTH)<<Cylink::StringUtils::centered(code);
+        }
+        os<<"\n";
+    }
+}
+
+static void report(const char* label, int boards, Clock::time_point start, size_t bytes)
+{
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    std::cout<<label<<": "<<static_cast<long long>(boards / elapsed.count())<<" boards/second, "
+        <<static_cast<long long>(elapsed.count() * 1e9 / boards)<<" ns/board ("<<bytes<<" bytes)\n";
+}
+
+int main(int argc, char* argv[])
+{
+    int boards = (argc > 1) ? std::atoi(argv[1]) : BENCH_DEFAULT_BOARDS;
+    if(boards <= 0)
+        boards = BENCH_DEFAULT_BOARDS;
+
+    std::vector<Cylink::Vessel::VType> fleet = {Cylink::Vessel::VType::CARRIER, Cylink::Vessel::VType::CRUISER,
+        Cylink::Vessel::VType::CRUISER, Cylink::Vessel::VType::DESTROYER, Cylink::Vessel::VType::FRIGATE,
+        Cylink::Vessel::VType::SUBMARINE};
+    Cylink::PlacementGenerator generator(fleet, GB_BOARD_SIZE, GB_BOARD_SIZE, 1);
+    std::vector<Cylink::VesselPlacement> layout;
+    generator.generate(layout);
+    Cylink::GameBoard board;
+    for(auto& placement : layout)
+        board.emplaceVessel(placement.border, placement.vtype, placement.direction);
+
+    std::cout<<"Rendering "<<boards<<" "<<GB_BOARD_SIZE<<"x"<<GB_BOARD_SIZE<<" boards\n";
+
+    std::ostringstream stream;
+    auto start = Clock::now();
+    for(int run = 0; run < boards; run++)
+        streamBoard(stream, board);
+    report("iostream formatting", boards, start, stream.str().size());
+
+    /* Render repeatedly into one preallocated buffer, keeping the total so the work isn't optimized away */
+    std::vector<char> buffer(Cylink::BoardRenderer::bufferSize(GB_BOARD_SIZE, GB_BOARD_SIZE));
+    size_t total = 0;
+    start = Clock::now();
+    for(int run = 0; run < boards; run++)
+        total += Cylink::BoardRenderer::render(board, buffer.data(), buffer.size());
+    report("BoardRenderer", boards, start, total);
+    if(std::string(buffer.data(), buffer.size()) != stream.str().substr(0, buffer.size()))
+        std::cout<<"BoardRenderer output differs from iostream formatting\n";
+
+    int fd = ::open("/dev/null", O_WRONLY);
+    {
+        Cylink::AsyncWriter writer(fd);
+        start = Clock::now();
+        for(int run = 0; run < boards; run++)
+            writer.writeBoard(board);
+        writer.close();
+        report("AsyncWriter to /dev/null", boards, start, total);
+    }
+    ::close(fd);
+    return 0;
+}
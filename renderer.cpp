@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <unistd.h>
+
+#include "renderer.h"
+#include "error.h"
+
+#define AW_IO_ERROR ErrorCode::ERR_IO
+#define AW_ARG_ERROR ErrorCode::ERR_INVALID_ARG
+
+namespace Cylink
+{
+    /**
+     The width of every field for a board, wide enough for the largest row or column number.
+    */
+    static size_t cellWidth(int length, int width)
+    {
+        char digits[16];
+        size_t needed = std::to_chars(digits, digits + sizeof(digits), std::max(length, width)).ptr - digits;
+        return std::max<size_t>(RENDER_CELL_WIDTH, needed);
+    }
+
+    /**
+     Write text centered in a blank field the way StringUtils::centered() does, extra padding going to the right.
+     @return
+        The position following the field.
+    */
+    static char* centerField(char* pos, const char* text, size_t length, size_t field)
+    {
+        size_t left = (field + length) / 2;
+        std::memcpy(pos + left - length, text, length);
+        return pos + field;
+    }
+
+    static char* numberField(char* pos, int number, size_t field)
+    {
+        char digits[16];
+        size_t length = std::to_chars(digits, digits + sizeof(digits), number).ptr - digits;
+        return centerField(pos, digits, length, field);
+    }
+
+    /**
+     @return
+        The exact number of characters render() writes for a board of the given size.
+    */
+    size_t BoardRenderer::bufferSize(int length, int width)
+    {
+        size_t line = (static_cast<size_t>(width) + 1) * cellWidth(length, width) + 1;
+        return 1 + line * (static_cast<size_t>(length) + 1);
+    }
+
+    /**
+     Render a board into a buffer.
+     A buffer smaller than bufferSize() for the board will result in an exception.
+     @param board
+        The board to render.
+     @param buffer
+        Receives the text, which is not null terminated.
+     @param capacity
+        The size of the buffer.
+     @return
+        The number of characters written.
+    */
+    size_t BoardRenderer::render(const GameBoard& board, char* buffer, size_t capacity)
+    {
+        const int length = board.getLength(), width = board.getWidth();
+        if(capacity < bufferSize(length, width))
+        {
+            Error argError("Render buffer is too small.", AW_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+
+        /* Vessel codes, looked up once so rendering never builds a string */
+        static const std::vector<std::string> codes = []()
+        {
+            std::vector<std::string> result;
+            for(int type = static_cast<int>(Vessel::VType::GUNBOAT); type <= static_cast<int>(Vessel::VType::CARRIER); type++)
+                result.push_back(Vessel::formatVessel(static_cast<Vessel::VType>(type), false));
+            return result;
+        }();
+
+        const size_t field = cellWidth(length, width);
+        std::vector<const std::string*> vesselCodes(board.vesselCount());
+        for(int id = 0; id < board.vesselCount(); id++)
+            vesselCodes[id] = &codes[static_cast<int>(board.getVessel(id).getType())];
+
+        /* Fill the whole text with blanks first, then drop the numbers and codes into their fields */
+        const size_t line = (static_cast<size_t>(width) + 1) * field + 1;
+        char* pos = buffer;
+        std::memset(buffer, ' ', bufferSize(length, width));
+        *pos++ = '\n';
+        for(int y = 0; y < width; y++)
+            numberField(pos + (y + 1) * field, y + 1, field);
+        pos[line - 1] = '\n';
+        pos += line;
+
+        const size_t waterLeft = (field + 1) / 2 - 1;
+        for(int x = 0; x < length; x++)
+        {
+            numberField(pos, x + 1, field);
+            char* cell = pos + field;
+            for(int y = 0; y < width; y++, cell += field)
+            {
+                int vesselId = board.cellAt(x, y).vesselId;
+                if(vesselId == GB_NO_VESSEL)
+                {
+                    cell[waterLeft] = '.';
+                }
+                else
+                {
+                    const std::string& code = *vesselCodes[vesselId];
+                    std::memcpy(cell + (field + code.size()) / 2 - code.size(), code.data(), code.size());
+                }
+            }
+            pos[line - 1] = '\n';
+            pos += line;
+        }
+        return pos - buffer;
+    }
+
+    /**
+     Start a writer for an open file descriptor. The descriptor is not closed.
+     @param fd
+        The descriptor to write to.
+     @param bufferBytes
+        The size of each of the two buffers.
+    */
+    AsyncWriter::AsyncWriter(int fd, size_t bufferBytes)
+        : fd_(fd), os_(nullptr), buffers_{std::vector<char>(bufferBytes), std::vector<char>(bufferBytes)}, front_(0), used_(0),
+          lock_(), changed_(), pending_(false), pendingBytes_(0), closing_(false), error_(0)
+    {
+        writer_ = std::thread(&AsyncWriter::run, this);
+    }
+
+    /**
+     Start a writer for an output stream. Only the writer thread touches the stream until close() returns.
+    */
+    AsyncWriter::AsyncWriter(std::ostream& os, size_t bufferBytes)
+        : fd_(-1), os_(&os), buffers_{std::vector<char>(bufferBytes), std::vector<char>(bufferBytes)}, front_(0), used_(0),
+          lock_(), changed_(), pending_(false), pendingBytes_(0), closing_(false), error_(0)
+    {
+        writer_ = std::thread(&AsyncWriter::run, this);
+    }
+
+    /**
+     Write everything still buffered and stop the writer thread. Write errors are lost, call close() to see them.
+    */
+    AsyncWriter::~AsyncWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch(...)
+        {
+        }
+    }
+
+    /**
+     Obtain room for the given number of characters at the end of the front buffer. Hands the front buffer to the
+     writer thread first if it can't hold them. A request larger than the buffer size grows the front buffer.
+     @return
+        Where to write the characters. Call commit() with the number actually written.
+    */
+    char* AsyncWriter::reserve(size_t bytes)
+    {
+        std::vector<char>& front = buffers_[front_];
+        if(used_ + bytes > front.size())
+        {
+            flush();
+            if(bytes > buffers_[front_].size())
+                buffers_[front_].resize(bytes);
+        }
+        return buffers_[front_].data() + used_;
+    }
+
+    /**
+     Add characters written after reserve() to the output.
+    */
+    void AsyncWriter::commit(size_t bytes)
+    {
+        used_ += bytes;
+    }
+
+    /**
+     Copy characters to the output.
+    */
+    void AsyncWriter::write(const char* data, size_t bytes)
+    {
+        std::memcpy(reserve(bytes), data, bytes);
+        commit(bytes);
+    }
+
+    /**
+     Render a board straight into the output with BoardRenderer.
+    */
+    void AsyncWriter::writeBoard(const GameBoard& board)
+    {
+        size_t bytes = BoardRenderer::bufferSize(board.getLength(), board.getWidth());
+        commit(BoardRenderer::render(board, reserve(bytes), bytes));
+    }
+
+    /**
+     Hand the front buffer to the writer thread, waiting only if the writer is still busy with the other buffer.
+    */
+    void AsyncWriter::flush()
+    {
+        if(used_ == 0)
+            return;
+
+        std::unique_lock<std::mutex> guard(lock_);
+        changed_.wait(guard, [this]() { return !pending_; });
+        pending_ = true;
+        pendingBytes_ = used_;
+        front_ ^= 1;
+        used_ = 0;
+        changed_.notify_all();
+    }
+
+    /**
+     Write everything buffered and stop the writer thread.
+     A write error on the file descriptor is reported by an exception.
+    */
+    void AsyncWriter::close()
+    {
+        if(!writer_.joinable())
+            return;
+
+        flush();
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            closing_ = true;
+            changed_.notify_all();
+        }
+        writer_.join();
+        if(os_)
+            os_->flush();
+        if(error_ != 0)
+        {
+            Error ioError(std::string("Unable to write output: ") + std::strerror(error_), AW_IO_ERROR, __FILE__, __LINE__);
+            throw ioError;
+        }
+    }
+
+    /**
+     The writer thread. Writes each buffer handed over by flush(). After a write error the remaining output is discarded.
+    */
+    void AsyncWriter::run()
+    {
+        std::unique_lock<std::mutex> guard(lock_);
+        for(;;)
+        {
+            changed_.wait(guard, [this]() { return pending_ || closing_; });
+            if(!pending_)
+                break;
+
+            /* The producer can't touch the back buffer until pending_ is cleared */
+            const char* data = buffers_[front_ ^ 1].data();
+            size_t bytes = pendingBytes_;
+            guard.unlock();
+
+            if(os_)
+            {
+                os_->write(data, bytes);
+            }
+            else
+            {
+                while(bytes > 0 && error_ == 0)
+                {
+                    ssize_t count = ::write(fd_, data, bytes);
+                    if(count < 0)
+                    {
+                        if(errno != EINTR)
+                            error_ = errno;
+                        continue;
+                    }
+                    data += count;
+                    bytes -= count;
+                }
+            }
+
+            guard.lock();
+            pending_ = false;
+            changed_.notify_all();
+        }
+    }
+}
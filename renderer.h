@@ -0,0 +1,74 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "gameboard.h"
+
+#define RENDER_CELL_WIDTH 5
+#define AW_BUFFER_BYTES (1 << 20)
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     Renders game boards as text into caller supplied character buffers without iostreams or temporary strings.
+     The layout is the one GameBoard's output operator writes: a header row of column numbers, then one line per row
+     with the row number and the two letter code of the vessel in each location, '.' for open water.
+     Every field is RENDER_CELL_WIDTH characters wide, or wider if a row or column number needs more digits.
+    */
+    class BoardRenderer
+    {
+    public:
+        static size_t bufferSize(int length, int width);
+        static size_t render(const GameBoard& board, char* buffer, size_t capacity);
+    };
+
+    /**
+     Writes text to a file descriptor or stream on a background thread using two buffers.
+     The producer fills one buffer while the writer thread writes the other, so the producer only waits when it fills
+     a whole buffer before the previous one has been written. A writer has a single producer thread.
+    */
+    class AsyncWriter
+    {
+    public:
+        AsyncWriter(int fd, size_t bufferBytes = AW_BUFFER_BYTES);
+        AsyncWriter(std::ostream& os, size_t bufferBytes = AW_BUFFER_BYTES);
+        AsyncWriter(const AsyncWriter& other) = delete;
+        AsyncWriter& operator =(const AsyncWriter& other) = delete;
+        ~AsyncWriter();
+
+        char* reserve(size_t bytes);
+        void commit(size_t bytes);
+        void write(const char* data, size_t bytes);
+        void writeBoard(const GameBoard& board);
+        void flush();
+        void close();
+
+    private:
+        void run();
+
+    private:
+        int fd_;                            /**< Output file descriptor or -1 to write to os_ */
+        std::ostream* os_;
+        std::vector<char> buffers_[2];
+        int front_;                         /**< The buffer the producer fills */
+        size_t used_;                       /**< Bytes used in the front buffer */
+        std::mutex lock_;
+        std::condition_variable changed_;
+        bool pending_;                      /**< The back buffer holds pendingBytes_ bytes to write */
+        size_t pendingBytes_;
+        bool closing_;
+        int error_;                         /**< errno of a failed write */
+        std::thread writer_;
+    };
+}
+
+#endif
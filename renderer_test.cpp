@@ -0,0 +1,51 @@
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+#include "error.h"
+#include "renderer.h"
+
+TEST_CASE ("Testing BoardRenderer", "[BoardRenderer]")
+{
+    Cylink::GameBoard board(3, 4);
+    Cylink::GameBoard::VBorder cruiser(1, 1);
+    REQUIRE(board.emplaceVessel(cruiser, Cylink::Vessel::VType::CRUISER, Cylink::GameBoard::VDirection::HORIZONTAL));
+
+    const std::string expected =
+        "\n"
+        "       1    2    3    4  \n"
+        "  1    .    .    .    .  \n"
+        "  2    .   CR   CR    .  \n"
+        "  3    .    .    .    .  \n";
+
+    SECTION("Boards render to the fixed layout")
+    {
+        std::cout<<"Testing board rendering"<<std::endl;
+        std::vector<char> buffer(Cylink::BoardRenderer::bufferSize(3, 4));
+        size_t bytes = Cylink::BoardRenderer::render(board, buffer.data(), buffer.size());
+        CHECK(bytes == buffer.size());
+        CHECK(std::string(buffer.data(), bytes) == expected);
+        CHECK_THROWS_AS(Cylink::BoardRenderer::render(board, buffer.data(), bytes - 1), Cylink::Error);
+
+        /* The output operator uses the renderer, empty boards included */
+        std::ostringstream os;
+        os<<board<<Cylink::GameBoard(1, 1);
+        CHECK(os.str() == expected + "\n       1  \n  1    .  \n");
+    }
+
+    SECTION("The async writer keeps output in order across buffer swaps")
+    {
+        std::cout<<"Testing async writer"<<std::endl;
+        std::ostringstream os;
+        Cylink::AsyncWriter writer(os, 100);
+        for(int idx = 0; idx < 50; idx++)
+        {
+            writer.writeBoard(board);
+            writer.write("#", 1);
+        }
+        writer.close();
+
+        std::string want;
+        for(int idx = 0; idx < 50; idx++)
+            want += expected + "#";
+        CHECK(os.str() == want);
+    }
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+
+#include "scheduler.h"
+
+namespace Cylink
+{
+    Executor::~Executor()
+    {
+    }
+
+    /**
+     Answer the request and hand the waiting game back to its executor. The request must not be used afterwards,
+     it lives in the game's coroutine frame which may already be running again.
+    */
+    void FireRequest::complete(int xCord, int yCord)
+    {
+        position = std::make_pair(xCord, yCord);
+        executor->schedule(waiter);
+    }
+
+    /**
+     Start the worker threads.
+     @param threads
+        The number of threads resuming coroutines, at least one.
+    */
+    Scheduler::Scheduler(int threads)
+        : lock_(), ready_(), queue_(), stopping_(false), workers_()
+    {
+        for(int idx = 0; idx < std::max(1, threads); idx++)
+            workers_.emplace_back(&Scheduler::run, this);
+    }
+
+    /**
+     Resume everything still queued, then stop the worker threads. Coroutines suspended without being queued
+     are left alone, their owners must destroy them.
+    */
+    Scheduler::~Scheduler()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        for(auto& worker : workers_)
+            worker.join();
+    }
+
+    void Scheduler::schedule(std::coroutine_handle<> handle)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            queue_.push_back(handle);
+        }
+        ready_.notify_one();
+    }
+
+    int Scheduler::threads() const
+    {
+        return workers_.size();
+    }
+
+    /**
+     A worker thread: resume queued coroutines until the scheduler stops and the queue is empty.
+    */
+    void Scheduler::run()
+    {
+        for(;;)
+        {
+            std::coroutine_handle<> handle;
+            {
+                std::unique_lock<std::mutex> guard(lock_);
+                ready_.wait(guard, [this]() { return stopping_ || !queue_.empty(); });
+                if(queue_.empty())
+                    return;
+                handle = queue_.front();
+                queue_.pop_front();
+            }
+            handle.resume();
+        }
+    }
+
+    /**
+     Start the pool's threads.
+     @param threads
+        The number of threads, at least one.
+    */
+    ThreadPool::ThreadPool(int threads)
+        : lock_(), start_(), finished_(), body_(nullptr), tasks_(0), next_(0), done_(0), batch_(0), stopping_(false),
+          failure_(), workers_()
+    {
+        for(int idx = 0; idx < std::max(1, threads); idx++)
+            workers_.emplace_back(&ThreadPool::work, this, idx);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            stopping_ = true;
+        }
+        start_.notify_all();
+        for(auto& worker : workers_)
+            worker.join();
+    }
+
+    /**
+     Run body(task, worker) for every task in [0, tasks) on the pool's threads and wait for all of them.
+     If a task throws, the remaining tasks are skipped and the first exception is rethrown here.
+     Only one thread may call run() at a time.
+    */
+    void ThreadPool::run(size_t tasks, const Body& body)
+    {
+        if(tasks == 0)
+            return;
+        std::unique_lock<std::mutex> guard(lock_);
+        body_ = &body;
+        tasks_ = tasks;
+        next_ = 0;
+        done_ = 0;
+        failure_ = nullptr;
+        batch_++;
+        start_.notify_all();
+        finished_.wait(guard, [this]() { return done_ == tasks_; });
+        body_ = nullptr;
+        if(failure_)
+            std::rethrow_exception(std::exchange(failure_, nullptr));
+    }
+
+    int ThreadPool::threads() const
+    {
+        return workers_.size();
+    }
+
+    /**
+     A pool thread: take task indexes of the current batch until there are none left, then wait for the next batch.
+    */
+    void ThreadPool::work(int worker)
+    {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> guard(lock_);
+        for(;;)
+        {
+            start_.wait(guard, [this, seen]() { return stopping_ || (body_ && batch_ != seen && next_ < tasks_); });
+            if(stopping_)
+                return;
+            seen = batch_;
+            while(next_ < tasks_)
+            {
+                size_t task = next_++;
+                const Body& body = *body_;
+                guard.unlock();
+                try
+                {
+                    body(task, worker);
+                    guard.lock();
+                }
+                catch(...)
+                {
+                    guard.lock();
+                    if(!failure_)
+                        failure_ = std::current_exception();
+                    /* Skip whatever is left of the batch */
+                    done_ += tasks_ - next_;
+                    next_ = tasks_;
+                }
+                if(++done_ == tasks_)
+                    finished_.notify_one();
+            }
+        }
+    }
+
+    BlockingExecutor::BlockingExecutor()
+        : lock_(), ready_(), next_()
+    {
+    }
+
+    /**
+     Hand the task's coroutine back to the thread waiting in run(). Only the task run() waits on may be scheduled.
+    */
+    void BlockingExecutor::schedule(std::coroutine_handle<> handle)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            next_ = handle;
+        }
+        ready_.notify_one();
+    }
+}
@@ -0,0 +1,312 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     Something that resumes suspended coroutines, eg. a Scheduler's worker threads.
+    */
+    class Executor
+    {
+    public:
+        virtual ~Executor();
+
+        /**
+         Queue a suspended coroutine to be resumed. Safe to call from any thread.
+        */
+        virtual void schedule(std::coroutine_handle<> handle) = 0;
+    };
+
+    /**
+     @struct FireRequest
+     A fire position asked of an asynchronous strategy. The strategy answers by calling complete(), from any thread,
+     which hands the waiting game back to its executor.
+    */
+    struct FireRequest
+    {
+        Executor* executor = nullptr;
+        std::coroutine_handle<> waiter;
+        std::pair<int, int> position;
+
+        void complete(int xCord, int yCord);
+    };
+
+    /**
+     A lazily started coroutine producing a T. The coroutine runs when start() is called or its handle is scheduled.
+     When it finishes it stays suspended so the result can be read, unless an onDone() callback takes over: the callback
+     runs on the finishing thread while the coroutine is suspended at its end, and may read the result and destroy the
+     task. Tasks own their coroutine frame.
+    */
+    template<typename T>
+    class Task
+    {
+    public:
+        struct promise_type;
+        using Handle = std::coroutine_handle<promise_type>;
+        using Callback = void (*)(void* context);
+
+        /**
+         Runs the onDone() callback once the coroutine reached its end.
+        */
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept
+            {
+                return false;
+            }
+
+            void await_suspend(Handle handle) noexcept
+            {
+                /* The callback may destroy the frame holding this awaiter, so copy what's needed first */
+                Callback callback = handle.promise().callback;
+                void* context = handle.promise().context;
+                if(callback)
+                    callback(context);
+            }
+
+            void await_resume() noexcept
+            {
+            }
+        };
+
+        struct promise_type
+        {
+            std::optional<T> value;
+            std::exception_ptr failure;
+            Callback callback = nullptr;
+            void* context = nullptr;
+
+            Task get_return_object()
+            {
+                return Task(Handle::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            FinalAwaiter final_suspend() noexcept
+            {
+                return {};
+            }
+
+            void return_value(T result)
+            {
+                value = std::move(result);
+            }
+
+            void unhandled_exception()
+            {
+                failure = std::current_exception();
+            }
+        };
+
+    public:
+        Task() : handle_() {}
+        Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+        Task(const Task& other) = delete;
+        Task& operator =(const Task& other) = delete;
+        ~Task();
+
+        Task& operator =(Task&& other) noexcept;
+
+        void start();
+        void onDone(Callback callback, void* context);
+        bool done() const;
+        T result();
+        std::coroutine_handle<> handle() const;
+
+    private:
+        explicit Task(Handle handle) : handle_(handle) {}
+
+    private:
+        Handle handle_;
+    };
+
+    /**
+     An M:N scheduler: suspended coroutines from any number of games are resumed by a fixed pool of threads
+     taking them from a shared run queue. A game that never suspends runs start to finish on one thread.
+    */
+    class Scheduler : public Executor
+    {
+    public:
+        Scheduler(int threads);
+        Scheduler(const Scheduler& other) = delete;
+        Scheduler& operator =(const Scheduler& other) = delete;
+        ~Scheduler();
+
+        void schedule(std::coroutine_handle<> handle) override;
+        int threads() const;
+
+    private:
+        void run();
+
+    private:
+        std::mutex lock_;
+        std::condition_variable ready_;
+        std::deque<std::coroutine_handle<>> queue_;
+        bool stopping_;
+        std::vector<std::thread> workers_;
+    };
+
+    /**
+     A fixed set of threads kept for fork-join work, so callers that run many batches, eg. one per tuning
+     generation, don't start threads for each. run() hands out task indexes to the threads and returns once all
+     tasks are done. The body is told which thread runs it, letting callers keep per-thread state across batches.
+    */
+    class ThreadPool
+    {
+    public:
+        using Body = std::function<void(size_t task, int worker)>;
+
+        ThreadPool(int threads);
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool& operator =(const ThreadPool& other) = delete;
+        ~ThreadPool();
+
+        void run(size_t tasks, const Body& body);
+        int threads() const;
+
+    private:
+        void work(int worker);
+
+    private:
+        std::mutex lock_;
+        std::condition_variable start_;
+        std::condition_variable finished_;
+        const Body* body_;              /**< The batch being run, null between batches */
+        size_t tasks_;
+        size_t next_;                   /**< Next task index to hand out */
+        size_t done_;                   /**< Tasks of the batch that have finished */
+        uint64_t batch_;                /**< Incremented for every batch so idle threads notice new work */
+        bool stopping_;
+        std::exception_ptr failure_;    /**< First exception a task of the batch threw */
+        std::vector<std::thread> workers_;
+    };
+
+    /**
+     Runs a task on the calling thread, waiting whenever it suspends until something schedules it again.
+    */
+    class BlockingExecutor : public Executor
+    {
+    public:
+        BlockingExecutor();
+
+        void schedule(std::coroutine_handle<> handle) override;
+
+        template<typename T>
+        T run(Task<T> task);
+
+    private:
+        std::mutex lock_;
+        std::condition_variable ready_;
+        std::coroutine_handle<> next_;
+    };
+
+    template<typename T>
+    Task<T>::~Task()
+    {
+        if(handle_)
+            handle_.destroy();
+    }
+
+    template<typename T>
+    Task<T>& Task<T>::operator =(Task&& other) noexcept
+    {
+        if(this != &other)
+        {
+            if(handle_)
+                handle_.destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    /**
+     Run the coroutine on the calling thread until it first suspends or finishes.
+    */
+    template<typename T>
+    void Task<T>::start()
+    {
+        handle_.resume();
+    }
+
+    /**
+     Have a callback run when the coroutine finishes. Set it before the task starts.
+    */
+    template<typename T>
+    void Task<T>::onDone(Callback callback, void* context)
+    {
+        handle_.promise().callback = callback;
+        handle_.promise().context = context;
+    }
+
+    template<typename T>
+    bool Task<T>::done() const
+    {
+        return handle_ && handle_.done();
+    }
+
+    /**
+     @return
+        The value the finished coroutine returned. An exception that escaped the coroutine is rethrown.
+    */
+    template<typename T>
+    T Task<T>::result()
+    {
+        promise_type& promise = handle_.promise();
+        if(promise.failure)
+            std::rethrow_exception(promise.failure);
+        return std::move(*promise.value);
+    }
+
+    /**
+     @return
+        The coroutine, to be scheduled on an executor to start it.
+    */
+    template<typename T>
+    std::coroutine_handle<> Task<T>::handle() const
+    {
+        return handle_;
+    }
+
+    /**
+     Start the task and resume it every time it is scheduled until it finishes.
+     @return
+        The task's result.
+    */
+    template<typename T>
+    T BlockingExecutor::run(Task<T> task)
+    {
+        task.start();
+        while(!task.done())
+        {
+            std::coroutine_handle<> handle;
+            {
+                std::unique_lock<std::mutex> guard(lock_);
+                ready_.wait(guard, [this]() { return static_cast<bool>(next_); });
+                handle = std::exchange(next_, nullptr);
+            }
+            handle.resume();
+        }
+        return task.result();
+    }
+}
+
+#endif
@@ -0,0 +1,191 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "simulation.h"
+#include "strategy.h"
+
+/**
+ Stands in for a remote AI: fire requests are parked until another thread answers them with the wrapped strategy.
+*/
+class ParkedStrategy : public Cylink::Strategy
+{
+public:
+    struct Parked
+    {
+        Cylink::Strategy* strategy;
+        const Cylink::GameBoard* board;
+        Cylink::FireRequest* request;
+    };
+
+    ParkedStrategy(std::unique_ptr<Cylink::Strategy> inner, std::mutex& lock, std::vector<Parked>& parked)
+        : inner_(std::move(inner)), lock_(lock), parked_(parked)
+    {
+    }
+
+    std::pair<int, int> suggestFirePosition(const Cylink::GameBoard& board) override
+    {
+        return inner_->suggestFirePosition(board);
+    }
+
+    void recordResult(int xCord, int yCord, Cylink::GameBoard::StrikeResult result) override
+    {
+        inner_->recordResult(xCord, yCord, result);
+    }
+
+    bool isAsync() const override
+    {
+        return true;
+    }
+
+    void requestFirePosition(const Cylink::GameBoard& board, Cylink::FireRequest& request) override
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        parked_.push_back(Parked{inner_.get(), &board, &request});
+    }
+
+    void reset(uint64_t seed) override
+    {
+        inner_->reset(seed);
+    }
+
+    std::unique_ptr<Cylink::Strategy> clone() const override
+    {
+        return std::make_unique<ParkedStrategy>(inner_->clone(), lock_, parked_);
+    }
+
+    std::string name() const override
+    {
+        return "parked";
+    }
+
+private:
+    std::unique_ptr<Cylink::Strategy> inner_;
+    std::mutex& lock_;
+    std::vector<Parked>& parked_;
+};
+
+/**
+ Answers parked requests until told to stop.
+*/
+static void answerParked(std::mutex& lock, std::vector<ParkedStrategy::Parked>& parked, std::atomic<bool>& stop)
+{
+    while(!stop)
+    {
+        std::vector<ParkedStrategy::Parked> batch;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            batch.swap(parked);
+        }
+        for(auto& item : batch)
+        {
+            std::pair<int, int> position = item.strategy->suggestFirePosition(*item.board);
+            item.request->complete(position.first, position.second);
+        }
+        if(batch.empty())
+            std::this_thread::yield();
+    }
+}
+
+static std::vector<std::string> sortedLines(const std::string& text)
+{
+    std::vector<std::string> lines;
+    std::istringstream in(text);
+    for(std::string line; std::getline(in, line); )
+        lines.push_back(line);
+    std::sort(lines.begin(), lines.end());
+    return lines;
+}
+
+TEST_CASE ("Testing Scheduler", "[Scheduler]")
+{
+    SECTION("Scheduled runs play the same games as threaded runs")
+    {
+        std::cout<<"Testing games in flight on the scheduler"<<std::endl;
+        Cylink::SimulationConfig config;
+        config.games = 300;
+        config.threads = 2;
+        config.seed = 77;
+        config.strategy[1] = "scan";
+
+        std::ostringstream threaded;
+        Cylink::SimulationSummary expected = Cylink::runSimulation(config, threaded);
+
+        config.inflight = 16;
+        std::ostringstream scheduled;
+        Cylink::SimulationSummary summary = Cylink::runSimulation(config, scheduled);
+        CHECK(summary.games == 300);
+        CHECK(summary.wins[SIM_PLAYER1] == expected.wins[SIM_PLAYER1]);
+        CHECK(summary.wins[SIM_PLAYER2] == expected.wins[SIM_PLAYER2]);
+        CHECK(sortedLines(scheduled.str()) == sortedLines(threaded.str()));
+
+        /* More slots than games */
+        config.games = 5;
+        config.inflight = 64;
+        std::ostringstream few;
+        CHECK(Cylink::runSimulation(config, few).games == 5);
+    }
+
+    SECTION("Asynchronous strategies suspend games without changing them")
+    {
+        std::cout<<"Testing asynchronous strategies"<<std::endl;
+        Cylink::SimulationConfig config;
+        config.fleet = Cylink::defaultFleet();
+        config.seed = 99;
+        config.strategy[0] = "scan";
+
+        std::mutex lock;
+        std::vector<ParkedStrategy::Parked> parked;
+        std::atomic<bool> stop(false);
+        std::thread answering(answerParked, std::ref(lock), std::ref(parked), std::ref(stop));
+
+        const int games = 8;
+        std::vector<Cylink::GameResult> expected;
+        Cylink::GameRunner local(config);
+        for(int game = 0; game < games; game++)
+            expected.push_back(local.play(game));
+
+        /* Blocking on the calling thread */
+        Cylink::GameRunner blocking(config);
+        blocking.setStrategy(0, std::make_unique<ParkedStrategy>(Cylink::Strategy::create("scan", config.length, config.width), lock, parked));
+        for(int game = 0; game < games; game++)
+        {
+            Cylink::GameResult result = blocking.play(game);
+            CHECK(result.winner == expected[game].winner);
+            CHECK(result.turns == expected[game].turns);
+        }
+
+        /* Every game in flight at once on two scheduler threads */
+        std::vector<std::unique_ptr<Cylink::GameRunner>> runners;
+        std::vector<Cylink::Task<Cylink::GameResult>> tasks;
+        {
+            Cylink::Scheduler scheduler(2);
+            for(int game = 0; game < games; game++)
+            {
+                runners.push_back(std::make_unique<Cylink::GameRunner>(config));
+                runners.back()->setStrategy(0, std::make_unique<ParkedStrategy>(Cylink::Strategy::create("scan", config.length, config.width), lock, parked));
+                tasks.push_back(runners.back()->playTask(game, nullptr, scheduler));
+            }
+            std::atomic<int> finished(0);
+            for(auto& task : tasks)
+            {
+                task.onDone([](void* count) { (*static_cast<std::atomic<int>*>(count))++; }, &finished);
+                scheduler.schedule(task.handle());
+            }
+            while(finished < games)
+                std::this_thread::yield();
+        }
+        for(int game = 0; game < games; game++)
+        {
+            Cylink::GameResult result = tasks[game].result();
+            CHECK(result.winner == expected[game].winner);
+            CHECK(result.turns == expected[game].turns);
+        }
+
+        stop = true;
+        answering.join();
+    }
+}
@@ -0,0 +1,142 @@
+/**
+ * @file sharing_bench.cpp
+ * Measures how per-game state scales from 1 to 64 threads, to show whether neighbouring games' state shares
+ * cache lines. First each thread updates a hot state block (shot cursor, fleet counter and random stream) held
+ * next to the other threads' blocks in one vector, once packed and once cache line aligned. Then each thread
+ * plays games on a GameRunner kept next to the other threads' runners in one vector.
+ * Usage: sharing_bench [max threads] [games per thread]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "random.h"
+#include "simulation.h"
+
+#define BENCH_MAX_THREADS 64
+#define BENCH_GAMES 2000
+#define BENCH_UPDATES 20000000LL
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ @struct PackedState
+ Hot per-game state laid out without regard to cache lines, 48 bytes so neighbours straddle lines.
+*/
+struct PackedState
+{
+    uint64_t cursor = 0;
+    int active = 0;
+    Cylink::Xoshiro256 engine;
+};
+
+/**
+ @struct AlignedState
+ The same state on a cache line of its own.
+*/
+struct alignas(64) AlignedState
+{
+    uint64_t cursor = 0;
+    int active = 0;
+    Cylink::Xoshiro256 engine;
+};
+
+/**
+ Run a function on the given number of threads and time it.
+ @return
+    The elapsed seconds.
+*/
+template<typename Body>
+static double timeThreads(int threads, Body body)
+{
+    std::vector<std::thread> workers;
+    auto start = Clock::now();
+    for(int tid = 0; tid < threads; tid++)
+        workers.emplace_back(body, tid);
+    for(auto& worker : workers)
+        worker.join();
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    return elapsed.count();
+}
+
+/**
+ Update each thread's state block BENCH_UPDATES times in total.
+ @return
+    Updates per second.
+*/
+template<typename State>
+static double updateRate(int threads)
+{
+    std::vector<State> states(threads);
+    for(int tid = 0; tid < threads; tid++)
+        states[tid].engine.seed(tid);
+    long long share = BENCH_UPDATES / threads;
+    double seconds = timeThreads(threads, [&](int tid)
+    {
+        State& state = states[tid];
+        for(long long update = 0; update < share; update++)
+        {
+            state.cursor++;
+            state.active ^= static_cast<int>(state.engine() & 1);
+            /* Keep the state in memory rather than registers, as game code does */
+            asm volatile("" : : "r"(&state) : "memory");
+        }
+    });
+    return share * threads / seconds;
+}
+
+/**
+ Play games on runners held side by side in one vector, one runner per thread.
+ @return
+    Games per second.
+*/
+static double gameRate(const Cylink::SimulationConfig& config, int threads, long long games)
+{
+    std::vector<Cylink::GameRunner> runners;
+    runners.reserve(threads);
+    for(int tid = 0; tid < threads; tid++)
+        runners.emplace_back(config);
+    double seconds = timeThreads(threads, [&](int tid)
+    {
+        for(long long game = 0; game < games; game++)
+            runners[tid].play(tid * games + game);
+    });
+    return games * threads / seconds;
+}
+
+int main(int argc, char* argv[])
+{
+    int maxThreads = (argc > 1) ? std::atoi(argv[1]) : BENCH_MAX_THREADS;
+    long long games = (argc > 2) ? std::atoll(argv[2]) : BENCH_GAMES;
+    if(maxThreads <= 0 || games <= 0)
+    {
+        std::cerr<<"Usage: sharing_bench [max threads] [games per thread]\n";
+        return 1;
+    }
+
+    Cylink::SimulationConfig config;
+    config.fleet = Cylink::defaultFleet();
+    config.strategy[0] = "parity";
+    config.strategy[1] = "random";
+
+    std::cout<<std::thread::hardware_concurrency()<<" hardware threads, GameRunner "<<sizeof(Cylink::GameRunner)
+        <<" bytes aligned to "<<alignof(Cylink::GameRunner)<<"\n"
+        <<"Efficiency is games/s relative to one thread times the cores the threads can use, 1.00 is linear scaling.\n"
+        <<"threads   packed updates/s  aligned updates/s   games/s  efficiency\n"<<std::fixed;
+    int cores = std::max(1u, std::thread::hardware_concurrency());
+    double single = 0.0;
+    for(int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        double packed = updateRate<PackedState>(threads);
+        double aligned = updateRate<AlignedState>(threads);
+        double rate = gameRate(config, threads, games);
+        if(threads == 1)
+            single = rate;
+        std::cout<<std::setw(7)<<threads<<std::setprecision(0)<<std::setw(19)<<packed<<std::setw(19)<<aligned
+            <<std::setw(10)<<rate<<std::setprecision(2)<<std::setw(12)<<rate / single / std::min(threads, cores)<<"\n";
+    }
+    return 0;
+}
@@ -0,0 +1,617 @@
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "simulation.h"
+#include "error.h"
+#include "instrument.h"
+#include "random.h"
+#include "utils.h"
+
+#define SIM_ARG_ERROR ErrorCode::ERR_INVALID_ARG
+#define SIM_IO_ERROR ErrorCode::ERR_IO
+
+#define SIM_STREAM_FIRST 0
+#define SIM_STREAM_LAYOUT 1
+#define SIM_STREAM_STRATEGY 3
+
+namespace Cylink
+{
+    /**
+     Create a runner for the given configuration. The configuration must outlive the runner.
+     An unknown strategy name or parameters the strategy doesn't take will result in an exception.
+    */
+    GameRunner::GameRunner(const SimulationConfig& config)
+        : config_(config),
+          players_{Player(config.length, config.width), Player(config.length, config.width)},
+          generators_{PlacementGenerator(config.fleet, config.length, config.width, 0, config.layout),
+                      PlacementGenerator(config.fleet, config.length, config.width, 0, config.layout)}
+    {
+        for(int idx = 0; idx < 2; idx++)
+        {
+            std::unique_ptr<Strategy> strategy = Strategy::create(config.strategy[idx], config.length, config.width);
+            strategy->setFleet(config.fleet);
+            if(!config.parameters[idx].empty())
+                strategy->setParameters(config.parameters[idx]);
+            players_[idx].setStrategy(std::move(strategy));
+        }
+    }
+
+    /**
+     Awaits a player's next fire position. A local strategy is asked directly in await_ready() so the game
+     doesn't suspend; an asynchronous one gets a FireRequest and the game suspends until it is completed.
+    */
+    class FireAwaitable
+    {
+    public:
+        FireAwaitable(Player& player, Executor& executor)
+            : player_(player), executor_(executor), request_()
+        {
+        }
+
+        bool await_ready()
+        {
+            if(player_.firesAsync())
+                return false;
+            request_.position = player_.suggestFirePosition();
+            return true;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            request_.executor = &executor_;
+            request_.waiter = handle;
+            player_.requestFirePosition(request_);
+        }
+
+        std::pair<int, int> await_resume()
+        {
+            return request_.position;
+        }
+
+    private:
+        Player& player_;
+        Executor& executor_;
+        FireRequest request_;
+    };
+
+    /**
+     Replace the strategy of one player, eg. with an asynchronous strategy.
+     @param player
+        0 for player 1, 1 for player 2.
+    */
+    void GameRunner::setStrategy(int player, std::unique_ptr<Strategy> strategy)
+    {
+        players_[player].setStrategy(std::move(strategy));
+    }
+
+    /**
+     Play a complete game on the calling thread. If a strategy is asynchronous the thread waits for its answers.
+     See playTask().
+     @return
+        The result of the game.
+    */
+    GameResult GameRunner::play(long long game, GameStats* stats)
+    {
+        BlockingExecutor executor;
+        return executor.run(playTask(game, stats, executor));
+    }
+
+    /**
+     Play a complete game as a coroutine. Both fleets are placed at random, or drawn from the player's placement
+     table if the configuration has one, a random player starts and the players
+     alternate shots until one of them has no vessels left. A game that runs for more than
+     SIM_MAX_TURNS_FACTOR times the number of board cells per player is a draw.
+     If the fleet can't be placed on the board the task finishes with an exception.
+     The runner must not be used for another game until the task is done.
+     @param game
+        The index of the game within the run. Together with the run seed it determines every random choice.
+     @param stats
+        If not null, every shot and its latency is recorded in these statistics.
+     @param executor
+        Resumes the game once an asynchronous strategy answers.
+     @return
+        A task, not started yet, producing the result of the game.
+    */
+    Task<GameResult> GameRunner::playTask(long long game, GameStats* stats, Executor& executor)
+    {
+        GameResult result;
+        result.game = game;
+
+        for(int idx = 0; idx < 2; idx++)
+        {
+            players_[idx].reset(streamSeed(config_.seed, game, SIM_STREAM_STRATEGY + idx));
+
+            uint64_t layoutSeed = streamSeed(config_.seed, game, SIM_STREAM_LAYOUT + idx);
+            if(config_.placements[idx])
+            {
+                if(!players_[idx].setupBoard(*config_.placements[idx], layoutSeed))
+                {
+                    Error argError("The placement table's layout does not fit on the board.", SIM_ARG_ERROR, __FILE__, __LINE__);
+                    throw argError;
+                }
+                continue;
+            }
+            generators_[idx].reseed(layoutSeed);
+            LayoutStatus status = players_[idx].setupBoard(generators_[idx]);
+            while(status == LayoutStatus::LAYOUT_RETRY)
+            {
+                generators_[idx].reseed(++layoutSeed);
+                status = players_[idx].setupBoard(generators_[idx]);
+            }
+            if(status == LayoutStatus::LAYOUT_FAILED)
+            {
+                Error argError("The fleet does not fit on the board.", SIM_ARG_ERROR, __FILE__, __LINE__);
+                throw argError;
+            }
+        }
+
+        int attacker = streamSeed(config_.seed, game, SIM_STREAM_FIRST) & 1;
+        result.firstPlayer = attacker + 1;
+        const int maxTurns = SIM_MAX_TURNS_FACTOR * config_.length * config_.width * 2;
+        if(stats)
+            stats->beginGame();
+
+        int xCord, yCord;
+        while(result.turns < maxTurns)
+        {
+            int defender = 1 - attacker;
+            std::chrono::steady_clock::time_point moveStart;
+            if(stats)
+                moveStart = std::chrono::steady_clock::now();
+            std::tie(xCord, yCord) = co_await FireAwaitable(players_[attacker], executor);
+            GameBoard::StrikeResult sResult = players_[attacker].launchAttack(players_[defender], xCord, yCord);
+            if(stats)
+            {
+                std::chrono::nanoseconds moveTime = std::chrono::steady_clock::now() - moveStart;
+                stats->recordMoveLatency(moveTime.count());
+
+                Vessel::VType sunk = Vessel::VType::GUNBOAT;
+                if(sResult == GameBoard::StrikeResult::STRIKE_DESTROYED)
+                {
+                    const GameBoard& board = players_[defender].getBoard();
+                    sunk = board.getVessel(board.cellAt(xCord, yCord).vesselId).getType();
+                }
+                stats->recordShot(attacker, xCord, yCord, sResult, sunk);
+            }
+
+            result.turns++;
+            result.shots[attacker]++;
+            if(sResult == GameBoard::StrikeResult::STRIKE_HIT || sResult == GameBoard::StrikeResult::STRIKE_DESTROYED)
+                result.hits[attacker]++;
+
+            bool gameOver;
+            {
+                HS_TIME(GAME_OVER_CHECK);
+                gameOver = !players_[defender].hasVessels();
+            }
+            if(gameOver)
+            {
+                result.winner = attacker + 1;
+                break;
+            }
+            attacker = defender;
+        }
+        if(stats)
+            stats->endGame(result.winner - 1);
+        co_return result;
+    }
+
+    /**
+     @return
+        The fleet played when no fleet file is given.
+    */
+    std::vector<Vessel::VType> defaultFleet()
+    {
+        std::vector<Vessel::VType> vessels;
+        vessels.insert(vessels.end(), 1, Vessel::VType::CARRIER);
+        vessels.insert(vessels.end(), 3, Vessel::VType::CRUISER);
+        vessels.insert(vessels.end(), 3, Vessel::VType::DESTROYER);
+        vessels.insert(vessels.end(), 2, Vessel::VType::FRIGATE);
+        vessels.insert(vessels.end(), 2, Vessel::VType::SUBMARINE);
+        return vessels;
+    }
+
+    /**
+     Read a fleet description. Each line names a vessel type by its short or long name (see Vessel::formatVessel())
+     followed by an optional count, eg. "Destroyer 3" or "CA". Text following a '#' is ignored.
+     Unknown vessel names, bad counts or an empty fleet result in an exception.
+     @param is
+        The stream to read from.
+     @return
+        The vessels in the fleet.
+    */
+    std::vector<Vessel::VType> loadFleet(std::istream& is)
+    {
+        std::vector<Vessel::VType> result;
+        std::string line;
+        int lineNumber = 0;
+
+        while(std::getline(is, line))
+        {
+            lineNumber++;
+            std::string_view text(line);
+            text = text.substr(0, text.find('#'));
+
+            std::string_view tokens[3];
+            size_t tokenCount = 0;
+            StringUtils::Tokenizer tokenizer(text, ' ', true);
+            for(std::string_view token; tokenCount < 3 && tokenizer.next(token); )
+                tokens[tokenCount++] = token;
+            if(tokenCount == 0)
+                continue;
+
+            bool found = false;
+            Vessel::VType vtype = Vessel::VType::GUNBOAT;
+            for(int type = static_cast<int>(Vessel::VType::GUNBOAT); type <= static_cast<int>(Vessel::VType::CARRIER); type++)
+            {
+                vtype = static_cast<Vessel::VType>(type);
+                if(tokens[0] == Vessel::formatVessel(vtype, false) || tokens[0] == Vessel::formatVessel(vtype, true))
+                {
+                    found = true;
+                    break;
+                }
+            }
+
+            int count = 1;
+            if(tokenCount > 1)
+            {
+                const char* end = tokens[1].data() + tokens[1].size();
+                std::from_chars_result parsed = std::from_chars(tokens[1].data(), end, count);
+                if(parsed.ec != std::errc() || parsed.ptr != end || count < 0)
+                    found = false;
+            }
+
+            if(!found || tokenCount > 2)
+            {
+                Error argError("Invalid fleet entry on line " + std::to_string(lineNumber) + ".", SIM_ARG_ERROR, __FILE__, __LINE__);
+                throw argError;
+            }
+            result.insert(result.end(), count, vtype);
+        }
+
+        if(result.empty())
+        {
+            Error argError("The fleet is empty.", SIM_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        return result;
+    }
+
+    /**
+     Read a fleet description from a file. See loadFleet(std::istream&) for the format.
+    */
+    std::vector<Vessel::VType> loadFleet(const std::string& path)
+    {
+        std::ifstream file(path);
+        if(!file)
+        {
+            Error ioError("Unable to open fleet file " + path + ".", SIM_IO_ERROR, __FILE__, __LINE__);
+            throw ioError;
+        }
+        return loadFleet(file);
+    }
+
+    /**
+     Pack a game result into the record passed to the writer thread.
+    */
+    static GameRecord compactResult(const GameResult& result)
+    {
+        GameRecord record;
+        record.game = result.game;
+        record.turns = static_cast<uint16_t>(std::min(result.turns, 0xFFFF));
+        for(int idx = 0; idx < 2; idx++)
+        {
+            record.shots[idx] = static_cast<uint16_t>(std::min(result.shots[idx], 0xFFFF));
+            record.hits[idx] = static_cast<uint16_t>(std::min(result.hits[idx], 0xFFFF));
+        }
+        record.winner = static_cast<uint8_t>(result.winner);
+        record.firstPlayer = static_cast<uint8_t>(result.firstPlayer);
+        return record;
+    }
+
+    struct SlotContext;
+    static void finishSlotGame(void* data);
+
+    /**
+     @struct GameSlot
+     One game in flight on the scheduler. When its game finishes the slot submits the result and starts the
+     next game of the run on the same runner.
+    */
+    struct GameSlot
+    {
+        SlotContext& context;
+        GameRunner runner;
+        std::unique_ptr<GameStats> stats;
+        Task<GameResult> task;
+        long long wins[3] = {0, 0, 0};
+
+        GameSlot(SlotContext& shared, const SimulationConfig& settings) : context(shared), runner(settings) {}
+    };
+
+    /**
+     @struct SlotContext
+     The state the slots of a scheduled run share.
+    */
+    struct SlotContext
+    {
+        const SimulationConfig& settings;
+        RecordWriter& writer;
+        Scheduler* scheduler;               /**< Set once the scheduler is up, the context outlives it */
+        std::atomic<long long> nextGame;
+        std::latch idle;                    /**< Counts down as slots run out of games */
+        std::mutex failureLock;
+        std::exception_ptr failure;
+    };
+
+    /**
+     Start the next game of the run in a slot, or retire the slot once every game has been handed out.
+     The game is queued on the scheduler rather than run inline, so finishing games don't nest on the stack.
+    */
+    static void nextSlotGame(GameSlot& slot)
+    {
+        SlotContext& context = slot.context;
+        long long game = context.nextGame++;
+        if(game >= context.settings.games)
+        {
+            context.idle.count_down();
+            return;
+        }
+        slot.task = slot.runner.playTask(context.settings.firstGame + game, slot.stats.get(), *context.scheduler);
+        slot.task.onDone(finishSlotGame, &slot);
+        context.scheduler->schedule(slot.task.handle());
+    }
+
+    /**
+     Runs on the thread that finished a slot's game. Replacing the task in nextSlotGame() destroys the finished frame.
+    */
+    static void finishSlotGame(void* data)
+    {
+        GameSlot& slot = *static_cast<GameSlot*>(data);
+        SlotContext& context = slot.context;
+        try
+        {
+            GameResult result = slot.task.result();
+            slot.wins[result.winner]++;
+            context.writer.submit(compactResult(result));
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> guard(context.failureLock);
+            context.failure = std::current_exception();
+            context.nextGame = context.settings.games;
+        }
+        nextSlotGame(slot);
+    }
+
+    /**
+     Play the games of a run with settings.inflight games in flight on a Scheduler of settings.threads threads.
+     Each slot keeps its own runner and statistics, merged once every game is done.
+    */
+    static SimulationSummary runScheduled(const SimulationConfig& settings, RecordWriter& writer, GameStats* stats)
+    {
+        SimulationSummary summary;
+        auto start = std::chrono::steady_clock::now();
+
+        long long inflight = std::max<long long>(1, std::min<long long>(settings.inflight, settings.games));
+        std::vector<std::unique_ptr<GameSlot>> slots;
+        std::exception_ptr failure;
+        {
+            /* Declared after the context, the scheduler joins its threads before the latch and the slots they touch go away */
+            SlotContext context{settings, writer, nullptr, {0}, std::latch(inflight), {}, {}};
+            Scheduler scheduler(settings.threads);
+            context.scheduler = &scheduler;
+            for(long long idx = 0; idx < inflight; idx++)
+            {
+                slots.push_back(std::make_unique<GameSlot>(context, settings));
+                if(stats)
+                    slots.back()->stats = std::make_unique<GameStats>(settings.length, settings.width);
+            }
+            for(auto& slot : slots)
+                nextSlotGame(*slot);
+            context.idle.wait();
+            failure = context.failure;
+        }
+        writer.close();
+
+        if(failure)
+            std::rethrow_exception(failure);
+
+        for(auto& slot : slots)
+        {
+            if(slot->stats)
+                stats->merge(*slot->stats);
+            for(int idx = 0; idx < 3; idx++)
+            {
+                summary.wins[idx] += slot->wins[idx];
+                summary.games += slot->wins[idx];
+            }
+        }
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        summary.seconds = elapsed.count();
+        summary.dropped = writer.dropped();
+        return summary;
+    }
+
+    /**
+     Play the games of a run on settings.threads threads, handing each result to the record writer.
+     With settings.numa the workers are dealt to the NUMA nodes and pinned before creating their runner, so
+     each worker's malloc arena, random streams and boards are allocated on its own node.
+     With settings.inflight set the games run on the coroutine scheduler instead, see runScheduled().
+     The writer is closed before returning.
+    */
+    static SimulationSummary runGames(const SimulationConfig& settings, RecordWriter& writer, GameStats* stats)
+    {
+        if(settings.inflight > 0)
+        {
+            SimulationSummary summary = runScheduled(settings, writer, stats);
+            summary.nodes.push_back({0, std::max(1, settings.threads), 0, summary.games});
+            return summary;
+        }
+
+        int threads = std::max(1, settings.threads);
+        Topology topology = settings.numa ? Topology::discover() : Topology();
+
+        std::atomic<long long> nextGame(0);
+        std::mutex summaryLock;
+        SimulationSummary summary;
+        for(auto& node : topology.nodes())
+            summary.nodes.push_back({node.id, 0, 0, 0});
+        std::exception_ptr failure;
+
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> workers;
+        for(int tid = 0; tid < threads; tid++)
+        {
+            workers.emplace_back([&, tid]()
+            {
+                /* Pin before the first allocation so the worker's memory is first touched on its node */
+                bool pinned = settings.numa && topology.pinWorker(tid);
+                std::unique_ptr<GameStats> local;
+                if(stats)
+                    local = std::make_unique<GameStats>(settings.length, settings.width);
+                long long wins[3] = {0, 0, 0};
+                try
+                {
+                    GameRunner runner(settings);
+                    for(long long game = nextGame++; game < settings.games; game = nextGame++)
+                    {
+                        GameResult result = runner.play(settings.firstGame + game, local.get());
+                        wins[result.winner]++;
+                        writer.submit(compactResult(result));
+                    }
+                }
+                catch(...)
+                {
+                    std::lock_guard<std::mutex> guard(summaryLock);
+                    failure = std::current_exception();
+                    nextGame = settings.games;
+                }
+
+                std::lock_guard<std::mutex> guard(summaryLock);
+                if(local)
+                    stats->merge(*local);
+                NodeSummary& node = summary.nodes[topology.nodeOfWorker(tid)];
+                node.threads++;
+                node.pinned += pinned ? 1 : 0;
+                for(int idx = 0; idx < 3; idx++)
+                {
+                    summary.wins[idx] += wins[idx];
+                    summary.games += wins[idx];
+                    node.games += wins[idx];
+                }
+            });
+        }
+        for(auto& worker : workers)
+            worker.join();
+        writer.close();
+
+        if(failure)
+            std::rethrow_exception(failure);
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        summary.seconds = elapsed.count();
+        summary.dropped = writer.dropped();
+        return summary;
+    }
+
+    /**
+     Check whether a layout places exactly the vessels of a fleet, in any order.
+    */
+    static bool sameFleet(const std::vector<VesselPlacement>& layout, std::vector<Vessel::VType> fleet)
+    {
+        std::vector<Vessel::VType> placed;
+        for(auto& placement : layout)
+            placed.push_back(placement.vtype);
+        std::sort(placed.begin(), placed.end());
+        std::sort(fleet.begin(), fleet.end());
+        return placed == fleet;
+    }
+
+    /**
+     Check a run's settings before any thread starts and fill in the default fleet.
+     Placement tables must be built for the run's board and fleet.
+    */
+    static SimulationConfig validateConfig(const SimulationConfig& config)
+    {
+        SimulationConfig settings = config;
+        if(settings.fleet.empty())
+            settings.fleet = defaultFleet();
+
+        if(settings.firstGame < 0)
+        {
+            Error argError("The first game can't be negative.", SIM_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        for(auto& table : settings.placements)
+        {
+            if(table && (table->size() == 0 || table->getLength() != settings.length || table->getWidth() != settings.width))
+            {
+                Error argError("The placement table does not match the board.", SIM_ARG_ERROR, __FILE__, __LINE__);
+                throw argError;
+            }
+            for(size_t idx = 0; table && idx < table->size(); idx++)
+            {
+                if(!sameFleet(table->layout(idx), settings.fleet))
+                {
+                    Error argError("The placement table does not match the fleet.", SIM_ARG_ERROR, __FILE__, __LINE__);
+                    throw argError;
+                }
+            }
+        }
+
+        /* Constructing a runner up front validates the strategies and board before any thread starts */
+        GameRunner validate(settings);
+        return settings;
+    }
+
+    /**
+     Play config.games games on config.threads threads and write one result line per game to the output stream.
+     Workers pass results through a lock-free queue to a writer thread, which is the only thread touching the stream.
+     Games are handed out to threads in order but results are written as they complete, so lines may be out of order.
+     @param config
+        The run settings. An empty fleet is replaced by defaultFleet().
+     @param out
+        The stream results are written to.
+     @param stats
+        If not null, statistics for the run are added to it. Each thread keeps its own accumulator and
+        merges it once all its games are done. Must be sized for the configured board.
+     @return
+        Totals for the run.
+    */
+    SimulationSummary runSimulation(const SimulationConfig& config, std::ostream& out, GameStats* stats)
+    {
+        SimulationConfig settings = validateConfig(config);
+        RecordWriter writer(out, settings.backpressure, settings.queueSize);
+        return runGames(settings, writer, stats);
+    }
+
+    /**
+     Play a run as runSimulation(const SimulationConfig&, std::ostream&, GameStats*) does, writing the results to
+     a file descriptor with batched writev() calls. The descriptor is not closed.
+    */
+    SimulationSummary runSimulation(const SimulationConfig& config, int fd, GameStats* stats)
+    {
+        SimulationConfig settings = validateConfig(config);
+        RecordWriter writer(fd, settings.backpressure, settings.queueSize);
+        return runGames(settings, writer, stats);
+    }
+
+    /**
+     Write a game result as a single space separated line without the line ending.
+    */
+    std::ostream& operator<<(std::ostream& os, const GameResult& result)
+    {
+        os<<result.game<<" "<<result.winner<<" "<<result.firstPlayer<<" "<<result.turns<<" "
+          <<result.shots[0]<<" "<<result.shots[1]<<" "<<result.hits[0]<<" "<<result.hits[1];
+        return os;
+    }
+}
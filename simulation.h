@@ -0,0 +1,119 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "player.h"
+#include "recordwriter.h"
+#include "scheduler.h"
+#include "statistics.h"
+#include "topology.h"
+
+#define SIM_MAX_TURNS_FACTOR 4
+#define SIM_DRAW 0
+#define SIM_PLAYER1 1
+#define SIM_PLAYER2 2
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     @struct SimulationConfig
+     Settings for a batch of simulated games. Declaration shows default field values.
+    */
+    struct SimulationConfig
+    {
+        long long games = 1;
+        long long firstGame = 0;        /**< Index of the first game, games firstGame to firstGame + games - 1 are played */
+        int threads = 1;
+        uint64_t seed = 0;
+        int length = GB_BOARD_SIZE;
+        int width = GB_BOARD_SIZE;
+        std::vector<Vessel::VType> fleet;
+        LayoutMode layout = LayoutMode::LAYOUT_SEQUENTIAL;              /**< How random layouts are sampled */
+        std::string strategy[2] = {"random", "random"};
+        Backpressure backpressure = Backpressure::BACKPRESSURE_BLOCK;  /**< What workers do when the writer falls behind */
+        size_t queueSize = RW_QUEUE_SIZE;                               /**< Records queued for the writer thread */
+        int inflight = 0;               /**< Games in flight on the coroutine scheduler, 0 plays one game per thread at a time */
+        std::shared_ptr<const PlacementTable> placements[2];           /**< Layouts drawn for each player instead of random ones */
+        std::vector<double> parameters[2];                              /**< Strategy parameters of each player, defaults if empty */
+        bool numa = false;              /**< Pin each worker thread to a NUMA node before it allocates, see Topology. Ignored with inflight set */
+    };
+
+    /**
+     @struct GameResult
+     The outcome of a single simulated game.
+     Shots and hits are indexed by player, 0 for player 1 and 1 for player 2.
+    */
+    struct GameResult
+    {
+        long long game = 0;             /**< Index of the game within the run */
+        int winner = SIM_DRAW;          /**< SIM_PLAYER1, SIM_PLAYER2 or SIM_DRAW */
+        int firstPlayer = SIM_PLAYER1;
+        int turns = 0;
+        int shots[2] = {0, 0};
+        int hits[2] = {0, 0};
+    };
+
+    /**
+     @struct NodeSummary
+     The share of a run played on one NUMA node.
+    */
+    struct NodeSummary
+    {
+        int node = 0;                   /**< Node id, 0 without NUMA pinning */
+        int threads = 0;
+        int pinned = 0;                 /**< Threads pinned to a CPU of the node */
+        long long games = 0;
+    };
+
+    /**
+     @struct SimulationSummary
+     Totals for a batch of games.
+    */
+    struct SimulationSummary
+    {
+        long long games = 0;
+        long long wins[3] = {0, 0, 0}; /**< Indexed by SIM_DRAW, SIM_PLAYER1 and SIM_PLAYER2 */
+        long long dropped = 0;          /**< Records not written because the writer queue was full */
+        double seconds = 0.0;
+        std::vector<NodeSummary> nodes; /**< Games per node, a single entry unless config.numa found several */
+    };
+
+    /**
+     Plays games between two players. A runner owns its players and layout generators and reuses them
+     for every game, so one runner should be created per thread, or per game in flight on a Scheduler.
+     The turn loop is a coroutine that awaits each player's fire position. Local strategies answer at once
+     and the game never suspends; asynchronous strategies suspend the game until they answer.
+    */
+    class GameRunner
+    {
+    public:
+        GameRunner(const SimulationConfig& config);
+
+        void setStrategy(int player, std::unique_ptr<Strategy> strategy);
+        GameResult play(long long game, GameStats* stats = nullptr);
+        Task<GameResult> playTask(long long game, GameStats* stats, Executor& executor);
+
+    private:
+        const SimulationConfig& config_;
+        Player players_[2];
+        PlacementGenerator generators_[2];
+    };
+
+    std::vector<Vessel::VType> defaultFleet();
+    std::vector<Vessel::VType> loadFleet(std::istream& is);
+    std::vector<Vessel::VType> loadFleet(const std::string& path);
+
+    SimulationSummary runSimulation(const SimulationConfig& config, std::ostream& out, GameStats* stats = nullptr);
+    SimulationSummary runSimulation(const SimulationConfig& config, int fd, GameStats* stats = nullptr);
+
+    std::ostream& operator<<(std::ostream& os, const GameResult& result);
+}
+
+#endif
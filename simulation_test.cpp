@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <sstream>
+#include "error.h"
+#include "simulation.h"
+
+TEST_CASE ("Testing Simulation", "[Simulation]")
+{
+    SECTION("Loading fleet descriptions")
+    {
+        std::cout<<"Testing fleet file parsing"<<std::endl;
+
+        std::istringstream good("# standard names\nCarrier\nCR 3   # three cruisers\n\nDestroyer 2\n");
+        std::vector<Cylink::Vessel::VType> fleet = Cylink::loadFleet(good);
+        REQUIRE(fleet.size() == 6);
+        CHECK(fleet[0] == Cylink::Vessel::VType::CARRIER);
+        CHECK(fleet[3] == Cylink::Vessel::VType::CRUISER);
+        CHECK(fleet[5] == Cylink::Vessel::VType::DESTROYER);
+
+        std::istringstream unknown("Battleship 1\n");
+        CHECK_THROWS_AS(Cylink::loadFleet(unknown), Cylink::Error);
+
+        std::istringstream badCount("Carrier many\n");
+        CHECK_THROWS_AS(Cylink::loadFleet(badCount), Cylink::Error);
+
+        std::istringstream empty("# nothing here\n");
+        CHECK_THROWS_AS(Cylink::loadFleet(empty), Cylink::Error);
+    }
+
+    SECTION("Games finish with a winner and replay from the seed")
+    {
+        std::cout<<"Testing complete games"<<std::endl;
+        Cylink::SimulationConfig config;
+        config.fleet = Cylink::defaultFleet();
+        config.seed = 1234;
+        config.strategy[1] = "scan";
+
+        Cylink::GameRunner runner(config);
+        Cylink::GameRunner replay(config);
+        for(long long game = 0; game < 50; game++)
+        {
+            Cylink::GameResult result = runner.play(game);
+            CHECK(result.winner != SIM_DRAW);
+
+            /* The winner sank every vessel cell of the standard fleet */
+            CHECK(result.hits[result.winner - 1] == 62);
+            CHECK(result.shots[0] + result.shots[1] == result.turns);
+
+            /* Games depend only on the seed and index, not on what the runner played before */
+            Cylink::GameResult again = replay.play(49 - game);
+            Cylink::GameResult same = runner.play(49 - game);
+            CHECK(again.winner == same.winner);
+            CHECK(again.turns == same.turns);
+        }
+    }
+
+    SECTION("Running a batch on several threads")
+    {
+        std::cout<<"Testing threaded batches"<<std::endl;
+        Cylink::SimulationConfig config;
+        config.games = 200;
+        config.threads = 3;
+
+        std::ostringstream out;
+        Cylink::SimulationSummary summary = Cylink::runSimulation(config, out);
+        CHECK(summary.games == 200);
+        CHECK(summary.wins[SIM_PLAYER1] + summary.wins[SIM_PLAYER2] + summary.wins[SIM_DRAW] == 200);
+
+        /* One header line plus one line per game */
+        std::string text = out.str();
+        CHECK(std::count(text.begin(), text.end(), '\n') == 201);
+
+        config.strategy[0] = "nonsense";
+        CHECK_THROWS_AS(Cylink::runSimulation(config, out), Cylink::Error);
+    }
+
+    SECTION("Per-game state keeps to its own cache lines")
+    {
+        std::cout<<"Testing per-game state alignment"<<std::endl;
+        CHECK(alignof(Cylink::GameBoard) == 64);
+        CHECK(alignof(Cylink::Player) == 64);
+        CHECK(alignof(Cylink::Strategy) == 64);
+        CHECK(sizeof(Cylink::GameRunner) % 64 == 0);
+
+        /* A board is one line of strike state and one of fleet, its buffers are on lines of their own */
+        CHECK(sizeof(Cylink::GameBoard) == 2 * 64);
+        Cylink::GameBoard board(3, 7);
+        CHECK(reinterpret_cast<uintptr_t>(&board.cellAt(0, 0)) % 64 == 0);
+        CHECK(Cylink::CacheLineAllocator<char>::paddedSize(1) == 64);
+        CHECK(Cylink::CacheLineAllocator<char>::paddedSize(65) == 128);
+
+        /* Runners side by side in a vector start on separate lines, and their strategies are aligned */
+        Cylink::SimulationConfig config;
+        config.fleet = Cylink::defaultFleet();
+        std::vector<Cylink::GameRunner> runners;
+        for(int idx = 0; idx < 3; idx++)
+            runners.emplace_back(config);
+        for(auto& runner : runners)
+            CHECK(reinterpret_cast<uintptr_t>(&runner) % 64 == 0);
+        std::unique_ptr<Cylink::Strategy> strategy = Cylink::Strategy::create("parity", GB_BOARD_SIZE, GB_BOARD_SIZE);
+        CHECK(reinterpret_cast<uintptr_t>(strategy.get()) % 64 == 0);
+        CHECK(runners[2].play(5).winner == runners[0].play(5).winner);
+    }
+}
@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+#include "statistics.h"
+#include "error.h"
+
+#define STAT_ARG_ERROR ErrorCode::ERR_INVALID_ARG
+#define STAT_EXPONENTS 64
+
+namespace Cylink
+{
+    /**
+     Create an empty histogram for values in [0, maxValue]. Larger values are counted in the overflow bin.
+     A negative maximum will result in an exception.
+    */
+    Histogram::Histogram(int maxValue)
+        : bins_(), count_(0), sum_(0)
+    {
+        if(maxValue < 0)
+        {
+            Error argError("Histogram maximum may not be negative.", STAT_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        bins_.assign(static_cast<size_t>(maxValue) + 2, 0);
+    }
+
+    /**
+     Count a value. Negative values are counted as zero.
+    */
+    void Histogram::add(int value, uint64_t count)
+    {
+        value = std::max(0, value);
+        size_t bin = std::min(static_cast<size_t>(value), bins_.size() - 1);
+        bins_[bin] += count;
+        count_ += count;
+        sum_ += static_cast<uint64_t>(value) * count;
+    }
+
+    /**
+     Add the counts of a histogram with the same maximum.
+    */
+    void Histogram::merge(const Histogram& other)
+    {
+        if(other.bins_.size() != bins_.size())
+        {
+            Error argError("Histograms have different ranges.", STAT_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        for(size_t idx = 0; idx < bins_.size(); idx++)
+            bins_[idx] += other.bins_[idx];
+        count_ += other.count_;
+        sum_ += other.sum_;
+    }
+
+    uint64_t Histogram::count() const
+    {
+        return count_;
+    }
+
+    double Histogram::mean() const
+    {
+        return (count_ > 0) ? static_cast<double>(sum_) / count_ : 0.0;
+    }
+
+    /**
+     Find the smallest value v such that a fraction q of the counted values are at most v.
+     @return
+        The quantile, maxValue() + 1 if it falls in the overflow bin, or -1 if the histogram is empty.
+    */
+    int Histogram::quantile(double q) const
+    {
+        if(count_ == 0)
+            return -1;
+
+        uint64_t rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * count_));
+        uint64_t seen = 0;
+        for(size_t idx = 0; idx < bins_.size(); idx++)
+        {
+            seen += bins_[idx];
+            if(seen >= std::max<uint64_t>(rank, 1))
+                return static_cast<int>(idx);
+        }
+        return maxValue() + 1;
+    }
+
+    int Histogram::maxValue() const
+    {
+        return static_cast<int>(bins_.size()) - 2;
+    }
+
+    /**
+     @return
+        The number of times value was counted. Values beyond maxValue() are in overflow().
+    */
+    uint64_t Histogram::bin(int value) const
+    {
+        if(value < 0 || value > maxValue())
+            return 0;
+        return bins_[value];
+    }
+
+    uint64_t Histogram::overflow() const
+    {
+        return bins_.back();
+    }
+
+    /**
+     Create an empty latency histogram covering the full 64-bit range.
+    */
+    LatencyHistogram::LatencyHistogram()
+        : buckets_(STAT_EXPONENTS * STAT_SUB_BUCKETS, 0), count_(0),
+          min_(std::numeric_limits<uint64_t>::max()), max_(0), sum_(0.0)
+    {
+    }
+
+    /**
+     Map a value to its bucket. Values below STAT_SUB_BUCKETS get a bucket each; above that the
+     top STAT_SUB_BITS + 1 significant bits select the bucket.
+    */
+    int LatencyHistogram::bucketIndex(uint64_t value)
+    {
+        if(value < STAT_SUB_BUCKETS)
+            return static_cast<int>(value);
+
+        int exponent = 63 - __builtin_clzll(value);                 // >= STAT_SUB_BITS
+        int shift = exponent - STAT_SUB_BITS;
+        int sub = static_cast<int>((value >> shift) & (STAT_SUB_BUCKETS - 1));
+        return (shift + 1) * STAT_SUB_BUCKETS + sub;
+    }
+
+    /**
+     @return
+        The largest value that maps to the bucket.
+    */
+    uint64_t LatencyHistogram::bucketUpper(int index)
+    {
+        if(index < STAT_SUB_BUCKETS)
+            return index;
+
+        int shift = index / STAT_SUB_BUCKETS - 1;
+        uint64_t sub = index % STAT_SUB_BUCKETS;
+        uint64_t lower = (uint64_t(STAT_SUB_BUCKETS) + sub) << shift;
+        return lower + ((uint64_t(1) << shift) - 1);
+    }
+
+    void LatencyHistogram::add(uint64_t value)
+    {
+        buckets_[bucketIndex(value)]++;
+        count_++;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+        sum_ += static_cast<double>(value);
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram& other)
+    {
+        for(size_t idx = 0; idx < buckets_.size(); idx++)
+            buckets_[idx] += other.buckets_[idx];
+        count_ += other.count_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+        sum_ += other.sum_;
+    }
+
+    uint64_t LatencyHistogram::count() const
+    {
+        return count_;
+    }
+
+    uint64_t LatencyHistogram::min() const
+    {
+        return (count_ > 0) ? min_ : 0;
+    }
+
+    uint64_t LatencyHistogram::max() const
+    {
+        return max_;
+    }
+
+    double LatencyHistogram::mean() const
+    {
+        return (count_ > 0) ? sum_ / count_ : 0.0;
+    }
+
+    /**
+     Estimate a quantile as the upper bound of the bucket holding it, clamped to the largest recorded value.
+     @param q
+        The quantile in [0, 1].
+     @return
+        The estimated value or zero if nothing was recorded.
+    */
+    uint64_t LatencyHistogram::quantile(double q) const
+    {
+        if(count_ == 0)
+            return 0;
+
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * count_)));
+        uint64_t seen = 0;
+        for(size_t idx = 0; idx < buckets_.size(); idx++)
+        {
+            seen += buckets_[idx];
+            if(seen >= rank)
+                return std::min(bucketUpper(idx), max_);
+        }
+        return max_;
+    }
+
+    /**
+     Create empty statistics for games on a board of the given size.
+    */
+    GameStats::GameStats(int length, int width)
+        : lengthOfBoard_(length), widthOfBoard_(width), games_(0),
+          shotsToWin_(length * width * 2),
+          firstHits_(static_cast<size_t>(length) * width, 0),
+          timeToSink_(STAT_VESSEL_TYPES, Histogram(length * width * 2)),
+          moveLatency_(),
+          shots_{0, 0}, hit_{false, false}
+    {
+    }
+
+    /**
+     Start recording a new game.
+    */
+    void GameStats::beginGame()
+    {
+        shots_[0] = shots_[1] = 0;
+        hit_[0] = hit_[1] = false;
+    }
+
+    /**
+     Record a shot fired during the current game.
+     @param player
+        The player that fired, 0 or 1.
+     @param sunk
+        The type of vessel sunk. Only used when result is STRIKE_DESTROYED.
+    */
+    void GameStats::recordShot(int player, int xCord, int yCord, GameBoard::StrikeResult result, Vessel::VType sunk)
+    {
+        shots_[player]++;
+        if(result == GameBoard::StrikeResult::STRIKE_HIT || result == GameBoard::StrikeResult::STRIKE_DESTROYED)
+        {
+            if(!hit_[player])
+            {
+                hit_[player] = true;
+                firstHits_[static_cast<size_t>(xCord) * widthOfBoard_ + yCord]++;
+            }
+            if(result == GameBoard::StrikeResult::STRIKE_DESTROYED)
+                timeToSink_[static_cast<int>(sunk)].add(shots_[player]);
+        }
+    }
+
+    void GameStats::recordMoveLatency(uint64_t nanoseconds)
+    {
+        moveLatency_.add(nanoseconds);
+    }
+
+    /**
+     Finish the current game.
+     @param winner
+        The winning player, 0 or 1, or any other value for a draw.
+    */
+    void GameStats::endGame(int winner)
+    {
+        games_++;
+        if(winner == 0 || winner == 1)
+            shotsToWin_.add(shots_[winner]);
+    }
+
+    /**
+     Add the statistics of another accumulator for the same board size.
+     Neither accumulator should be in the middle of a game.
+    */
+    void GameStats::merge(const GameStats& other)
+    {
+        if(other.lengthOfBoard_ != lengthOfBoard_ || other.widthOfBoard_ != widthOfBoard_)
+        {
+            Error argError("Statistics are for different board sizes.", STAT_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+
+        games_ += other.games_;
+        shotsToWin_.merge(other.shotsToWin_);
+        for(size_t idx = 0; idx < firstHits_.size(); idx++)
+            firstHits_[idx] += other.firstHits_[idx];
+        for(size_t idx = 0; idx < timeToSink_.size(); idx++)
+            timeToSink_[idx].merge(other.timeToSink_[idx]);
+        moveLatency_.merge(other.moveLatency_);
+    }
+
+    uint64_t GameStats::games() const
+    {
+        return games_;
+    }
+
+    const Histogram& GameStats::shotsToWin() const
+    {
+        return shotsToWin_;
+    }
+
+    const Histogram& GameStats::timeToSink(Vessel::VType vtype) const
+    {
+        return timeToSink_[static_cast<int>(vtype)];
+    }
+
+    const LatencyHistogram& GameStats::moveLatency() const
+    {
+        return moveLatency_;
+    }
+
+    uint64_t GameStats::firstHits(int xCord, int yCord) const
+    {
+        return firstHits_[static_cast<size_t>(xCord) * widthOfBoard_ + yCord];
+    }
+
+    /**
+     Write a readable summary: shots to win, time to sink by vessel type, move latency quantiles
+     and the first hit heatmap as per mille of games.
+    */
+    std::ostream& operator<<(std::ostream& os, const GameStats& stats)
+    {
+        std::ios_base::fmtflags flags = os.flags();
+        os<<std::fixed<<std::setprecision(1);
+
+        const Histogram& win = stats.shotsToWin_;
+        os<<"games "<<stats.games_<<"\n"
+          <<"shots to win: mean "<<win.mean()<<"  p10 "<<win.quantile(0.1)<<"  p50 "<<win.quantile(0.5)
+          <<"  p90 "<<win.quantile(0.9)<<"  p99 "<<win.quantile(0.99)<<"\n";
+
+        os<<"time to sink (attacker shots):\n";
+        for(int type = 0; type < STAT_VESSEL_TYPES; type++)
+        {
+            const Histogram& sink = stats.timeToSink_[type];
+            if(sink.count() == 0)
+                continue;
+            os<<"  "<<std::left<<std::setw(10)<<Vessel::formatVessel(static_cast<Vessel::VType>(type), true)<<std::right
+              <<"mean "<<sink.mean()<<"  p50 "<<sink.quantile(0.5)<<"  p90 "<<sink.quantile(0.9)<<"\n";
+        }
+
+        const LatencyHistogram& lat = stats.moveLatency_;
+        os<<"move latency (ns): mean "<<lat.mean()<<"  p50 "<<lat.quantile(0.5)<<"  p99 "<<lat.quantile(0.99)
+          <<"  p99.9 "<<lat.quantile(0.999)<<"  max "<<lat.max()<<"\n";
+
+        os<<"first hit heatmap (per mille of player games):\n";
+        uint64_t firstTotal = 0;
+        for(uint64_t count : stats.firstHits_)
+            firstTotal += count;
+        for(int x = 0; x < stats.lengthOfBoard_; x++)
+        {
+            for(int y = 0; y < stats.widthOfBoard_; y++)
+            {
+                uint64_t count = stats.firstHits(x, y);
+                os<<std::setw(5)<<static_cast<int>(firstTotal > 0 ? (1000.0 * count) / firstTotal : 0.0);
+            }
+            os<<"\n";
+        }
+
+        os.flags(flags);
+        return os;
+    }
+}
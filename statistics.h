@@ -0,0 +1,113 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "gameboard.h"
+
+#define STAT_SUB_BITS 5
+#define STAT_SUB_BUCKETS (1 << STAT_SUB_BITS)
+#define STAT_VESSEL_TYPES 6
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     A histogram of small non-negative integers with one bin per value up to a fixed maximum
+     and a single overflow bin above it.
+    */
+    class Histogram
+    {
+    public:
+        Histogram(int maxValue = 0);
+
+        void add(int value, uint64_t count = 1);
+        void merge(const Histogram& other);
+
+        uint64_t count() const;
+        double mean() const;
+        int quantile(double q) const;
+        int maxValue() const;
+        uint64_t bin(int value) const;
+        uint64_t overflow() const;
+
+    private:
+        std::vector<uint64_t> bins_;    /**< One bin per value in [0, maxValue] followed by the overflow bin */
+        uint64_t count_;
+        uint64_t sum_;
+    };
+
+    /**
+     A log-linear histogram for latencies in the style of HDR histograms.
+     Every power of two range is split into STAT_SUB_BUCKETS equal buckets, so any recorded value
+     is represented to within 1/STAT_SUB_BUCKETS of its magnitude. Storage is fixed at construction.
+    */
+    class LatencyHistogram
+    {
+    public:
+        LatencyHistogram();
+
+        void add(uint64_t value);
+        void merge(const LatencyHistogram& other);
+
+        uint64_t count() const;
+        uint64_t min() const;
+        uint64_t max() const;
+        double mean() const;
+        uint64_t quantile(double q) const;
+
+    private:
+        static int bucketIndex(uint64_t value);
+        static uint64_t bucketUpper(int index);
+
+    private:
+        std::vector<uint64_t> buckets_;
+        uint64_t count_;
+        uint64_t min_;
+        uint64_t max_;
+        double sum_;
+    };
+
+    /**
+     Mergeable statistics for a stream of games. Memory depends only on the board size, never on the
+     number of games, so one accumulator per thread can be merged cheaply at the end of a run.
+    */
+    class GameStats
+    {
+    public:
+        GameStats(int length = GB_BOARD_SIZE, int width = GB_BOARD_SIZE);
+
+        void beginGame();
+        void recordShot(int player, int xCord, int yCord, GameBoard::StrikeResult result, Vessel::VType sunk);
+        void recordMoveLatency(uint64_t nanoseconds);
+        void endGame(int winner);
+        void merge(const GameStats& other);
+
+        uint64_t games() const;
+        const Histogram& shotsToWin() const;
+        const Histogram& timeToSink(Vessel::VType vtype) const;
+        const LatencyHistogram& moveLatency() const;
+        uint64_t firstHits(int xCord, int yCord) const;
+
+        friend std::ostream& operator<<(std::ostream& os, const GameStats& stats);
+
+    private:
+        int lengthOfBoard_;
+        int widthOfBoard_;
+        uint64_t games_;
+        Histogram shotsToWin_;                  /**< Shots fired by the winner */
+        std::vector<uint64_t> firstHits_;       /**< Cell of each player's first hit in a game */
+        std::vector<Histogram> timeToSink_;     /**< Attacker's shot number when a vessel sank, by VType */
+        LatencyHistogram moveLatency_;          /**< Nanoseconds to choose and resolve a shot */
+
+        /* Per game state */
+        int shots_[2];
+        bool hit_[2];
+    };
+}
+
+#endif
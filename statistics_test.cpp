@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+#include "error.h"
+#include "simulation.h"
+#include "statistics.h"
+
+TEST_CASE ("Testing Statistics", "[Statistics]")
+{
+    SECTION("Histogram quantiles and merging")
+    {
+        std::cout<<"Testing histograms"<<std::endl;
+        Cylink::Histogram low(100), high(100);
+        for(int value = 1; value <= 50; value++)
+            low.add(value);
+        for(int value = 51; value <= 100; value++)
+            high.add(value);
+        high.add(500);
+
+        low.merge(high);
+        CHECK(low.count() == 101);
+        CHECK(low.quantile(0.5) == 51);
+        CHECK(low.quantile(0.0) == 1);
+        CHECK(low.quantile(1.0) == 101);
+        CHECK(low.overflow() == 1);
+
+        Cylink::Histogram other(10);
+        CHECK_THROWS_AS(low.merge(other), Cylink::Error);
+    }
+
+    SECTION("Latency quantiles stay within the bucket resolution")
+    {
+        std::cout<<"Testing latency histograms"<<std::endl;
+        Cylink::LatencyHistogram first, second;
+        for(uint64_t value = 1; value <= 100000; value++)
+            (value % 2 ? first : second).add(value * 10);
+        first.merge(second);
+
+        CHECK(first.count() == 100000);
+        CHECK(first.min() == 10);
+        CHECK(first.max() == 1000000);
+        for(double q : {0.5, 0.9, 0.99, 0.999})
+        {
+            double exact = q * 1000000;
+            double estimate = static_cast<double>(first.quantile(q));
+            CHECK(estimate >= exact);
+            CHECK(estimate <= exact * (1.0 + 1.0 / STAT_SUB_BUCKETS));
+        }
+        CHECK(first.quantile(1.0) == 1000000);
+    }
+
+    SECTION("Per-thread statistics merge to the single thread result")
+    {
+        std::cout<<"Testing merged game statistics"<<std::endl;
+        Cylink::SimulationConfig config;
+        config.games = 200;
+        config.seed = 99;
+        std::ostringstream out;
+
+        Cylink::GameStats single(config.length, config.width);
+        Cylink::runSimulation(config, out, &single);
+
+        config.threads = 4;
+        Cylink::GameStats merged(config.length, config.width);
+        Cylink::runSimulation(config, out, &merged);
+
+        REQUIRE(single.games() == 200);
+        CHECK(merged.games() == single.games());
+        CHECK(merged.shotsToWin().count() == single.shotsToWin().count());
+        CHECK(merged.shotsToWin().mean() == single.shotsToWin().mean());
+        CHECK(merged.shotsToWin().quantile(0.9) == single.shotsToWin().quantile(0.9));
+
+        /* The default fleet has one carrier, so every won game sinks the loser's carrier */
+        CHECK(single.timeToSink(Cylink::Vessel::VType::CARRIER).count() >= single.shotsToWin().count());
+
+        uint64_t firstHits = 0;
+        for(int x = 0; x < config.length; x++)
+        {
+            for(int y = 0; y < config.width; y++)
+            {
+                CHECK(merged.firstHits(x, y) == single.firstHits(x, y));
+                firstHits += single.firstHits(x, y);
+            }
+        }
+        CHECK(firstHits == 400);
+        CHECK(single.moveLatency().count() == merged.moveLatency().count());
+
+        Cylink::GameStats otherSize(5, 5);
+        CHECK_THROWS_AS(single.merge(otherSize), Cylink::Error);
+    }
+}
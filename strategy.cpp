@@ -0,0 +1,612 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "strategy.h"
+#include "error.h"
+
+#define ST_ARG_ERROR ErrorCode::ERR_INVALID_ARG
+#define ST_WORD_BITS 64
+
+namespace Cylink
+{
+    /**
+     Build the fleet vector with one vessel of every type, the fleet assumed until setFleet() is called.
+    */
+    static std::vector<Vessel::VType> everyVesselType()
+    {
+        std::vector<Vessel::VType> fleet;
+        for(int idx = 0; idx < ST_VESSEL_TYPES; idx++)
+            fleet.push_back(static_cast<Vessel::VType>(idx));
+        return fleet;
+    }
+
+    /**
+     Release any resources held by the strategy.
+    */
+    Strategy::~Strategy()
+    {
+    }
+
+    void Strategy::recordResult(int xCord, int yCord, GameBoard::StrikeResult result)
+    {
+    }
+
+    void Strategy::recordSunk(Vessel::VType vtype)
+    {
+    }
+
+    void Strategy::setFleet(const std::vector<Vessel::VType>& fleet)
+    {
+    }
+
+    std::vector<StrategyParameter> Strategy::parameters() const
+    {
+        return {};
+    }
+
+    void Strategy::setParameters(const std::vector<double>& values)
+    {
+        if(!values.empty())
+        {
+            Error argError("The " + name() + " strategy has no parameters.", ST_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+    }
+
+    bool Strategy::isAsync() const
+    {
+        return false;
+    }
+
+    void Strategy::requestFirePosition(const GameBoard& board, FireRequest& request)
+    {
+        std::pair<int, int> position = suggestFirePosition(board);
+        request.complete(position.first, position.second);
+    }
+
+    /**
+     Create a strategy by name. The names are those returned by available().
+     An unknown name will result in an exception.
+     @param name
+        The name of the strategy.
+     @param length
+        The length of the opponent's board.
+     @param width
+        The width of the opponent's board.
+     @param seed
+        Seed for any randomness the strategy uses.
+     @return
+        The new strategy.
+    */
+    std::unique_ptr<Strategy> Strategy::create(const std::string& name, int length, int width, uint64_t seed)
+    {
+        if(name == "random")
+            return std::unique_ptr<Strategy>(new RandomStrategy(length, width, seed));
+        if(name == "scan")
+            return std::unique_ptr<Strategy>(new ScanStrategy(length, width));
+        if(name == "parity")
+            return std::unique_ptr<Strategy>(new ParityStrategy(length, width, seed));
+        if(name == "density")
+            return std::unique_ptr<Strategy>(new DensityStrategy(length, width, seed));
+
+        Error argError("Unknown strategy " + name + ".", ST_ARG_ERROR, __FILE__, __LINE__);
+        throw argError;
+    }
+
+    /**
+     @return
+        The names of all strategies that create() accepts.
+    */
+    std::vector<std::string> Strategy::available()
+    {
+        return {"random", "scan", "parity", "density"};
+    }
+
+    /**
+     Create a random strategy for a board of the given size.
+    */
+    RandomStrategy::RandomStrategy(int length, int width, uint64_t seed)
+        : widthOfBoard_(width), remaining_(static_cast<size_t>(length) * width), count_(0), engine_(seed)
+    {
+        reset(seed);
+    }
+
+    /**
+     Pick a cell that hasn't been fired at by swapping it out of the live part of the remaining list.
+     Once every cell has been fired at the last cell is repeated.
+    */
+    std::pair<int, int> RandomStrategy::suggestFirePosition(const GameBoard& board)
+    {
+        int cell = remaining_.empty() ? 0 : remaining_[0];
+        if(count_ > 0)
+        {
+            size_t idx = engine_.below(count_);
+            cell = remaining_[idx];
+            std::swap(remaining_[idx], remaining_[--count_]);
+        }
+        return std::make_pair(cell / widthOfBoard_, cell % widthOfBoard_);
+    }
+
+    void RandomStrategy::reset(uint64_t seed)
+    {
+        std::iota(remaining_.begin(), remaining_.end(), 0);
+        count_ = remaining_.size();
+        engine_.seed(seed);
+    }
+
+    std::unique_ptr<Strategy> RandomStrategy::clone() const
+    {
+        return std::unique_ptr<Strategy>(new RandomStrategy(*this));
+    }
+
+    std::string RandomStrategy::name() const
+    {
+        return "random";
+    }
+
+    /**
+     Create a scanning strategy for a board of the given size.
+    */
+    ScanStrategy::ScanStrategy(int length, int width)
+        : lengthOfBoard_(length), widthOfBoard_(width), next_(0)
+    {
+    }
+
+    std::pair<int, int> ScanStrategy::suggestFirePosition(const GameBoard& board)
+    {
+        int cell = next_;
+        if(next_ + 1 < lengthOfBoard_ * widthOfBoard_)
+            next_++;
+        return std::make_pair(cell / widthOfBoard_, cell % widthOfBoard_);
+    }
+
+    void ScanStrategy::reset(uint64_t seed)
+    {
+        next_ = 0;
+    }
+
+    std::unique_ptr<Strategy> ScanStrategy::clone() const
+    {
+        return std::unique_ptr<Strategy>(new ScanStrategy(*this));
+    }
+
+    std::string ScanStrategy::name() const
+    {
+        return "scan";
+    }
+
+    /**
+     Create a parity strategy for a board of the given size and build its lattice masks.
+     Until setFleet() is called every vessel type is assumed afloat, so the lattice starts with spacing 1.
+    */
+    ParityStrategy::ParityStrategy(int length, int width, uint64_t seed)
+        : lengthOfBoard_(length), widthOfBoard_(width), cells_(CellTables::forBoard(length, width)), masks_(ST_MAX_SPACING * ST_MAX_SPACING), inner_(length, width),
+          fired_(length, width), hit_(length, width), fleet_(ST_VESSEL_TYPES, 1), afloat_(ST_VESSEL_TYPES, 1), hits_(),
+          unresolved_(0), spacing_(1), phaseSeed_(0), spacingScale_(1.0), innerBias_(0.0), lineBias_(0.0), engine_(seed)
+    {
+        if(length > 2 && width > 2)
+            inner_.setRect(1, 1, length - 1, width - 1);
+        for(int spacing = 1; spacing <= ST_MAX_SPACING; spacing++)
+        {
+            for(int phase = 0; phase < spacing; phase++)
+            {
+                BitBoard& mask = masks_[(spacing - 1) * ST_MAX_SPACING + phase];
+                mask = BitBoard(length, width);
+                for(int x = 0; x < length; x++)
+                {
+                    for(int y = (phase - x % spacing + spacing) % spacing; y < width; y += spacing)
+                        mask.set(x, y);
+                }
+            }
+        }
+        hits_.reserve(static_cast<size_t>(length) * width);
+        reset(seed);
+    }
+
+    /**
+     Fire next to an unresolved hit if there is one, otherwise at a random open cell of the current lattice.
+     Once the lattice is exhausted, eg. because the fleet wasn't given, any open cell is a candidate.
+    */
+    std::pair<int, int> ParityStrategy::suggestFirePosition(const GameBoard& board)
+    {
+        int cell = 0;
+        if(!nextTarget(cell))
+        {
+            const BitBoard& lattice = masks_[(spacing_ - 1) * ST_MAX_SPACING + phaseSeed_ % spacing_];
+            cell = -1;
+            if(innerBias_ > 0.0 && engine_.unit() < innerBias_)
+                cell = huntCell(lattice, &inner_);
+            if(cell < 0)
+                cell = huntCell(lattice, nullptr);
+            if(cell < 0)
+                cell = huntCell(masks_[0], nullptr);
+            if(cell < 0)
+                cell = 0;
+        }
+        return std::make_pair(cell / widthOfBoard_, cell % widthOfBoard_);
+    }
+
+    /**
+     Find an open cell next to the most recent unresolved hit. Hits without open neighbors are dropped.
+     @param cell
+        Set to the board index of the target.
+     @return
+        True if there is a target.
+    */
+    bool ParityStrategy::nextTarget(int& cell)
+    {
+        if(unresolved_ > 0 && !hits_.empty() && lineBias_ > 0.0
+            && engine_.unit() < lineBias_ && lineTarget(hits_.back(), cell))
+            return true;
+
+        while(unresolved_ > 0 && !hits_.empty())
+        {
+            int hit = hits_.back();
+            const int* around = cells_->neighbors(hit);
+            for(int idx = 0, count = cells_->neighborCount(hit); idx < count; idx++)
+            {
+                if(!fired_.test(around[idx] / widthOfBoard_, around[idx] % widthOfBoard_))
+                {
+                    cell = around[idx];
+                    return true;
+                }
+            }
+            hits_.pop_back();
+        }
+        return false;
+    }
+
+    /**
+     Find the open cell continuing a line of hits through the given hit, on either end. If the line is blocked
+     on both ends while a 2-wide vessel is afloat, an open cell beside the hit is taken instead, as the line may
+     be one row of such a vessel.
+     @return
+        True if there is such a cell.
+    */
+    bool ParityStrategy::lineTarget(int hit, int& cell)
+    {
+        int beside = -1;
+        for(int dir = 0; dir < CT_DIRECTIONS; dir++)
+        {
+            int back = dir ^ 1;
+            int behind = hit + cells_->step(back);
+            if(cells_->reach(hit, back) == 0 || !hit_.test(behind / widthOfBoard_, behind % widthOfBoard_))
+                continue;
+            /* Walk along the line of hits to the first cell that isn't one */
+            int step = cells_->step(dir);
+            int next = hit + step;
+            int left = cells_->reach(hit, dir);
+            while(left > 0 && hit_.test(next / widthOfBoard_, next % widthOfBoard_))
+            {
+                next += step;
+                left--;
+            }
+            if(left > 0 && !fired_.test(next / widthOfBoard_, next % widthOfBoard_))
+            {
+                cell = next;
+                return true;
+            }
+            const int* sides = cells_->sides(hit, dir);
+            for(int idx = 0, count = cells_->sideCount(hit, dir); beside < 0 && idx < count; idx++)
+            {
+                if(!fired_.test(sides[idx] / widthOfBoard_, sides[idx] % widthOfBoard_))
+                    beside = sides[idx];
+            }
+        }
+        if(beside < 0)
+            return false;
+        for(int idx = 0; idx < ST_VESSEL_TYPES; idx++)
+        {
+            if(afloat_[idx] > 0 && Vessel::vesselDimensions(static_cast<Vessel::VType>(idx)).second > 1)
+            {
+                cell = beside;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     Pick a uniformly random open cell of a lattice mask: AND away the fired cells word by word,
+     pick the r-th candidate by popcounts and clear the lower set bits of its word.
+     @param filter
+        If not null, only cells also set in the filter are candidates.
+     @return
+        The board index of the cell, or -1 if no cell of the mask is open.
+    */
+    int ParityStrategy::huntCell(const BitBoard& mask, const BitBoard* filter)
+    {
+        int words = fired_.wordsPerRow();
+        int total = 0;
+        for(int x = 0; x < lengthOfBoard_; x++)
+        {
+            for(int idx = 0; idx < words; idx++)
+            {
+                uint64_t word = mask.row(x)[idx] & ~fired_.row(x)[idx];
+                total += __builtin_popcountll(filter ? word & filter->row(x)[idx] : word);
+            }
+        }
+        if(total == 0)
+            return -1;
+
+        int rank = static_cast<int>(engine_.below(total));
+        for(int x = 0; x < lengthOfBoard_; x++)
+        {
+            for(int idx = 0; idx < words; idx++)
+            {
+                uint64_t word = mask.row(x)[idx] & ~fired_.row(x)[idx];
+                if(filter)
+                    word &= filter->row(x)[idx];
+                int bits = __builtin_popcountll(word);
+                if(rank < bits)
+                {
+                    for(; rank > 0; rank--)
+                        word &= word - 1;
+                    return x * widthOfBoard_ + idx * ST_WORD_BITS + __builtin_ctzll(word);
+                }
+                rank -= bits;
+            }
+        }
+        return -1;
+    }
+
+    void ParityStrategy::recordResult(int xCord, int yCord, GameBoard::StrikeResult result)
+    {
+        if(xCord < 0 || xCord >= lengthOfBoard_ || yCord < 0 || yCord >= widthOfBoard_ || fired_.test(xCord, yCord))
+            return;
+        fired_.set(xCord, yCord);
+        if(result == GameBoard::StrikeResult::STRIKE_HIT || result == GameBoard::StrikeResult::STRIKE_DESTROYED)
+        {
+            hit_.set(xCord, yCord);
+            hits_.push_back(xCord * widthOfBoard_ + yCord);
+            unresolved_++;
+        }
+    }
+
+    /**
+     A sunk vessel accounts for as many hit cells as it covers, and once the last vessel of a class is gone
+     the lattice spacing is recomputed.
+    */
+    void ParityStrategy::recordSunk(Vessel::VType vtype)
+    {
+        std::pair<int, int> dims = Vessel::vesselDimensions(vtype);
+        unresolved_ = std::max(0, unresolved_ - dims.first * dims.second);
+        int& afloat = afloat_[static_cast<size_t>(vtype)];
+        if(afloat > 0 && --afloat == 0)
+            updateSpacing();
+    }
+
+    /**
+     Count the vessels of each type in the opponent's fleet. Takes effect from the next reset().
+    */
+    void ParityStrategy::setFleet(const std::vector<Vessel::VType>& fleet)
+    {
+        std::fill(fleet_.begin(), fleet_.end(), 0);
+        for(Vessel::VType vtype : fleet)
+            fleet_[static_cast<size_t>(vtype)]++;
+    }
+
+    std::vector<StrategyParameter> ParityStrategy::parameters() const
+    {
+        return {{"spacing_scale", spacingScale_, 0.5, 2.0},
+                {"inner_bias", innerBias_, 0.0, 1.0},
+                {"line_bias", lineBias_, 0.0, 1.0}};
+    }
+
+    void ParityStrategy::setParameters(const std::vector<double>& values)
+    {
+        std::vector<StrategyParameter> current = parameters();
+        if(values.size() != current.size())
+        {
+            Error argError("The parity strategy takes " + std::to_string(current.size()) + " parameters.", ST_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        spacingScale_ = std::clamp(values[0], current[0].low, current[0].high);
+        innerBias_ = std::clamp(values[1], current[1].low, current[1].high);
+        lineBias_ = std::clamp(values[2], current[2].low, current[2].high);
+        updateSpacing();
+    }
+
+    /**
+     Use the length of the smallest vessel class still afloat, scaled by spacing_scale, as the lattice spacing.
+    */
+    void ParityStrategy::updateSpacing()
+    {
+        int spacing = 0;
+        for(int idx = 0; idx < ST_VESSEL_TYPES; idx++)
+        {
+            int length = Vessel::vesselDimensions(static_cast<Vessel::VType>(idx)).first;
+            if(afloat_[idx] > 0 && (spacing == 0 || length < spacing))
+                spacing = length;
+        }
+        /* Keep the last lattice once the whole fleet is sunk */
+        if(spacing > 0)
+            spacing_ = std::clamp(static_cast<int>(std::lround(spacing * spacingScale_)), 1, ST_MAX_SPACING);
+    }
+
+    void ParityStrategy::reset(uint64_t seed)
+    {
+        fired_.clear();
+        hit_.clear();
+        hits_.clear();
+        unresolved_ = 0;
+        afloat_ = fleet_;
+        updateSpacing();
+        engine_.seed(seed);
+        phaseSeed_ = engine_();
+    }
+
+    std::unique_ptr<Strategy> ParityStrategy::clone() const
+    {
+        return std::unique_ptr<Strategy>(new ParityStrategy(*this));
+    }
+
+    std::string ParityStrategy::name() const
+    {
+        return "parity";
+    }
+
+    /**
+     @return
+        The spacing of the lattice currently hunted on.
+    */
+    int ParityStrategy::spacing() const
+    {
+        return spacing_;
+    }
+
+    /**
+     Create a density strategy for a board of the given size.
+     Until setFleet() is called the opponent is assumed to have one vessel of every type.
+    */
+    DensityStrategy::DensityStrategy(int length, int width, uint64_t seed)
+        : lengthOfBoard_(length), widthOfBoard_(width), cells_(CellTables::forBoard(length, width)), map_(everyVesselType(), length, width), fired_(length, width),
+          hits_(), unresolved_(0), engine_(seed)
+    {
+        hits_.reserve(static_cast<size_t>(length) * width);
+        reset(seed);
+    }
+
+    /**
+     Fire at the hottest open neighbor of an unresolved hit if there is one, otherwise at the hottest open cell.
+    */
+    std::pair<int, int> DensityStrategy::suggestFirePosition(const GameBoard& board)
+    {
+        int cell = targetCell();
+        if(cell < 0)
+            cell = huntCell();
+        if(cell < 0)
+            cell = 0;
+        return std::make_pair(cell / widthOfBoard_, cell % widthOfBoard_);
+    }
+
+    /**
+     @return
+        The hottest open neighbor of any unresolved hit, or -1 if there is none. Hits without open
+        neighbors are dropped.
+    */
+    int DensityStrategy::targetCell()
+    {
+        int best = -1, bestHeat = -1, ties = 0;
+        for(size_t idx = 0; unresolved_ > 0 && idx < hits_.size(); )
+        {
+            const int* around = cells_->neighbors(hits_[idx]);
+            bool open = false;
+            for(int near = 0, count = cells_->neighborCount(hits_[idx]); near < count; near++)
+            {
+                if(!fired_.test(around[near] / widthOfBoard_, around[near] % widthOfBoard_))
+                {
+                    open = true;
+                    consider(around[near], best, bestHeat, ties);
+                }
+            }
+            if(open)
+                idx++;
+            else
+            {
+                hits_[idx] = hits_.back();
+                hits_.pop_back();
+            }
+        }
+        return best;
+    }
+
+    /**
+     @return
+        The hottest open cell, or -1 if every cell was fired at.
+    */
+    int DensityStrategy::huntCell()
+    {
+        int best = -1, bestHeat = -1, ties = 0;
+        for(int x = 0; x < lengthOfBoard_; x++)
+        {
+            for(int y = 0; y < widthOfBoard_; y++)
+            {
+                if(!fired_.test(x, y))
+                    consider(x * widthOfBoard_ + y, best, bestHeat, ties);
+            }
+        }
+        return best;
+    }
+
+    /**
+     Keep the cell if it is hotter than the best so far, or with equal heat by reservoir sampling, so that
+     every cell of the highest heat is equally likely to be kept.
+    */
+    void DensityStrategy::consider(int cell, int& best, int& bestHeat, int& ties)
+    {
+        int heat = map_.heatMap()[cell];
+        if(heat > bestHeat)
+        {
+            best = cell;
+            bestHeat = heat;
+            ties = 1;
+        }
+        else if(heat == bestHeat && engine_.below(++ties) == 0)
+            best = cell;
+    }
+
+    void DensityStrategy::recordResult(int xCord, int yCord, GameBoard::StrikeResult result)
+    {
+        if(xCord < 0 || xCord >= lengthOfBoard_ || yCord < 0 || yCord >= widthOfBoard_ || fired_.test(xCord, yCord))
+            return;
+        fired_.set(xCord, yCord);
+        /* The strategy feeds its own map, so wrappers and remote clients that only forward results keep it current */
+        map_.onLaunched(xCord, yCord, result);
+        if(result == GameBoard::StrikeResult::STRIKE_HIT || result == GameBoard::StrikeResult::STRIKE_DESTROYED)
+        {
+            hits_.push_back(xCord * widthOfBoard_ + yCord);
+            unresolved_++;
+        }
+    }
+
+    /**
+     A sunk vessel accounts for as many hit cells as it covers and no longer adds to the heat of any cell.
+    */
+    void DensityStrategy::recordSunk(Vessel::VType vtype)
+    {
+        std::pair<int, int> dims = Vessel::vesselDimensions(vtype);
+        unresolved_ = std::max(0, unresolved_ - dims.first * dims.second);
+        map_.onSunk(vtype);
+    }
+
+    /**
+     Enumerate the placements of the opponent's fleet. The game in progress, if any, is forgotten.
+    */
+    void DensityStrategy::setFleet(const std::vector<Vessel::VType>& fleet)
+    {
+        map_ = ProbabilityMap(fleet, lengthOfBoard_, widthOfBoard_);
+        fired_.clear();
+        hits_.clear();
+        unresolved_ = 0;
+    }
+
+    void DensityStrategy::reset(uint64_t seed)
+    {
+        fired_.clear();
+        hits_.clear();
+        unresolved_ = 0;
+        map_.reset();
+        engine_.seed(seed);
+    }
+
+    std::unique_ptr<Strategy> DensityStrategy::clone() const
+    {
+        return std::unique_ptr<Strategy>(new DensityStrategy(*this));
+    }
+
+    std::string DensityStrategy::name() const
+    {
+        return "density";
+    }
+
+    /**
+     @return
+        The heatmap the strategy fires by.
+    */
+    const ProbabilityMap& DensityStrategy::map() const
+    {
+        return map_;
+    }
+}
@@ -0,0 +1,249 @@
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "bitboard.h"
+#include "celltables.h"
+#include "gameboard.h"
+#include "probabilitymap.h"
+#include "random.h"
+#include "scheduler.h"
+
+#define ST_MAX_SPACING 8
+#define ST_VESSEL_TYPES 6
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     @struct StrategyParameter
+     A tunable setting of a strategy and the range it may be tuned over.
+    */
+    struct StrategyParameter
+    {
+        std::string name;
+        double value;
+        double low;
+        double high;
+    };
+
+    /**
+     Base class for the targeting strategies that choose where a Player fires next.
+     A strategy is told the result of every shot it suggested so it can track the opponent's board.
+     Strategies are cache line aligned: each game's strategy updates its random stream and targeting state on
+     every shot, and must not share a line with another game's.
+    */
+    class alignas(64) Strategy
+    {
+    public:
+        virtual ~Strategy();
+
+        /**
+         Choose the next position to fire at.
+         @param board
+            The player's own game board, which records the attacks already launched.
+         @return
+            The (x, y) coordinates to fire at.
+        */
+        virtual std::pair<int, int> suggestFirePosition(const GameBoard& board) = 0;
+
+        /**
+         Record the outcome of a shot. The default implementation ignores it.
+        */
+        virtual void recordResult(int xCord, int yCord, GameBoard::StrikeResult result);
+
+        /**
+         Record the type of a vessel the last shot destroyed, as announced to the attacker after recordResult().
+         The default implementation ignores it.
+        */
+        virtual void recordSunk(Vessel::VType vtype);
+
+        /**
+         Tell the strategy which fleet the opponent plays. Called before the first game, the default
+         implementation ignores it.
+        */
+        virtual void setFleet(const std::vector<Vessel::VType>& fleet);
+
+        /**
+         @return
+            The strategy's tunable settings and their current values. The default implementation has none.
+        */
+        virtual std::vector<StrategyParameter> parameters() const;
+
+        /**
+         Change the tunable settings, given in the order parameters() lists them. Values are clamped to their range.
+         The wrong number of values results in an exception.
+        */
+        virtual void setParameters(const std::vector<double>& values);
+
+        /**
+         @return
+            True if the strategy answers through requestFirePosition() rather than suggestFirePosition(), eg. because
+            the decision is made by another process. Games then suspend while waiting instead of blocking a thread.
+        */
+        virtual bool isAsync() const;
+
+        /**
+         Ask for the next position without waiting for it. The answer is given with request.complete(), possibly
+         from another thread. The default implementation completes it at once with suggestFirePosition().
+        */
+        virtual void requestFirePosition(const GameBoard& board, FireRequest& request);
+
+        /**
+         Prepare the strategy for a new game against a board of the same size.
+         @param seed
+            Seed for any randomness the strategy uses.
+        */
+        virtual void reset(uint64_t seed) = 0;
+
+        /**
+         @return
+            A copy of the strategy, including its state.
+        */
+        virtual std::unique_ptr<Strategy> clone() const = 0;
+
+        /**
+         @return
+            The name the strategy is created with by create().
+        */
+        virtual std::string name() const = 0;
+
+        static std::unique_ptr<Strategy> create(const std::string& name, int length, int width, uint64_t seed = 0);
+        static std::vector<std::string> available();
+    };
+
+    /**
+     Fires at a uniformly random position that hasn't been fired at before.
+    */
+    class RandomStrategy : public Strategy
+    {
+    public:
+        RandomStrategy(int length = GB_BOARD_SIZE, int width = GB_BOARD_SIZE, uint64_t seed = 0);
+
+        std::pair<int, int> suggestFirePosition(const GameBoard& board) override;
+        void reset(uint64_t seed) override;
+        std::unique_ptr<Strategy> clone() const override;
+        std::string name() const override;
+
+    private:
+        int widthOfBoard_;
+        std::vector<int> remaining_;    /**< Cells not fired at yet, the first count_ are live */
+        size_t count_;
+        Xoshiro256 engine_;
+    };
+
+    /**
+     Fires at every position in turn, row by row.
+    */
+    class ScanStrategy : public Strategy
+    {
+    public:
+        ScanStrategy(int length = GB_BOARD_SIZE, int width = GB_BOARD_SIZE);
+
+        std::pair<int, int> suggestFirePosition(const GameBoard& board) override;
+        void reset(uint64_t seed) override;
+        std::unique_ptr<Strategy> clone() const override;
+        std::string name() const override;
+
+    private:
+        int lengthOfBoard_;
+        int widthOfBoard_;
+        int next_;                      /**< Index of the next cell to fire at */
+    };
+
+    /**
+     Hunts on a diagonal lattice and finishes off vessels it hit. While hunting only cells with
+     (x + y) % spacing == phase are candidates, where spacing is the length of the smallest vessel still afloat,
+     so every remaining vessel covers at least one candidate. The spacing grows as vessel classes are sunk.
+     Lattice masks for every spacing and phase are built once per board, so a hunting shot is a few word ANDs
+     and popcounts. After a hit the strategy fires next to its unresolved hits until the hit cells are
+     accounted for by sunk vessels, stepping between cells with the shared CellTables of the board size.
+     Tunable: spacing_scale stretches the lattice, inner_bias makes hunting prefer cells off the edge and
+     line_bias makes targeting extend a line of hits before trying other neighbors.
+    */
+    class ParityStrategy : public Strategy
+    {
+    public:
+        ParityStrategy(int length = GB_BOARD_SIZE, int width = GB_BOARD_SIZE, uint64_t seed = 0);
+
+        std::pair<int, int> suggestFirePosition(const GameBoard& board) override;
+        void recordResult(int xCord, int yCord, GameBoard::StrikeResult result) override;
+        void recordSunk(Vessel::VType vtype) override;
+        void setFleet(const std::vector<Vessel::VType>& fleet) override;
+        std::vector<StrategyParameter> parameters() const override;
+        void setParameters(const std::vector<double>& values) override;
+        void reset(uint64_t seed) override;
+        std::unique_ptr<Strategy> clone() const override;
+        std::string name() const override;
+
+        int spacing() const;
+
+    private:
+        bool nextTarget(int& cell);
+        bool lineTarget(int hit, int& cell);
+        int huntCell(const BitBoard& mask, const BitBoard* filter);
+        void updateSpacing();
+
+    private:
+        int lengthOfBoard_;
+        int widthOfBoard_;
+        std::shared_ptr<const CellTables> cells_;
+        std::vector<BitBoard> masks_;   /**< Lattice of spacing s and phase p at (s - 1) * ST_MAX_SPACING + p */
+        BitBoard inner_;                /**< Cells off the edge of the board */
+        BitBoard fired_;                /**< Cells already fired at */
+        BitBoard hit_;                  /**< Cells hit so far */
+        std::vector<int> fleet_;        /**< Vessels of each type in the opponent's fleet */
+        std::vector<int> afloat_;       /**< Vessels of each type not sunk yet */
+        std::vector<int> hits_;         /**< Hit cells that may still have open neighbors */
+        int unresolved_;                /**< Hit cells not accounted for by sunk vessels */
+        int spacing_;
+        uint64_t phaseSeed_;            /**< Picks the lattice phase for each spacing */
+        double spacingScale_;           /**< Lattice spacing relative to the smallest vessel afloat */
+        double innerBias_;              /**< Chance a hunting shot avoids the edge of the board */
+        double lineBias_;               /**< Chance a target shot extends a line of hits first */
+        Xoshiro256 engine_;
+    };
+
+    /**
+     Fires at the open cell covered by the most placements of the vessels still afloat, as counted by a
+     ProbabilityMap kept up to date shot by shot. After a hit the hottest open neighbor of an unresolved
+     hit is fired at until the hit cells are accounted for by sunk vessels. Ties are broken at random.
+    */
+    class DensityStrategy : public Strategy
+    {
+    public:
+        DensityStrategy(int length = GB_BOARD_SIZE, int width = GB_BOARD_SIZE, uint64_t seed = 0);
+
+        std::pair<int, int> suggestFirePosition(const GameBoard& board) override;
+        void recordResult(int xCord, int yCord, GameBoard::StrikeResult result) override;
+        void recordSunk(Vessel::VType vtype) override;
+        void setFleet(const std::vector<Vessel::VType>& fleet) override;
+        void reset(uint64_t seed) override;
+        std::unique_ptr<Strategy> clone() const override;
+        std::string name() const override;
+
+        const ProbabilityMap& map() const;
+
+    private:
+        int targetCell();
+        int huntCell();
+        void consider(int cell, int& best, int& bestHeat, int& ties);
+
+    private:
+        int lengthOfBoard_;
+        int widthOfBoard_;
+        std::shared_ptr<const CellTables> cells_;
+        ProbabilityMap map_;
+        BitBoard fired_;                /**< Cells already fired at */
+        std::vector<int> hits_;         /**< Hit cells that may still have open neighbors */
+        int unresolved_;                /**< Hit cells not accounted for by sunk vessels */
+        Xoshiro256 engine_;
+    };
+}
+
+#endif
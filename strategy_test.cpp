@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+#include <set>
+#include "simulation.h"
+#include "strategy.h"
+
+TEST_CASE ("Testing Strategy", "[Strategy]")
+{
+    SECTION("Parity hunting stays on the lattice of the smallest vessel afloat")
+    {
+        std::cout<<"Testing parity lattices"<<std::endl;
+        Cylink::GameBoard board;
+        Cylink::ParityStrategy strategy(GB_BOARD_SIZE, GB_BOARD_SIZE);
+        strategy.setFleet(Cylink::defaultFleet());
+        strategy.reset(5);
+        REQUIRE(strategy.spacing() == 2);
+
+        /* Every shot of a fleet with cruisers misses, so the hunt covers exactly one checkerboard colour */
+        std::set<std::pair<int, int>> shots;
+        int phase = -1;
+        for(int shot = 0; shot < GB_BOARD_SIZE * GB_BOARD_SIZE / 2; shot++)
+        {
+            std::pair<int, int> position = strategy.suggestFirePosition(board);
+            if(phase < 0)
+                phase = (position.first + position.second) % 2;
+            CHECK((position.first + position.second) % 2 == phase);
+            CHECK(shots.insert(position).second);
+            strategy.recordResult(position.first, position.second, Cylink::GameBoard::StrikeResult::STRIKE_MISS);
+        }
+
+        /* Sinking every cruiser moves the hunt to the frigate lattice */
+        strategy.reset(6);
+        for(int idx = 0; idx < 3; idx++)
+            strategy.recordSunk(Cylink::Vessel::VType::CRUISER);
+        CHECK(strategy.spacing() == 3);
+        std::pair<int, int> position = strategy.suggestFirePosition(board);
+        int lattice = (position.first + position.second) % 3;
+        for(int shot = 0; shot < 20; shot++)
+        {
+            strategy.recordResult(position.first, position.second, Cylink::GameBoard::StrikeResult::STRIKE_MISS);
+            position = strategy.suggestFirePosition(board);
+            CHECK((position.first + position.second) % 3 == lattice);
+        }
+
+        /* Without a fleet every vessel type may be afloat, gunboats included */
+        Cylink::ParityStrategy unknown(GB_BOARD_SIZE, GB_BOARD_SIZE);
+        CHECK(unknown.spacing() == 1);
+    }
+
+    SECTION("Parity targets the neighbors of a hit before hunting again")
+    {
+        std::cout<<"Testing parity targeting"<<std::endl;
+        Cylink::GameBoard board;
+        Cylink::ParityStrategy strategy(GB_BOARD_SIZE, GB_BOARD_SIZE);
+        strategy.setFleet({Cylink::Vessel::VType::FRIGATE});
+        strategy.reset(1);
+
+        strategy.recordResult(4, 4, Cylink::GameBoard::StrikeResult::STRIKE_HIT);
+        std::pair<int, int> next = strategy.suggestFirePosition(board);
+        CHECK(std::abs(next.first - 4) + std::abs(next.second - 4) == 1);
+
+        /* Once the hits are accounted for by a sunk vessel the strategy goes back to the lattice */
+        strategy.recordResult(next.first, next.second, Cylink::GameBoard::StrikeResult::STRIKE_HIT);
+        strategy.recordResult(2 * next.first - 4, 2 * next.second - 4, Cylink::GameBoard::StrikeResult::STRIKE_DESTROYED);
+        strategy.recordSunk(Cylink::Vessel::VType::FRIGATE);
+        next = strategy.suggestFirePosition(board);
+        CHECK(std::abs(next.first - 4) + std::abs(next.second - 4) > 2);
+    }
+
+    SECTION("Parity beats random targeting")
+    {
+        std::cout<<"Testing parity games"<<std::endl;
+        Cylink::SimulationConfig config;
+        config.fleet = Cylink::defaultFleet();
+        config.seed = 31;
+        config.strategy[0] = "parity";
+        config.strategy[1] = "random";
+
+        Cylink::GameRunner runner(config);
+        int wins = 0;
+        for(long long game = 0; game < 200; game++)
+        {
+            Cylink::GameResult result = runner.play(game);
+            REQUIRE(result.winner != SIM_DRAW);
+            if(result.winner == SIM_PLAYER1)
+                wins++;
+        }
+        CHECK(wins > 190);
+    }
+}
@@ -0,0 +1,58 @@
+/**
+ * @file strategy_tuner.cpp
+ * Tunes a strategy's parameters by self-play on every core and prints the result as a battleship option.
+ * Progress goes to stderr. With a checkpoint file an interrupted run continues where it stopped.
+ * Usage: strategy_tuner STRATEGY [generations] [population] [threads] [checkpoint] [seed]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include "error.h"
+#include "tuner.h"
+
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char* argv[])
+{
+    if(argc < 2 || argc > 7)
+    {
+        std::cerr<<"Usage: strategy_tuner STRATEGY [generations] [population] [threads] [checkpoint] [seed]\n";
+        return 1;
+    }
+
+    Cylink::TunerConfig config;
+    config.strategy = argv[1];
+    if(argc > 2)
+        config.generations = std::atoi(argv[2]);
+    if(argc > 3)
+        config.population = std::atoi(argv[3]);
+    config.threads = (argc > 4) ? std::atoi(argv[4]) : static_cast<int>(std::thread::hardware_concurrency());
+    if(argc > 5)
+        config.checkpoint = argv[5];
+    if(argc > 6)
+        config.seed = std::strtoull(argv[6], nullptr, 10);
+    config.keep = std::min(config.keep, std::max(1, config.population));
+
+    try
+    {
+        auto start = Clock::now();
+        Cylink::Tuner tuner(config);
+        const Cylink::TunerState& state = tuner.run(&std::cerr);
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        std::cerr<<state.generation<<" generations in "<<elapsed.count()<<"s, best win rate "<<state.bestScore<<"\n";
+        for(size_t idx = 0; idx < state.best.size(); idx++)
+            std::cerr<<"  "<<tuner.parameters()[idx].name<<" = "<<state.best[idx]<<"\n";
+        std::cout<<"--p1-params ";
+        for(size_t idx = 0; idx < state.best.size(); idx++)
+            std::cout<<(idx ? "," : "")<<state.best[idx];
+        std::cout<<"\n";
+    }
+    catch(const Cylink::Error& err)
+    {
+        std::cerr<<err.what()<<"\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,374 @@
+#include <algorithm>
+#include <tuple>
+
+#include "tiledboard.h"
+#include "error.h"
+
+#define TB_ARG_ERROR ErrorCode::ERR_INVALID_ARG
+
+#define TB_TILE_MASK (TB_TILE_SIZE - 1)
+#define TB_MAX_TILES (int64_t(1) << 24)
+
+namespace Cylink
+{
+    /**
+     Build the mask for columns [from, to) of a tile row, 0 <= from < to <= TB_TILE_SIZE.
+    */
+    static inline uint64_t columnMask(int64_t from, int64_t to)
+    {
+        uint64_t bits = (to - from == 64) ? ~uint64_t(0) : ((uint64_t(1) << (to - from)) - 1);
+        return bits << from;
+    }
+
+    /**
+     Create an empty tiled board. No tiles are allocated until vessels are placed or strikes are logged.
+     Non-positive dimensions, or a board needing more than TB_MAX_TILES tiles, will result in an exception.
+     @param length
+        The length of the board, ie. the number of valid x coordinates.
+     @param width
+        The width of the board, ie. the number of valid y coordinates.
+    */
+    TiledBoard::TiledBoard(int64_t length, int64_t width)
+        : lengthOfBoard_(length), widthOfBoard_(width), tilesPerRow_(0), fleet_(), shots_(),
+          fleetTiles_(0), shotTiles_(0), vessels_(), borders_(), directions_(), index_(), activeVessels_(0)
+    {
+        if(lengthOfBoard_ <= 0 || widthOfBoard_ <= 0)
+        {
+            Error argError("Board length and height must be greater than zero.", TB_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+
+        int64_t tileRows = (lengthOfBoard_ + TB_TILE_MASK) >> TB_TILE_SHIFT;
+        tilesPerRow_ = (widthOfBoard_ + TB_TILE_MASK) >> TB_TILE_SHIFT;
+        if(tileRows > TB_MAX_TILES / tilesPerRow_)
+        {
+            Error argError("Board is too large.", TB_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        fleet_.resize(tileRows * tilesPerRow_);
+        shots_.resize(tileRows * tilesPerRow_);
+    }
+
+    /**
+     The tiled board is copy constructible. Allocated tiles are copied, empty ones stay empty.
+    */
+    TiledBoard::TiledBoard(const TiledBoard& other)
+        : lengthOfBoard_(other.lengthOfBoard_), widthOfBoard_(other.widthOfBoard_), tilesPerRow_(other.tilesPerRow_),
+          fleet_(other.fleet_.size()), shots_(other.shots_.size()), fleetTiles_(other.fleetTiles_), shotTiles_(other.shotTiles_),
+          vessels_(other.vessels_), borders_(other.borders_), directions_(other.directions_), index_(other.index_),
+          activeVessels_(other.activeVessels_)
+    {
+        for(size_t idx = 0; idx < fleet_.size(); idx++)
+        {
+            if(other.fleet_[idx])
+                fleet_[idx] = std::make_unique<FleetTile>(*other.fleet_[idx]);
+            if(other.shots_[idx])
+                shots_[idx] = std::make_unique<ShotTile>(*other.shots_[idx]);
+        }
+    }
+
+    /**
+     The tiled board is copy assignable.
+    */
+    TiledBoard& TiledBoard::operator =(const TiledBoard& other)
+    {
+        if(this != &other)
+        {
+            TiledBoard copy(other);
+            std::swap(lengthOfBoard_, copy.lengthOfBoard_);
+            std::swap(widthOfBoard_, copy.widthOfBoard_);
+            std::swap(tilesPerRow_, copy.tilesPerRow_);
+            fleet_.swap(copy.fleet_);
+            shots_.swap(copy.shots_);
+            std::swap(fleetTiles_, copy.fleetTiles_);
+            std::swap(shotTiles_, copy.shotTiles_);
+            vessels_.swap(copy.vessels_);
+            borders_.swap(copy.borders_);
+            directions_.swap(copy.directions_);
+            std::swap(index_, copy.index_);
+            std::swap(activeVessels_, copy.activeVessels_);
+        }
+        return *this;
+    }
+
+    /**
+     Remove all vessels and strike records and release every tile. The board keeps its dimensions.
+    */
+    void TiledBoard::clear()
+    {
+        for(auto& tile : fleet_)
+            tile.reset();
+        for(auto& tile : shots_)
+            tile.reset();
+        fleetTiles_ = shotTiles_ = 0;
+        vessels_.clear();
+        borders_.clear();
+        directions_.clear();
+        index_.clear();
+        activeVessels_ = 0;
+    }
+
+    /**
+     Put a vessel on the board if it fits and doesn't overlap another vessel, as GameBoard::emplaceVessel() does.
+     Only the tiles under the vessel's footprint are read or allocated.
+     Unlike GameBoard an invalid top corner is not an error, the vessel just isn't placed.
+     @param vrect
+        The border of the vessel. Caller must provide (topX, topY), the low corner is filled in.
+     @param vtype
+        The type of vessel being placed on the board.
+     @param vdir
+        The direction to place the vessel on the board.
+     @return
+        True if the vessel was placed.
+    */
+    bool TiledBoard::emplaceVessel(VBorder& vrect, Vessel::VType vtype, GameBoard::VDirection vdir)
+    {
+        if(!isValidTopXY(vrect))
+            return false;
+
+        int vesselLength, vesselWidth;
+        std::tie(vesselLength, vesselWidth) = Vessel::vesselDimensions(vtype);
+        bool horizontal = (vdir == GameBoard::VDirection::HORIZONTAL);
+        vrect.lowX = vrect.topX + (horizontal ? vesselWidth : vesselLength);
+        vrect.lowY = vrect.topY + (horizontal ? vesselLength : vesselWidth);
+        if(vrect.lowX > lengthOfBoard_ || vrect.lowY > widthOfBoard_)
+            return false;
+
+        const int64_t firstTileX = vrect.topX >> TB_TILE_SHIFT, lastTileX = (vrect.lowX - 1) >> TB_TILE_SHIFT;
+        const int64_t firstTileY = vrect.topY >> TB_TILE_SHIFT, lastTileY = (vrect.lowY - 1) >> TB_TILE_SHIFT;
+
+        /* Two passes over the covered tiles: check for overlap, then mark the footprint */
+        for(int pass = 0; pass < 2; pass++)
+        {
+            for(int64_t tileX = firstTileX; tileX <= lastTileX; tileX++)
+            {
+                int64_t rowFrom = std::max(vrect.topX, tileX << TB_TILE_SHIFT) & TB_TILE_MASK;
+                int64_t rowTo = std::min(vrect.lowX - (tileX << TB_TILE_SHIFT), int64_t(TB_TILE_SIZE));
+                for(int64_t tileY = firstTileY; tileY <= lastTileY; tileY++)
+                {
+                    int64_t colFrom = std::max(vrect.topY, tileY << TB_TILE_SHIFT) & TB_TILE_MASK;
+                    int64_t colTo = std::min(vrect.lowY - (tileY << TB_TILE_SHIFT), int64_t(TB_TILE_SIZE));
+                    uint64_t mask = columnMask(colFrom, colTo);
+
+                    std::unique_ptr<FleetTile>& tile = fleet_[tileX * tilesPerRow_ + tileY];
+                    if(pass == 0)
+                    {
+                        if(!tile)
+                            continue;
+                        for(int64_t row = rowFrom; row < rowTo; row++)
+                        {
+                            if(tile->occupied[row] & mask)
+                                return false;
+                        }
+                    }
+                    else
+                    {
+                        if(!tile)
+                        {
+                            tile = std::make_unique<FleetTile>();
+                            fleetTiles_++;
+                        }
+                        for(int64_t row = rowFrom; row < rowTo; row++)
+                            tile->occupied[row] |= mask;
+                    }
+                }
+            }
+        }
+
+        index_.insert(vrect.topX, vrect.topY, vrect.lowX, vrect.lowY, vessels_.size());
+        vessels_.push_back(Vessel(vtype));
+        borders_.push_back(vrect);
+        directions_.push_back(vdir);
+        activeVessels_++;
+        return true;
+    }
+
+    /**
+     Records an attack on the board and returns its result, following GameBoard::logReceivedAttack().
+     Only the tile containing the location is touched.
+     @param vrect
+        Pass the coordinates to be attacked as the (topX, topY) coordinates of the vrect.
+     @return
+        A StrikeResult indicating the results of the attack.
+    */
+    GameBoard::StrikeResult TiledBoard::logReceivedAttack(VBorder& vrect)
+    {
+        if(!isValidTopXY(vrect))
+            return GameBoard::StrikeResult::STRIKE_INVALID;
+
+        std::unique_ptr<FleetTile>& tile = fleet_[tileIndex(vrect.topX, vrect.topY)];
+        if(!tile)
+        {
+            tile = std::make_unique<FleetTile>();
+            fleetTiles_++;
+        }
+
+        const int64_t row = vrect.topX & TB_TILE_MASK;
+        const uint64_t bit = uint64_t(1) << (vrect.topY & TB_TILE_MASK);
+        if(tile->received[row] & bit)
+            return (tile->receivedHit[row] & bit) ? GameBoard::StrikeResult::STRIKE_PREVIOUS : GameBoard::StrikeResult::STRIKE_MISS;
+
+        tile->received[row] |= bit;
+        if(!(tile->occupied[row] & bit))
+            return GameBoard::StrikeResult::STRIKE_MISS;
+
+        tile->receivedHit[row] |= bit;
+
+        if(vessels_[index_.find(vrect.topX, vrect.topY)].takeHit(1) == 0)
+        {
+            activeVessels_--;
+            return GameBoard::StrikeResult::STRIKE_DESTROYED;
+        }
+        return GameBoard::StrikeResult::STRIKE_HIT;
+    }
+
+    /**
+     Records an attack launched against an opponent, following GameBoard::logLaunchedAttack().
+     @param vrect
+        Pass the attacked coordinates as the (topX, topY) coordinates of the vrect.
+     @param sresult
+        The result of the attack.
+    */
+    void TiledBoard::logLaunchedAttack(VBorder& vrect, GameBoard::StrikeResult sresult)
+    {
+        if(!isValidTopXY(vrect))
+            return;
+
+        std::unique_ptr<ShotTile>& tile = shots_[tileIndex(vrect.topX, vrect.topY)];
+        if(!tile)
+        {
+            tile = std::make_unique<ShotTile>();
+            shotTiles_++;
+        }
+
+        const int64_t row = vrect.topX & TB_TILE_MASK;
+        const uint64_t bit = uint64_t(1) << (vrect.topY & TB_TILE_MASK);
+        tile->launched[row] |= bit;
+        if(sresult == GameBoard::StrikeResult::STRIKE_HIT || sresult == GameBoard::StrikeResult::STRIKE_DESTROYED)
+            tile->launchedHit[row] |= bit;
+        else
+            tile->launchedHit[row] &= ~bit;
+    }
+
+    int64_t TiledBoard::getLength() const
+    {
+        return lengthOfBoard_;
+    }
+
+    int64_t TiledBoard::getWidth() const
+    {
+        return widthOfBoard_;
+    }
+
+    /**
+     Obtain the data for a board location in the same form GameBoard::cellAt() stores it.
+     Passing invalid coordinates will result in an exception.
+    */
+    GameBoard::BoardData TiledBoard::cellAt(int64_t x, int64_t y) const
+    {
+        VBorder vrect(x, y);
+        if(!isValidTopXY(vrect))
+        {
+            Error argError("Invalid coordinates supplied.", TB_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+
+        GameBoard::BoardData result;
+        const int64_t index = tileIndex(x, y);
+        const int64_t row = x & TB_TILE_MASK;
+        const uint64_t bit = uint64_t(1) << (y & TB_TILE_MASK);
+
+        if(const FleetTile* tile = fleet_[index].get())
+        {
+            if(tile->occupied[row] & bit)
+            {
+                result.vesselId = index_.find(x, y);
+                result.direction = directions_[result.vesselId];
+            }
+            if(tile->received[row] & bit)
+                result.received = (tile->receivedHit[row] & bit) ? GameBoard::StrikeType::STYPE_HIT : GameBoard::StrikeType::STYPE_FAIL;
+        }
+        if(const ShotTile* tile = shots_[index].get())
+        {
+            if(tile->launched[row] & bit)
+                result.launched = (tile->launchedHit[row] & bit) ? GameBoard::StrikeType::STYPE_HIT : GameBoard::StrikeType::STYPE_FAIL;
+        }
+        return result;
+    }
+
+    /**
+     @return
+        The number of vessels placed on the board. Valid vessel ids are [0, vesselCount()).
+    */
+    int TiledBoard::vesselCount() const
+    {
+        return vessels_.size();
+    }
+
+    /**
+     @return
+        The number of vessels on the board that have not been destroyed.
+    */
+    int TiledBoard::activeVessels() const
+    {
+        return activeVessels_;
+    }
+
+    /**
+     Obtain a vessel on the board by its id. Passing an invalid id will result in an exception.
+    */
+    const Vessel& TiledBoard::getVessel(int vesselId) const
+    {
+        if(vesselId < 0 || vesselId >= static_cast<int>(vessels_.size()))
+        {
+            Error argError("Invalid vessel id supplied.", TB_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        return vessels_[vesselId];
+    }
+
+    /**
+     Obtain the footprint of a vessel by its id. Passing an invalid id will result in an exception.
+    */
+    const TiledBoard::VBorder& TiledBoard::getBorder(int vesselId) const
+    {
+        getVessel(vesselId);
+        return borders_[vesselId];
+    }
+
+    /**
+     @return
+        The number of fleet and shot tiles currently allocated.
+    */
+    int64_t TiledBoard::allocatedTiles() const
+    {
+        return fleetTiles_ + shotTiles_;
+    }
+
+    /**
+     @return
+        An estimate of the heap and object memory used by the board in bytes.
+    */
+    int64_t TiledBoard::memoryUsage() const
+    {
+        int64_t result = sizeof(TiledBoard);
+        result += fleet_.capacity() * sizeof(fleet_[0]) + shots_.capacity() * sizeof(shots_[0]);
+        result += fleetTiles_ * sizeof(FleetTile) + shotTiles_ * sizeof(ShotTile) + index_.memoryUsage();
+        result += vessels_.capacity() * sizeof(Vessel) + borders_.capacity() * sizeof(VBorder)
+            + directions_.capacity() * sizeof(GameBoard::VDirection);
+        return result;
+    }
+
+    bool TiledBoard::isValidTopXY(const VBorder& vrect) const
+    {
+        return 0 <= vrect.topX && vrect.topX < lengthOfBoard_ && 0 <= vrect.topY && vrect.topY < widthOfBoard_;
+    }
+
+    /**
+     Convert valid board coordinates to the index of their tile in the tile directories.
+    */
+    int64_t TiledBoard::tileIndex(int64_t x, int64_t y) const
+    {
+        return (x >> TB_TILE_SHIFT) * tilesPerRow_ + (y >> TB_TILE_SHIFT);
+    }
+}
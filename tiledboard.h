@@ -0,0 +1,112 @@
+#ifndef TILEDBOARD_H
+#define TILEDBOARD_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "gameboard.h"
+#include "vesselindex.h"
+
+#define TB_TILE_SHIFT 6
+#define TB_TILE_SIZE (1 << TB_TILE_SHIFT)
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     A game board for very large, sparsely populated boards.
+     The board is split into TB_TILE_SIZE x TB_TILE_SIZE tiles of bit planes that are only allocated once a vessel
+     or a strike touches them, so empty regions cost a single pointer. Coordinates and indices are 64-bit.
+     Hits are resolved to vessels through a VesselIndex instead of per cell vessel ids.
+     The strike and placement rules are the same as GameBoard's and the StrikeResult, StrikeType and VDirection
+     values are shared with it.
+    */
+    class TiledBoard
+    {
+    public:
+        /**
+         @struct VBorder
+         The enclosing border rectangle for a vessel with 64-bit coordinates.
+         As with GameBoard::VBorder the low corner is exclusive.
+        */
+        struct VBorder
+        {
+            int64_t topX;
+            int64_t topY;
+            int64_t lowX;
+            int64_t lowY;
+
+            VBorder(int64_t tx = -1, int64_t ty = -1, int64_t lx = -1, int64_t ly = -1)
+                : topX(tx), topY(ty), lowX(lx), lowY(ly)
+            {
+            }
+        };
+
+    public:
+        TiledBoard(int64_t length = GB_BOARD_SIZE, int64_t width = GB_BOARD_SIZE);
+        TiledBoard(const TiledBoard& other);
+        TiledBoard& operator =(const TiledBoard& other);
+
+        void clear();
+        bool emplaceVessel(VBorder& vrect, Vessel::VType vtype, GameBoard::VDirection vdir);
+        void logLaunchedAttack(VBorder& vrect, GameBoard::StrikeResult sresult);
+        GameBoard::StrikeResult logReceivedAttack(VBorder& vrect);
+
+        int64_t getLength() const;
+        int64_t getWidth() const;
+        GameBoard::BoardData cellAt(int64_t x, int64_t y) const;
+        int vesselCount() const;
+        int activeVessels() const;
+        const Vessel& getVessel(int vesselId) const;
+        const VBorder& getBorder(int vesselId) const;
+
+        int64_t allocatedTiles() const;
+        int64_t memoryUsage() const;
+
+    private:
+        /**
+         @struct FleetTile
+         Vessel occupancy and received strikes for one tile, one word per tile row.
+         receivedHit keeps whether a strike found a vessel when it landed, since a vessel may later be placed
+         over a miss.
+        */
+        struct FleetTile
+        {
+            uint64_t occupied[TB_TILE_SIZE] = {};
+            uint64_t received[TB_TILE_SIZE] = {};
+            uint64_t receivedHit[TB_TILE_SIZE] = {};
+        };
+
+        /**
+         @struct ShotTile
+         Strikes launched against the opponent for one tile.
+        */
+        struct ShotTile
+        {
+            uint64_t launched[TB_TILE_SIZE] = {};
+            uint64_t launchedHit[TB_TILE_SIZE] = {};
+        };
+
+        bool isValidTopXY(const VBorder& vrect) const;
+        int64_t tileIndex(int64_t x, int64_t y) const;
+
+    private:
+        int64_t lengthOfBoard_;
+        int64_t widthOfBoard_;
+        int64_t tilesPerRow_;                               /**< Number of tiles across the width */
+        std::vector<std::unique_ptr<FleetTile>> fleet_;     /**< Row major tile directory, null until touched */
+        std::vector<std::unique_ptr<ShotTile>> shots_;      /**< Row major tile directory, null until touched */
+        int64_t fleetTiles_;
+        int64_t shotTiles_;
+        std::vector<Vessel> vessels_;
+        std::vector<VBorder> borders_;                      /**< Footprint of each vessel, indexed by id */
+        std::vector<GameBoard::VDirection> directions_;
+        VesselIndex index_;                                 /**< Maps occupied locations to vessel ids */
+        int activeVessels_;
+    };
+}
+
+#endif
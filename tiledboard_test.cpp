@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+#include "error.h"
+#include "gameboard.h"
+#include "tiledboard.h"
+#include "vesselindex.h"
+
+TEST_CASE ("Testing TiledBoard", "[TiledBoard]")
+{
+    SECTION("Strikes match the dense board")
+    {
+        std::cout<<"Testing tiled board against GameBoard"<<std::endl;
+        Cylink::GameBoard dense(10, 10);
+        Cylink::TiledBoard tiled(10, 10);
+
+        const int placements[][3] = {{0, 0, 0}, {2, 3, 1}, {5, 5, 0}, {9, 0, 0}, {0, 8, 1}};
+        const Cylink::Vessel::VType types[] = {Cylink::Vessel::VType::CARRIER, Cylink::Vessel::VType::CRUISER,
+            Cylink::Vessel::VType::DESTROYER, Cylink::Vessel::VType::FRIGATE, Cylink::Vessel::VType::SUBMARINE};
+        for(int idx = 0; idx < 5; idx++)
+        {
+            Cylink::GameBoard::VDirection vdir = placements[idx][2] ? Cylink::GameBoard::VDirection::VERTICAL
+                                                                    : Cylink::GameBoard::VDirection::HORIZONTAL;
+            Cylink::GameBoard::VBorder drect(placements[idx][0], placements[idx][1]);
+            Cylink::TiledBoard::VBorder trect(placements[idx][0], placements[idx][1]);
+            CHECK(dense.emplaceVessel(drect, types[idx], vdir) == tiled.emplaceVessel(trect, types[idx], vdir));
+        }
+        REQUIRE(dense.vesselCount() == tiled.vesselCount());
+
+        for(int pass = 0; pass < 2; pass++)
+        {
+            for(int x = -1; x <= 10; x++)
+            {
+                for(int y = -1; y <= 10; y++)
+                {
+                    Cylink::GameBoard::VBorder drect(x, y);
+                    Cylink::TiledBoard::VBorder trect(x, y);
+                    Cylink::GameBoard::StrikeResult result = dense.logReceivedAttack(drect);
+                    CHECK(result == tiled.logReceivedAttack(trect));
+                    dense.logLaunchedAttack(drect, result);
+                    tiled.logLaunchedAttack(trect, result);
+                }
+            }
+            for(int x = 0; x < 10; x++)
+            {
+                for(int y = 0; y < 10; y++)
+                {
+                    Cylink::GameBoard::BoardData want = dense.cellAt(x, y), got = tiled.cellAt(x, y);
+                    CHECK(want.vesselId == got.vesselId);
+                    CHECK(want.received == got.received);
+                    CHECK(want.launched == got.launched);
+                }
+            }
+        }
+        CHECK(tiled.activeVessels() == 0);
+    }
+
+    SECTION("Giant boards only pay for touched tiles")
+    {
+        std::cout<<"Testing giant tiled board memory"<<std::endl;
+        Cylink::TiledBoard giant(4096, 4096);
+        CHECK(giant.allocatedTiles() == 0);
+
+        int placed = 0;
+        for(int64_t x = 0; x < 4096; x += 64)
+        {
+            for(int64_t y = 60; y < 4096; y += 256)
+            {
+                Cylink::TiledBoard::VBorder vrect(x + 62, y);
+                placed += giant.emplaceVessel(vrect, Cylink::Vessel::VType::CARRIER, Cylink::GameBoard::VDirection::HORIZONTAL);
+            }
+        }
+        CHECK(placed == 1024);
+        CHECK(giant.memoryUsage() < 8 * 1024 * 1024);
+
+        /* A carrier straddling four tiles is found from every corner */
+        Cylink::TiledBoard::VBorder corner(4093, 4091);
+        CHECK(giant.emplaceVessel(corner, Cylink::Vessel::VType::CARRIER, Cylink::GameBoard::VDirection::HORIZONTAL) == false);
+        Cylink::TiledBoard::VBorder hit(62, 63);
+        CHECK(giant.logReceivedAttack(hit) == Cylink::GameBoard::StrikeResult::STRIKE_HIT);
+        CHECK(giant.cellAt(63, 64).vesselId == 0);
+
+        CHECK_THROWS_AS(Cylink::TiledBoard(0, 10), Cylink::Error);
+        CHECK_THROWS_AS(Cylink::GameBoard(65536, 65536), Cylink::Error);
+    }
+
+    SECTION("A vessel placed over a miss keeps the miss")
+    {
+        std::cout<<"Testing placement over a received miss"<<std::endl;
+        Cylink::GameBoard dense(10, 10);
+        Cylink::TiledBoard tiled(10, 10);
+        Cylink::GameBoard::VBorder dshot(2, 1);
+        Cylink::TiledBoard::VBorder tshot(2, 1);
+        CHECK(dense.logReceivedAttack(dshot) == Cylink::GameBoard::StrikeResult::STRIKE_MISS);
+        CHECK(tiled.logReceivedAttack(tshot) == Cylink::GameBoard::StrikeResult::STRIKE_MISS);
+
+        Cylink::GameBoard::VBorder drect(1, 1);
+        Cylink::TiledBoard::VBorder trect(1, 1);
+        CHECK(dense.emplaceVessel(drect, Cylink::Vessel::VType::CRUISER, Cylink::GameBoard::VDirection::VERTICAL));
+        CHECK(tiled.emplaceVessel(trect, Cylink::Vessel::VType::CRUISER, Cylink::GameBoard::VDirection::VERTICAL));
+
+        REQUIRE(dense.cellAt(2, 1).vesselId == 0);
+        CHECK(tiled.cellAt(2, 1).vesselId == 0);
+        CHECK(tiled.cellAt(2, 1).received == dense.cellAt(2, 1).received);
+        CHECK(dense.logReceivedAttack(dshot) == Cylink::GameBoard::StrikeResult::STRIKE_MISS);
+        CHECK(tiled.logReceivedAttack(tshot) == Cylink::GameBoard::StrikeResult::STRIKE_MISS);
+    }
+
+    SECTION("Vessel index lookups")
+    {
+        std::cout<<"Testing vessel index"<<std::endl;
+        Cylink::VesselIndex index;
+        index.insert(0, 10, 2, 17, 0);
+        index.insert(1, 0, 3, 7, 1);
+        index.insert(1, 20, 2, 22, 2);
+
+        CHECK(index.intervals() == 5);
+        CHECK(index.find(0, 9) == GB_NO_VESSEL);
+        CHECK(index.find(0, 10) == 0);
+        CHECK(index.find(1, 16) == 0);
+        CHECK(index.find(1, 17) == GB_NO_VESSEL);
+        CHECK(index.find(1, 6) == 1);
+        CHECK(index.find(2, 0) == 1);
+        CHECK(index.find(1, 21) == 2);
+        CHECK(index.find(3, 0) == GB_NO_VESSEL);
+
+        index.clear();
+        CHECK(index.find(0, 10) == GB_NO_VESSEL);
+    }
+}
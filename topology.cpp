@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sched.h>
+#include <dirent.h>
+
+#include "topology.h"
+
+namespace Cylink
+{
+    /**
+     Create the fallback topology: one node, no pinning.
+    */
+    Topology::Topology()
+        : nodes_(1)
+    {
+    }
+
+    /**
+     Read the machine's nodes from /sys, keeping only the CPUs this process may run on.
+     @return
+        The topology, or the fallback if /sys has no node information or none of its CPUs are usable.
+    */
+    Topology Topology::discover()
+    {
+        Topology topology = load(TP_SYSFS_NODES);
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+            return Topology();
+
+        std::vector<NumaNode> usable;
+        for(auto& node : topology.nodes_)
+        {
+            NumaNode local = {node.id, {}};
+            for(int cpu : node.cpus)
+            {
+                if(cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))
+                    local.cpus.push_back(cpu);
+            }
+            if(!local.cpus.empty())
+                usable.push_back(local);
+        }
+        if(usable.empty())
+            return Topology();
+        topology.nodes_ = usable;
+        return topology;
+    }
+
+    /**
+     Read the nodes described under a sysfs style directory: a nodeN directory per node holding a cpulist file.
+     @param root
+        The directory, normally TP_SYSFS_NODES.
+     @return
+        The nodes in id order, or the fallback if there are none with CPUs.
+    */
+    Topology Topology::load(const std::string& root)
+    {
+        Topology topology;
+        topology.nodes_.clear();
+        DIR* dir = opendir(root.c_str());
+        if(dir)
+        {
+            while(dirent* entry = readdir(dir))
+            {
+                std::string name = entry->d_name;
+                if(name.size() <= 4 || name.compare(0, 4, "node") != 0
+                    || !std::all_of(name.begin() + 4, name.end(), [](unsigned char c) { return std::isdigit(c); }))
+                    continue;
+                std::ifstream file(root + "/" + name + "/cpulist");
+                std::string list;
+                if(!std::getline(file, list))
+                    continue;
+                NumaNode node = {std::atoi(name.c_str() + 4), parseCpuList(list)};
+                if(!node.cpus.empty())
+                    topology.nodes_.push_back(node);
+            }
+            closedir(dir);
+        }
+        if(topology.nodes_.empty())
+            return Topology();
+        std::sort(topology.nodes_.begin(), topology.nodes_.end(), [](const NumaNode& left, const NumaNode& right)
+        {
+            return left.id < right.id;
+        });
+        return topology;
+    }
+
+    /**
+     Parse a kernel CPU list such as "0-3,8,10-11".
+     @return
+        The CPUs in the list, empty if it is malformed.
+    */
+    std::vector<int> Topology::parseCpuList(const std::string& list)
+    {
+        std::vector<int> cpus;
+        size_t pos = 0;
+        while(pos < list.size() && !std::isspace(static_cast<unsigned char>(list[pos])))
+        {
+            char* end = nullptr;
+            long first = std::strtol(list.c_str() + pos, &end, 10);
+            if(end == list.c_str() + pos || first < 0)
+                return {};
+            long last = first;
+            pos = end - list.c_str();
+            if(pos < list.size() && list[pos] == '-')
+            {
+                last = std::strtol(list.c_str() + pos + 1, &end, 10);
+                if(end == list.c_str() + pos + 1 || last < first)
+                    return {};
+                pos = end - list.c_str();
+            }
+            for(long cpu = first; cpu <= last; cpu++)
+                cpus.push_back(static_cast<int>(cpu));
+            if(pos < list.size() && list[pos] == ',')
+                pos++;
+            else if(pos < list.size() && !std::isspace(static_cast<unsigned char>(list[pos])))
+                return {};
+        }
+        return cpus;
+    }
+
+    const std::vector<NumaNode>& Topology::nodes() const
+    {
+        return nodes_;
+    }
+
+    /**
+     @return
+        True if workers can be pinned, ie. the nodes' CPUs are known.
+    */
+    bool Topology::pinnable() const
+    {
+        return !nodes_.front().cpus.empty();
+    }
+
+    /**
+     @return
+        The index within nodes() of the node a worker runs on.
+    */
+    int Topology::nodeOfWorker(int worker) const
+    {
+        return worker % static_cast<int>(nodes_.size());
+    }
+
+    /**
+     @return
+        The CPU a worker is pinned to, or -1 without pinning. Workers of a node take its CPUs in turn.
+    */
+    int Topology::cpuOfWorker(int worker) const
+    {
+        const NumaNode& node = nodes_[nodeOfWorker(worker)];
+        if(node.cpus.empty())
+            return -1;
+        return node.cpus[(worker / nodes_.size()) % node.cpus.size()];
+    }
+
+    /**
+     Pin the calling thread to the worker's CPU. Call it on the worker's thread before it allocates anything.
+     @return
+        False if there is no CPU to pin to or the system refused.
+    */
+    bool Topology::pinWorker(int worker) const
+    {
+        int cpu = cpuOfWorker(worker);
+        if(cpu < 0 || cpu >= CPU_SETSIZE)
+            return false;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <string>
+#include <vector>
+
+#define TP_SYSFS_NODES "/sys/devices/system/node"
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     @struct NumaNode
+     A memory node and the CPUs attached to it.
+    */
+    struct NumaNode
+    {
+        int id = 0;
+        std::vector<int> cpus;
+    };
+
+    /**
+     The NUMA nodes workers are spread over. Workers are dealt to nodes in turn, so a run of a few threads
+     still uses every node, and each is pinned to one CPU of its node. A worker pinned before it allocates
+     gets its memory from the local node, as Linux places a page on the node of the thread first touching it.
+     A default constructed topology has a single node without CPUs and pins nothing.
+    */
+    class Topology
+    {
+    public:
+        Topology();
+
+        static Topology discover();
+        static Topology load(const std::string& root);
+        static std::vector<int> parseCpuList(const std::string& list);
+
+        const std::vector<NumaNode>& nodes() const;
+        bool pinnable() const;
+        int nodeOfWorker(int worker) const;
+        int cpuOfWorker(int worker) const;
+        bool pinWorker(int worker) const;
+
+    private:
+        std::vector<NumaNode> nodes_;
+    };
+}
+
+#endif
@@ -0,0 +1,95 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "simulation.h"
+#include "topology.h"
+
+TEST_CASE ("Testing Topology", "[Topology]")
+{
+    SECTION("CPU lists parse like the kernel writes them")
+    {
+        std::cout<<"Testing cpu lists"<<std::endl;
+        CHECK(Cylink::Topology::parseCpuList("0") == std::vector<int>{0});
+        CHECK(Cylink::Topology::parseCpuList("0-3,8,10-11\n") == std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+        CHECK(Cylink::Topology::parseCpuList("").empty());
+        CHECK(Cylink::Topology::parseCpuList("3-1").empty());
+        CHECK(Cylink::Topology::parseCpuList("0;1").empty());
+    }
+
+    SECTION("Nodes are read from sysfs and workers dealt to them in turn")
+    {
+        std::cout<<"Testing node discovery"<<std::endl;
+        std::string root = "topology_test_nodes";
+        mkdir(root.c_str(), 0755);
+        mkdir((root + "/node0").c_str(), 0755);
+        mkdir((root + "/node1").c_str(), 0755);
+        mkdir((root + "/possible").c_str(), 0755);
+        std::ofstream(root + "/node1/cpulist")<<"4-5\n";
+        std::ofstream(root + "/node0/cpulist")<<"0-1\n";
+
+        Cylink::Topology topology = Cylink::Topology::load(root);
+        REQUIRE(topology.nodes().size() == 2);
+        CHECK(topology.nodes()[0].id == 0);
+        CHECK(topology.nodes()[1].cpus == std::vector<int>{4, 5});
+        CHECK(topology.pinnable());
+        CHECK(topology.nodeOfWorker(0) == 0);
+        CHECK(topology.nodeOfWorker(3) == 1);
+        CHECK(topology.cpuOfWorker(0) == 0);
+        CHECK(topology.cpuOfWorker(1) == 4);
+        CHECK(topology.cpuOfWorker(3) == 5);
+        CHECK(topology.cpuOfWorker(4) == 0);
+
+        unlink((root + "/node0/cpulist").c_str());
+        unlink((root + "/node1/cpulist").c_str());
+        rmdir((root + "/node0").c_str());
+        rmdir((root + "/node1").c_str());
+        rmdir((root + "/possible").c_str());
+        rmdir(root.c_str());
+
+        /* Without node information there is one node and nothing is pinned */
+        Cylink::Topology fallback = Cylink::Topology::load(root);
+        REQUIRE(fallback.nodes().size() == 1);
+        CHECK_FALSE(fallback.pinnable());
+        CHECK(fallback.cpuOfWorker(2) == -1);
+        CHECK_FALSE(fallback.pinWorker(2));
+        CHECK_FALSE(Cylink::Topology::discover().nodes().empty());
+    }
+
+    SECTION("Pinned runs play the same games and count them per node")
+    {
+        std::cout<<"Testing pinned runs"<<std::endl;
+        Cylink::SimulationConfig config;
+        config.games = 40;
+        config.threads = 3;
+        std::ostringstream plain;
+        Cylink::runSimulation(config, plain);
+
+        config.numa = true;
+        std::ostringstream pinned;
+        Cylink::SimulationSummary summary = Cylink::runSimulation(config, pinned);
+        long long games = 0;
+        int threads = 0;
+        for(auto& node : summary.nodes)
+        {
+            games += node.games;
+            threads += node.threads;
+        }
+        CHECK(games == 40);
+        CHECK(threads == 3);
+
+        /* Threads finish games out of order, so compare the sorted lines */
+        std::string first = plain.str(), second = pinned.str();
+        std::vector<std::string> expected, lines;
+        std::istringstream one(first), two(second);
+        for(std::string line; std::getline(one, line); )
+            expected.push_back(line);
+        for(std::string line; std::getline(two, line); )
+            lines.push_back(line);
+        std::sort(expected.begin(), expected.end());
+        std::sort(lines.begin(), lines.end());
+        CHECK(lines == expected);
+    }
+}
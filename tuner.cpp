@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "tuner.h"
+#include "error.h"
+
+#define TU_ARG_ERROR ErrorCode::ERR_INVALID_ARG
+#define TU_IO_ERROR ErrorCode::ERR_IO
+#define TU_HEADER "# highseas tuner checkpoint"
+#define TU_GENERATION_STRIDE (1LL << 32)
+
+namespace Cylink
+{
+    /**
+     Set up a tuning run, resuming from the checkpoint file if it exists.
+     Invalid settings, a strategy without parameters or a checkpoint of another strategy result in an exception.
+    */
+    Tuner::Tuner(const TunerConfig& config)
+        : config_(config), games_(), parameters_(), state_(), pool_(config.threads), runners_()
+    {
+        if(config_.population <= 0 || config_.keep <= 0 || config_.keep > config_.population || config_.roundGames <= 0)
+        {
+            Error argError("Invalid tuner settings.", TU_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        if(config_.fleet.empty())
+            config_.fleet = defaultFleet();
+
+        parameters_ = Strategy::create(config_.strategy, config_.length, config_.width)->parameters();
+        if(parameters_.empty())
+        {
+            Error argError("The " + config_.strategy + " strategy has no parameters to tune.", TU_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+
+        games_.length = config_.length;
+        games_.width = config_.width;
+        games_.fleet = config_.fleet;
+        games_.seed = config_.seed;
+        games_.strategy[0] = config_.strategy;
+        games_.strategy[1] = config_.opponent.empty() ? config_.strategy : config_.opponent;
+
+        state_.engine.seed(config_.seed);
+        for(auto& parameter : parameters_)
+        {
+            state_.mean.push_back(parameter.value);
+            state_.sigma.push_back((parameter.high - parameter.low) / 4);
+        }
+        state_.best = state_.mean;
+
+        std::ifstream saved(config_.checkpoint);
+        if(!config_.checkpoint.empty() && saved)
+        {
+            state_ = loadState(saved);
+            if(state_.mean.size() != parameters_.size())
+            {
+                Error argError("The checkpoint " + config_.checkpoint + " is for another strategy.", TU_ARG_ERROR, __FILE__, __LINE__);
+                throw argError;
+            }
+        }
+
+        for(int idx = 0; idx < pool_.threads(); idx++)
+            runners_.push_back(std::make_unique<GameRunner>(games_));
+    }
+
+    Tuner::~Tuner()
+    {
+    }
+
+    /**
+     Run generations until config.generations are complete, saving a checkpoint after each.
+     @param log
+        If not null, progress is written to it after every halving round.
+     @return
+        The final state.
+    */
+    const TunerState& Tuner::run(std::ostream* log)
+    {
+        while(state_.generation < config_.generations)
+            runGeneration(log);
+        return state_;
+    }
+
+    const TunerState& Tuner::state() const
+    {
+        return state_;
+    }
+
+    /**
+     @return
+        The tuned strategy's parameters with their default values.
+    */
+    const std::vector<StrategyParameter>& Tuner::parameters() const
+    {
+        return parameters_;
+    }
+
+    /**
+     Sample a generation around the centre, always including the centre itself, and halve it down to
+     config.keep survivors. Each round's games are new but shared by every candidate in the round.
+    */
+    void Tuner::runGeneration(std::ostream* log)
+    {
+        std::vector<Candidate> pool(config_.population);
+        for(size_t idx = 0; idx < pool.size(); idx++)
+        {
+            pool[idx].values = state_.mean;
+            for(size_t param = 0; idx > 0 && param < parameters_.size(); param++)
+            {
+                double value = state_.mean[param] + state_.sigma[param] * state_.engine.normal();
+                pool[idx].values[param] = std::clamp(value, parameters_[param].low, parameters_[param].high);
+            }
+        }
+
+        auto winRate = [](const Candidate& candidate)
+        {
+            return candidate.games ? static_cast<double>(candidate.points) / (2 * candidate.games) : 0.0;
+        };
+
+        std::vector<size_t> alive(pool.size());
+        for(size_t idx = 0; idx < alive.size(); idx++)
+            alive[idx] = idx;
+
+        for(int round = 0; ; round++)
+        {
+            evaluate(pool, alive, state_.generation * TU_GENERATION_STRIDE + static_cast<long long>(round) * config_.roundGames);
+            std::stable_sort(alive.begin(), alive.end(), [&](size_t left, size_t right)
+            {
+                return winRate(pool[left]) > winRate(pool[right]);
+            });
+            if(log)
+            {
+                *log<<"generation "<<state_.generation + 1<<" round "<<round + 1<<": "<<alive.size()<<" candidates, best "
+                    <<winRate(pool[alive.front()])<<" worst "<<winRate(pool[alive.back()])<<" over "
+                    <<pool[alive.front()].games<<" games\n";
+            }
+            if(alive.size() <= static_cast<size_t>(config_.keep))
+                break;
+            alive.resize(std::max<size_t>(config_.keep, (alive.size() + 1) / 2));
+        }
+
+        for(size_t param = 0; param < parameters_.size(); param++)
+        {
+            double sum = 0.0;
+            for(size_t idx : alive)
+                sum += pool[idx].values[param];
+            state_.mean[param] = sum / alive.size();
+            state_.sigma[param] *= TU_SIGMA_DECAY;
+        }
+        state_.best = pool[alive.front()].values;
+        state_.bestScore = winRate(pool[alive.front()]);
+        state_.generation++;
+        checkpoint();
+    }
+
+    /**
+     Play config.roundGames games for every listed candidate on the pool. Each task plays a chunk of one
+     candidate's games on its thread's runner, with the candidate's parameters set on player 1.
+     A win scores two points and a draw one.
+    */
+    void Tuner::evaluate(std::vector<Candidate>& pool, const std::vector<size_t>& alive, long long firstGame)
+    {
+        size_t chunks = (config_.roundGames + TU_CHUNK_GAMES - 1) / TU_CHUNK_GAMES;
+        std::vector<long long> points(alive.size() * chunks, 0);
+        pool_.run(points.size(), [&](size_t task, int worker)
+        {
+            const Candidate& candidate = pool[alive[task / chunks]];
+            long long begin = static_cast<long long>(task % chunks) * TU_CHUNK_GAMES;
+            long long end = std::min<long long>(begin + TU_CHUNK_GAMES, config_.roundGames);
+
+            std::unique_ptr<Strategy> strategy = Strategy::create(config_.strategy, config_.length, config_.width);
+            strategy->setFleet(config_.fleet);
+            strategy->setParameters(candidate.values);
+            GameRunner& runner = *runners_[worker];
+            runner.setStrategy(0, std::move(strategy));
+            /* Tally locally, neighbouring tasks' totals share cache lines */
+            long long earned = 0;
+            for(long long game = begin; game < end; game++)
+            {
+                int winner = runner.play(firstGame + game).winner;
+                earned += (winner == SIM_PLAYER1) ? 2 : (winner == SIM_DRAW) ? 1 : 0;
+            }
+            points[task] = earned;
+        });
+
+        for(size_t idx = 0; idx < alive.size(); idx++)
+        {
+            Candidate& candidate = pool[alive[idx]];
+            for(size_t chunk = 0; chunk < chunks; chunk++)
+                candidate.points += points[idx * chunks + chunk];
+            candidate.games += config_.roundGames;
+        }
+    }
+
+    /**
+     Save the state to the checkpoint file, if there is one. The state is written to a temporary file that then
+     replaces the checkpoint, so an interrupted run always leaves a complete checkpoint behind.
+    */
+    void Tuner::checkpoint() const
+    {
+        if(config_.checkpoint.empty())
+            return;
+        std::string temporary = config_.checkpoint + ".tmp";
+        {
+            std::ofstream file(temporary);
+            saveState(file, state_);
+            file.flush();
+            if(!file)
+            {
+                Error ioError("Unable to write checkpoint " + temporary + ".", TU_IO_ERROR, __FILE__, __LINE__);
+                throw ioError;
+            }
+        }
+        if(std::rename(temporary.c_str(), config_.checkpoint.c_str()) != 0)
+        {
+            Error ioError("Unable to replace checkpoint " + config_.checkpoint + ".", TU_IO_ERROR, __FILE__, __LINE__);
+            throw ioError;
+        }
+    }
+
+    /**
+     Write a tuner state as text, one "key values..." line per field, with enough digits to restore it exactly.
+    */
+    void Tuner::saveState(std::ostream& os, const TunerState& state)
+    {
+        auto writeValues = [&os](const char* key, const std::vector<double>& values)
+        {
+            os<<key;
+            for(double value : values)
+                os<<" "<<value;
+            os<<"\n";
+        };
+
+        std::streamsize precision = os.precision(std::numeric_limits<double>::max_digits10);
+        os<<TU_HEADER<<"\n"<<"generation "<<state.generation<<"\n";
+        writeValues("mean", state.mean);
+        writeValues("sigma", state.sigma);
+        writeValues("best", state.best);
+        uint64_t words[4];
+        state.engine.getState(words);
+        os<<"score "<<state.bestScore<<"\n"<<"engine "<<words[0]<<" "<<words[1]<<" "<<words[2]<<" "<<words[3]<<"\n";
+        os.precision(precision);
+    }
+
+    /**
+     Read a tuner state written by saveState(). Unknown keys or malformed values result in an exception.
+    */
+    TunerState Tuner::loadState(std::istream& is)
+    {
+        TunerState state;
+        std::string line;
+        bool valid = true, engine = false;
+        while(valid && std::getline(is, line))
+        {
+            if(line.empty() || line[0] == '#')
+                continue;
+            std::istringstream entry(line);
+            std::string key;
+            entry>>key;
+            if(key == "generation")
+                valid = static_cast<bool>(entry>>state.generation) && state.generation >= 0;
+            else if(key == "score")
+                valid = static_cast<bool>(entry>>state.bestScore);
+            else if(key == "engine")
+            {
+                uint64_t words[4];
+                valid = engine = entry>>words[0]>>words[1]>>words[2]>>words[3] && state.engine.setState(words);
+            }
+            else if(key == "mean" || key == "sigma" || key == "best")
+            {
+                std::vector<double>& values = (key == "mean") ? state.mean : (key == "sigma") ? state.sigma : state.best;
+                for(double value; entry>>value; )
+                    values.push_back(value);
+                valid = entry.eof();
+            }
+            else
+                valid = false;
+        }
+
+        if(!valid || !engine || state.mean.empty() || state.sigma.size() != state.mean.size() || state.best.size() != state.mean.size())
+        {
+            Error argError("Invalid tuner checkpoint.", TU_ARG_ERROR, __FILE__, __LINE__);
+            throw argError;
+        }
+        return state;
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef TUNER_H
+#define TUNER_H
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "random.h"
+#include "scheduler.h"
+#include "simulation.h"
+
+#define TU_GENERATIONS 10
+#define TU_POPULATION 16
+#define TU_ROUND_GAMES 64
+#define TU_KEEP 4
+#define TU_CHUNK_GAMES 16
+#define TU_SIGMA_DECAY 0.8
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     @struct TunerConfig
+     Settings for a self-play tuning run. Declaration shows default field values.
+    */
+    struct TunerConfig
+    {
+        std::string strategy = "parity";    /**< The strategy whose parameters are tuned */
+        std::string opponent;               /**< Opponent strategy with default parameters, the tuned one if empty */
+        int length = GB_BOARD_SIZE;
+        int width = GB_BOARD_SIZE;
+        std::vector<Vessel::VType> fleet;   /**< The standard fleet if empty */
+        int generations = TU_GENERATIONS;
+        int population = TU_POPULATION;     /**< Candidates sampled per generation */
+        int roundGames = TU_ROUND_GAMES;    /**< Games each surviving candidate plays per halving round */
+        int keep = TU_KEEP;                 /**< Candidates surviving a generation, their mean is the next centre */
+        int threads = 1;
+        uint64_t seed = 0;
+        std::string checkpoint;             /**< File the state is saved to after every generation, none if empty */
+    };
+
+    /**
+     @struct TunerState
+     Everything a tuning run needs to continue, as saved in a checkpoint.
+    */
+    struct TunerState
+    {
+        int generation = 0;                 /**< Generations completed */
+        std::vector<double> mean;           /**< Centre candidates are sampled around */
+        std::vector<double> sigma;          /**< Sampling step per parameter */
+        std::vector<double> best;           /**< Best candidate of the last generation */
+        double bestScore = 0.0;             /**< Its win rate against the opponent */
+        Xoshiro256 engine;                  /**< Samples candidates, continued across generations */
+    };
+
+    /**
+     Tunes a strategy's parameters by self-play. Every generation samples candidates around the current centre,
+     scores them by their win rate against the opponent with successive halving, and moves the centre to the mean
+     of the survivors while the sampling step shrinks. Every candidate of a round plays the same games, derived
+     from (seed, generation, game), so candidates are compared on equal terms and results don't depend on the
+     thread count. The thread pool and each thread's game runner are kept for the whole run.
+    */
+    class Tuner
+    {
+    public:
+        Tuner(const TunerConfig& config);
+        Tuner(const Tuner& other) = delete;
+        Tuner& operator =(const Tuner& other) = delete;
+        ~Tuner();
+
+        const TunerState& run(std::ostream* log = nullptr);
+        const TunerState& state() const;
+        const std::vector<StrategyParameter>& parameters() const;
+
+        static void saveState(std::ostream& os, const TunerState& state);
+        static TunerState loadState(std::istream& is);
+
+    private:
+        /**
+         @struct Candidate
+         A parameter vector under evaluation and its results so far.
+        */
+        struct Candidate
+        {
+            std::vector<double> values;
+            long long points = 0;           /**< Two per win and one per draw */
+            long long games = 0;
+        };
+
+        void runGeneration(std::ostream* log);
+        void evaluate(std::vector<Candidate>& pool, const std::vector<size_t>& alive, long long firstGame);
+        void checkpoint() const;
+
+    private:
+        TunerConfig config_;
+        SimulationConfig games_;                            /**< The self-play game settings */
+        std::vector<StrategyParameter> parameters_;         /**< Names, defaults and ranges */
+        TunerState state_;
+        ThreadPool pool_;
+        std::vector<std::unique_ptr<GameRunner>> runners_;  /**< One per pool thread */
+    };
+}
+
+#endif
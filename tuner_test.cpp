@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include "error.h"
+#include "tuner.h"
+
+TEST_CASE ("Testing Tuner", "[Tuner]")
+{
+    SECTION("Thread pools run every task of every batch")
+    {
+        std::cout<<"Testing thread pools"<<std::endl;
+        Cylink::ThreadPool pool(3);
+        CHECK(pool.threads() == 3);
+
+        for(int batch = 1; batch <= 20; batch++)
+        {
+            std::vector<int> ran(batch * 7, 0);
+            std::atomic<int> badWorker(0);
+            pool.run(ran.size(), [&](size_t task, int worker)
+            {
+                ran[task]++;
+                if(worker < 0 || worker >= 3)
+                    badWorker++;
+            });
+            CHECK(std::count(ran.begin(), ran.end(), 1) == static_cast<long>(ran.size()));
+            CHECK(badWorker == 0);
+        }
+
+        CHECK_THROWS_AS(pool.run(50, [](size_t task, int worker)
+        {
+            if(task == 10)
+                throw std::runtime_error("task failed");
+        }), std::runtime_error);
+
+        /* The pool is still usable after a failed batch */
+        std::atomic<int> count(0);
+        pool.run(5, [&](size_t task, int worker) { count++; });
+        CHECK(count == 5);
+    }
+
+    SECTION("Checkpoints restore the state exactly")
+    {
+        std::cout<<"Testing tuner checkpoints"<<std::endl;
+        Cylink::TunerState state;
+        state.generation = 3;
+        state.mean = {1.0 / 3, 0.25, 0.7};
+        state.sigma = {0.1, 0.2, 1e-7};
+        state.best = {0.9, 0.0, 1.0};
+        state.bestScore = 0.615;
+        state.engine.seed(99);
+        state.engine();
+
+        std::stringstream file;
+        Cylink::Tuner::saveState(file, state);
+        Cylink::TunerState loaded = Cylink::Tuner::loadState(file);
+        CHECK(loaded.generation == 3);
+        CHECK(loaded.mean == state.mean);
+        CHECK(loaded.sigma == state.sigma);
+        CHECK(loaded.best == state.best);
+        CHECK(loaded.bestScore == state.bestScore);
+        CHECK(loaded.engine == state.engine);
+
+        std::istringstream broken("generation 1\nmean 1 2\nsigma 1\n");
+        CHECK_THROWS_AS(Cylink::Tuner::loadState(broken), Cylink::Error);
+    }
+
+    SECTION("Tuning is reproducible and resumes from a checkpoint")
+    {
+        std::cout<<"Testing self-play tuning"<<std::endl;
+        Cylink::TunerConfig config;
+        config.generations = 2;
+        config.population = 4;
+        config.roundGames = 20;
+        config.keep = 2;
+        config.seed = 8;
+
+        config.threads = 1;
+        Cylink::Tuner single(config);
+        Cylink::TunerState expected = single.run();
+        CHECK(expected.generation == 2);
+        CHECK(expected.best.size() == single.parameters().size());
+
+        config.threads = 3;
+        Cylink::Tuner threaded(config);
+        const Cylink::TunerState& state = threaded.run();
+        CHECK(state.best == expected.best);
+        CHECK(state.mean == expected.mean);
+
+        /* Stop after one generation, then resume */
+        config.checkpoint = "tuner_test_checkpoint.txt";
+        std::remove(config.checkpoint.c_str());
+        config.generations = 1;
+        Cylink::Tuner(config).run();
+        config.generations = 2;
+        Cylink::Tuner resumed(config);
+        CHECK(resumed.state().generation == 1);
+        const Cylink::TunerState& finished = resumed.run();
+        CHECK(finished.best == expected.best);
+        CHECK(finished.mean == expected.mean);
+        std::remove(config.checkpoint.c_str());
+
+        config.strategy = "scan";
+        CHECK_THROWS_AS(Cylink::Tuner(config), Cylink::Error);
+    }
+}
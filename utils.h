@@ -1,8 +1,11 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <cstring>
 #include <iostream>
 #include <iomanip>
+#include <iterator>
+#include <string_view>
 #include <vector>
 
 /**
@@ -13,6 +16,121 @@ namespace Cylink::StringUtils
 {
     std::vector<std::string> tokenize(const std::string& input, char delim = ' ');
 
+    /**
+     Splits a string into tokens lazily without copying or allocating. Tokens are views into the input, which must
+     outlive the tokenizer. Delimiters are found with memchr(), which the C library vectorizes for long inputs.
+     Tokens follow std::getline(): "a,,b" gives "a", "" and "b" and a delimiter at the very end doesn't start
+     another token. Empty tokens can be skipped instead, which splits on runs of delimiters.
+    */
+    class Tokenizer
+    {
+    public:
+        /**
+         Input iterator over the tokens, so a Tokenizer works in a range based for loop.
+        */
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::string_view*;
+            using reference = const std::string_view&;
+
+            iterator(Tokenizer* tokenizer = nullptr) : tokenizer_(tokenizer), token_()
+            {
+                ++(*this);
+            }
+            reference operator*() const { return token_; }
+            pointer operator->() const { return &token_; }
+            iterator& operator++()
+            {
+                if(tokenizer_ && !tokenizer_->next(token_))
+                    tokenizer_ = nullptr;
+                return *this;
+            }
+            bool operator==(const iterator& other) const { return tokenizer_ == other.tokenizer_; }
+            bool operator!=(const iterator& other) const { return tokenizer_ != other.tokenizer_; }
+
+        private:
+            Tokenizer* tokenizer_;      /**< Null once the tokens run out */
+            std::string_view token_;
+        };
+
+    public:
+        Tokenizer(std::string_view input, char delim = ' ', bool skipEmpty = false);
+
+        bool next(std::string_view& token);
+        void reset(std::string_view input);
+        iterator begin();
+        iterator end();
+
+    private:
+        std::string_view input_;
+        size_t position_;           /**< Start of the next token */
+        char delim_;
+        bool skipEmpty_;
+    };
+
+    /**
+     Create a tokenizer for the input.
+     @param delim
+        The character separating tokens.
+     @param skipEmpty
+        Set to true to skip empty tokens, ie. treat a run of delimiters as one.
+    */
+    inline Tokenizer::Tokenizer(std::string_view input, char delim, bool skipEmpty)
+        : input_(input), position_(0), delim_(delim), skipEmpty_(skipEmpty)
+    {
+    }
+
+    /**
+     Obtain the next token.
+     @param token
+        Receives the token, a view into the input.
+     @return
+        False if there are no tokens left.
+    */
+    inline bool Tokenizer::next(std::string_view& token)
+    {
+        while(position_ < input_.size())
+        {
+            const char* start = input_.data() + position_;
+            const char* found = static_cast<const char*>(std::memchr(start, delim_, input_.size() - position_));
+            size_t length = found ? static_cast<size_t>(found - start) : input_.size() - position_;
+
+            position_ += length + 1;
+            if(length > 0 || !skipEmpty_)
+            {
+                token = std::string_view(start, length);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     Start over on a new input, keeping the delimiter settings.
+    */
+    inline void Tokenizer::reset(std::string_view input)
+    {
+        input_ = input;
+        position_ = 0;
+    }
+
+    /**
+     Iterate over the remaining tokens. Iterating consumes them.
+    */
+    inline Tokenizer::iterator Tokenizer::begin()
+    {
+        return iterator(this);
+    }
+
+    inline Tokenizer::iterator Tokenizer::end()
+    {
+        return iterator();
+    }
+
     /* Code below allows centering data when outputing to an ostream */
     template <typename charT, typename traits = std::char_traits<charT>>
     class center_helper
@@ -0,0 +1,60 @@
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+#include "utils.h"
+
+/**
+ The getline based splitting tokenize() used before Tokenizer, as the reference behaviour.
+*/
+static std::vector<std::string> getlineTokens(const std::string& input, char delim)
+{
+    std::vector<std::string> result;
+    std::string token;
+    std::stringstream tokenizer(input);
+    while(!input.empty() && getline(tokenizer, token, delim))
+        result.push_back(token);
+    return result;
+}
+
+TEST_CASE ("Testing StringUtils", "[StringUtils]")
+{
+    SECTION("Tokens match getline splitting")
+    {
+        std::cout<<"Testing tokenizer against getline"<<std::endl;
+        for(std::string input : {"", ",", ",,", "a", "a,", ",a", "a,,b", "abc,de,,f,", "  spaced  , out "})
+        {
+            CHECK(Cylink::StringUtils::tokenize(input, ',') == getlineTokens(input, ','));
+
+            std::vector<std::string> lazy;
+            for(std::string_view token : Cylink::StringUtils::Tokenizer(input, ','))
+                lazy.emplace_back(token);
+            CHECK(lazy == getlineTokens(input, ','));
+        }
+    }
+
+    SECTION("Skipping empty tokens and long lines")
+    {
+        std::cout<<"Testing tokenizer options"<<std::endl;
+        Cylink::StringUtils::Tokenizer tokenizer("  Carrier   2 ", ' ', true);
+        std::string_view token;
+        REQUIRE(tokenizer.next(token));
+        CHECK(token == "Carrier");
+        REQUIRE(tokenizer.next(token));
+        CHECK(token == "2");
+        CHECK_FALSE(tokenizer.next(token));
+
+        std::string line;
+        for(int idx = 0; idx < 10000; idx++)
+            line += std::to_string(idx) + "\t";
+        tokenizer = Cylink::StringUtils::Tokenizer(line, '\t');
+        int count = 0;
+        bool ordered = true;
+        while(tokenizer.next(token))
+            ordered = ordered && (token == std::to_string(count++));
+        CHECK(count == 10000);
+        CHECK(ordered);
+
+        tokenizer.reset("x\ty");
+        CHECK(tokenizer.next(token));
+        CHECK(token == "x");
+    }
+}
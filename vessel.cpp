@@ -107,6 +107,22 @@ namespace Cylink
         return damageLevel_;
     }
 
+    /**
+     Reverse the damage of a previous takeHit() call, used when a strike is undone.
+     @param shot
+        The strength of the shot being reversed.
+     @return
+        The restored damage value, never more than the initial damage level.
+    */
+    int Vessel::repairHit(int shot)
+    {
+        damageLevel_ += shot;
+        if(damageLevel_ > getDamageLevel(true))
+            damageLevel_ = getDamageLevel(true);
+
+        return damageLevel_;
+    }
+
     /**
      Obtain the amount of damage the vessel can take before sinking. 
      The damage level is based on the type of vessel and set when the vessel is initially constructed.
@@ -37,6 +37,7 @@ namespace Cylink
         Vessel& operator =(const Vessel& other);
 
         int takeHit(int shot);
+        int repairHit(int shot);
 
         //Constant functions
         int getLength() const;
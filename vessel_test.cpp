@@ -4,7 +4,7 @@
 TEST_CASE ("Testing Vessels", "[Vessel]")
 {
     Cylink::Vessel default_vessel;                              //Default constructed vessel.
-    Cylink::Vessel con_vessel(Cylink::VesselType::CARRIER);     //Constructed vessel
+    Cylink::Vessel con_vessel(Cylink::Vessel::VType::CARRIER);     //Constructed vessel
     Cylink::Vessel copy_con_vessel(default_vessel);             //Copy constructed vessel
 
     SECTION("Vessel Initialization")
@@ -12,37 +12,37 @@ TEST_CASE ("Testing Vessels", "[Vessel]")
         std::cout<<"Testing vessel initialization"<<std::endl;
 
         /* Constructed vessels should match their expected types */
-        REQUIRE(default_vessel.getType() == Cylink::VesselType::GUNBOAT);
-        REQUIRE(con_vessel.getType() == Cylink::VesselType::CARRIER);
-        REQUIRE(copy_con_vessel.getType() == Cylink::VesselType::GUNBOAT);
+        REQUIRE(default_vessel.getType() == Cylink::Vessel::VType::GUNBOAT);
+        REQUIRE(con_vessel.getType() == Cylink::Vessel::VType::CARRIER);
+        REQUIRE(copy_con_vessel.getType() == Cylink::Vessel::VType::GUNBOAT);
 
-        Cylink::Vessel v1(Cylink::VesselType::FRIGATE);
-        REQUIRE(v1.getType() == Cylink::VesselType::FRIGATE);
+        Cylink::Vessel v1(Cylink::Vessel::VType::FRIGATE);
+        REQUIRE(v1.getType() == Cylink::Vessel::VType::FRIGATE);
 
         /* Verify assignment operator changes vessel type */
         copy_con_vessel = v1;
-        REQUIRE(copy_con_vessel.getType() == Cylink::VesselType::FRIGATE);
+        REQUIRE(copy_con_vessel.getType() == Cylink::Vessel::VType::FRIGATE);
     }
 
     SECTION("Testing Print Format")
     {
         /* Verify short formats -- This is done mostly so if it changes in code we catch it */
         std::cout<<"Testing vessel's short print formats"<<std::endl;
-        REQUIRE(Cylink::Vessel::formatVessel(Cylink::VesselType::CARRIER) == "CA");
-        REQUIRE(Cylink::Vessel::formatVessel(Cylink::VesselType::CRUISER) == "CR");
-        REQUIRE(Cylink::Vessel::formatVessel(Cylink::VesselType::DESTROYER) == "DE");
-        REQUIRE(Cylink::Vessel::formatVessel(Cylink::VesselType::FRIGATE) == "FR");
-        REQUIRE(Cylink::Vessel::formatVessel(Cylink::VesselType::GUNBOAT) == "GB");
-        REQUIRE(Cylink::Vessel::formatVessel(Cylink::VesselType::SUBMARINE) == "SM");
+        REQUIRE(Cylink::Vessel::formatVessel(Cylink::Vessel::VType::CARRIER) == "CA");
+        REQUIRE(Cylink::Vessel::formatVessel(Cylink::Vessel::VType::CRUISER) == "CR");
+        REQUIRE(Cylink::Vessel::formatVessel(Cylink::Vessel::VType::DESTROYER) == "DE");
+        REQUIRE(Cylink::Vessel::formatVessel(Cylink::Vessel::VType::FRIGATE) == "FR");
+        REQUIRE(Cylink::Vessel::formatVessel(Cylink::Vessel::VType::GUNBOAT) == "GB");
+        REQUIRE(Cylink::Vessel::formatVessel(Cylink::Vessel::VType::SUBMARINE) == "SM");
 
         /* Verify long formats -- This is done mostly so if it changes in code we catch it */
         std::cout<<"Testing vessel's long print formats"<<std::endl;
-        REQUIRE(Cylink::Vessel::formatVessel(Cylink::VesselType::CARRIER, true) == "Carrier");
-        REQUIRE(Cylink::Vessel::formatVessel(Cylink::VesselType::CRUISER, true) == "Cruiser");
-        REQUIRE(Cylink::Vessel::formatVessel(Cylink::VesselType::DESTROYER, true) == "Destroyer");
-        REQUIRE(Cylink::Vessel::formatVessel(Cylink::VesselType::FRIGATE, true) == "Frigate");
-        REQUIRE(Cylink::Vessel::formatVessel(Cylink::VesselType::GUNBOAT, true) == "Gunboat");
-        REQUIRE(Cylink::Vessel::formatVessel(Cylink::VesselType::SUBMARINE, true) == "Submarine");
+        REQUIRE(Cylink::Vessel::formatVessel(Cylink::Vessel::VType::CARRIER, true) == "Carrier");
+        REQUIRE(Cylink::Vessel::formatVessel(Cylink::Vessel::VType::CRUISER, true) == "Cruiser");
+        REQUIRE(Cylink::Vessel::formatVessel(Cylink::Vessel::VType::DESTROYER, true) == "Destroyer");
+        REQUIRE(Cylink::Vessel::formatVessel(Cylink::Vessel::VType::FRIGATE, true) == "Frigate");
+        REQUIRE(Cylink::Vessel::formatVessel(Cylink::Vessel::VType::GUNBOAT, true) == "Gunboat");
+        REQUIRE(Cylink::Vessel::formatVessel(Cylink::Vessel::VType::SUBMARINE, true) == "Submarine");
     }
 
     SECTION("Verifying Vessel Dimensions")
@@ -0,0 +1,79 @@
+#include <algorithm>
+
+#include "vesselindex.h"
+#include "gameboard.h"
+
+namespace Cylink
+{
+    VesselIndex::VesselIndex()
+        : rows_(), intervals_(0)
+    {
+    }
+
+    /**
+     Add a vessel's rectangular footprint to the index. The low corner is exclusive as in GameBoard::VBorder.
+     @param vesselId
+        The id returned by find() for locations inside the footprint.
+    */
+    void VesselIndex::insert(int64_t topX, int64_t topY, int64_t lowX, int64_t lowY, int vesselId)
+    {
+        for(int64_t x = topX; x < lowX; x++)
+        {
+            std::vector<Interval>& row = rows_[x];
+            auto pos = std::upper_bound(row.begin(), row.end(), topY,
+                [](int64_t y, const Interval& interval) { return y < interval.from; });
+            row.insert(pos, Interval{topY, lowY, vesselId});
+            intervals_++;
+        }
+    }
+
+    /**
+     Find the vessel covering a location.
+     @return
+        The vessel id or GB_NO_VESSEL if no vessel covers (x, y).
+    */
+    int VesselIndex::find(int64_t x, int64_t y) const
+    {
+        auto row = rows_.find(x);
+        if(row == rows_.end())
+            return GB_NO_VESSEL;
+
+        /* The candidate is the last interval starting at or before y */
+        const std::vector<Interval>& intervals = row->second;
+        auto pos = std::upper_bound(intervals.begin(), intervals.end(), y,
+            [](int64_t col, const Interval& interval) { return col < interval.from; });
+        if(pos == intervals.begin() || y >= (pos - 1)->to)
+            return GB_NO_VESSEL;
+        return (pos - 1)->vesselId;
+    }
+
+    /**
+     Remove every vessel from the index.
+    */
+    void VesselIndex::clear()
+    {
+        rows_.clear();
+        intervals_ = 0;
+    }
+
+    /**
+     @return
+        The number of row intervals stored, one per row of each vessel.
+    */
+    int64_t VesselIndex::intervals() const
+    {
+        return intervals_;
+    }
+
+    /**
+     @return
+        An estimate of the heap memory used by the index in bytes, counting a hash node as its value and two pointers.
+    */
+    int64_t VesselIndex::memoryUsage() const
+    {
+        int64_t result = rows_.bucket_count() * sizeof(void*);
+        for(const auto& row : rows_)
+            result += sizeof(row) + 2 * sizeof(void*) + row.second.capacity() * sizeof(Interval);
+        return result;
+    }
+}
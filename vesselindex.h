@@ -0,0 +1,50 @@
+#ifndef VESSELINDEX_H
+#define VESSELINDEX_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @namespace Cylink
+ * General project namespace
+ */
+namespace Cylink
+{
+    /**
+     Locates the vessel covering a board coordinate without storing a vessel id per cell.
+     Every occupied row keeps the column intervals of the vessels crossing it sorted by their first column,
+     so a lookup is a hash of the row followed by a binary search of that row's intervals.
+     Intervals must not overlap, which holds for vessels on a single board.
+    */
+    class VesselIndex
+    {
+    public:
+        VesselIndex();
+
+        void insert(int64_t topX, int64_t topY, int64_t lowX, int64_t lowY, int vesselId);
+        int find(int64_t x, int64_t y) const;
+        void clear();
+
+        int64_t intervals() const;
+        int64_t memoryUsage() const;
+
+    private:
+        /**
+         @struct Interval
+         The columns [from, to) of one row covered by a vessel.
+        */
+        struct Interval
+        {
+            int64_t from;
+            int64_t to;
+            int vesselId;
+        };
+
+    private:
+        std::unordered_map<int64_t, std::vector<Interval>> rows_;   /**< Intervals of each occupied row */
+        int64_t intervals_;
+    };
+}
+
+#endif